@@ -0,0 +1,45 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "bench_common.hpp"
+#include "MeshCache.hpp"
+#include <filesystem>
+#include <iterator>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+    // n x n grid of quads (two triangles each) as unwelded soup, the way OBJ faces come in
+    MeshCache::MeshData gridData(int n) {
+        std::vector<float> positions, normals;
+        for (int z = 0; z < n; ++z) {
+            for (int x = 0; x < n; ++x) {
+                const float fx = static_cast<float>(x), fz = static_cast<float>(z);
+                const float quad[] = {fx, 0, fz,  fx + 1, 0, fz,  fx + 1, 0, fz + 1,
+                                      fx, 0, fz,  fx + 1, 0, fz + 1,  fx, 0, fz + 1};
+                positions.insert(positions.end(), std::begin(quad), std::end(quad));
+                for (int i = 0; i < 6; ++i) normals.insert(normals.end(), {0.f, 1.f, 0.f});
+            }
+        }
+        MeshCache::MeshData data;
+        data.parts.push_back(MeshCache::weld("grid", {1.f, 1.f, 1.f}, positions, normals));
+        MeshCache::computeBounds(data);
+        return data;
+    }
+}
+
+TEST_CASE("MeshCache: weld and read", "[benchmark][assets]") {
+    // About the size of the three track frames together
+    const auto dir = fs::temp_directory_path() / "excavator_meshcache_bench";
+    fs::create_directories(dir);
+    const auto path = dir / "bench.meshbin";
+    MeshCache::write(path, gridData(150), 1u);
+
+    BENCHMARK("MeshCache::weld, 135k soup vertices") {
+        return gridData(150).parts[0].vertexCount();
+    };
+    BENCHMARK("MeshCache::read, 22k vertices / 135k indices") {
+        return MeshCache::read(path, 1u)->parts[0].indices.size();
+    };
+    fs::remove_all(dir);
+}
@@ -0,0 +1,27 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "bench_common.hpp"
+#include "CoinManager.hpp"
+#include <threepp/scenes/Scene.hpp>
+#include <algorithm>
+#include <cmath>
+
+using namespace threepp;
+
+TEST_CASE("CoinManager: checkCollection", "[benchmark][coin]") {
+    for (int count : {15, 1000, 10000, 100000}) {
+        Scene scene;
+        CoinManager manager(scene, BenchSeed);
+        // Game-like density, so the pickup radius covers a handful of coins at most
+        const float arenaRadius = std::max(30.f, std::sqrt(static_cast<float>(count)) * 3.f);
+        manager.spawnCoins(count, arenaRadius);
+
+        // Small radius probes along a fixed path: mostly misses, the usual per-frame cost
+        float t = 0.f;
+        BENCHMARK(benchName("CoinManager::checkCollection", count, "coins")) {
+            t += 0.37f;
+            const Vector3 probe(std::cos(t) * arenaRadius * 0.6f, 0.f, std::sin(t * 1.3f) * arenaRadius * 0.6f);
+            return manager.checkCollection(probe, 0.5f);
+        };
+    }
+}
@@ -0,0 +1,101 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "bench_common.hpp"
+#include "CollisionWorld.hpp"
+#include <threepp/threepp.hpp>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace threepp;
+
+namespace {
+    // Arena with `count` boulder-sized template colliders, about as dense as the prop scatter
+    float scatterColliders(int count, std::mt19937& rng) {
+        CollisionWorld::clear();
+        const auto hull = CollisionWorld::footprintHull({{-0.6f, -0.5f}, {0.6f, -0.5f}, {0.7f, 0.4f}, {0.f, 0.7f}, {-0.7f, 0.3f}});
+        const float radius = std::sqrt(static_cast<float>(count)) * 2.5f;
+        std::uniform_real_distribution<float> pos(-radius, radius);
+        std::uniform_real_distribution<float> yaw(0.f, 6.2831853f);
+        std::uniform_real_distribution<float> scale(0.5f, 1.5f);
+        for (int i = 0; i < count; ++i) {
+            CollisionWorld::addMeshColliderFromTemplate(hull, pos(rng), pos(rng), yaw(rng), scale(rng));
+        }
+        return radius;
+    }
+
+    // Excavator stand-in: five boxes where the real parts sit, under one root
+    struct Parts {
+        std::shared_ptr<Group> root = Group::create();
+        std::vector<std::shared_ptr<Mesh>> meshes;
+    };
+
+    Parts makeExcavator() {
+        Parts parts;
+        const float sizes[5][3] = {{2.2f, 0.6f, 2.6f}, {1.8f, 1.0f, 1.8f}, {0.3f, 0.3f, 2.0f}, {0.25f, 0.25f, 1.5f}, {0.8f, 0.6f, 0.6f}};
+        const float offsets[5][3] = {{0.f, 0.3f, 0.f}, {0.f, 1.1f, 0.f}, {0.f, 1.8f, 1.4f}, {0.f, 1.6f, 2.8f}, {0.f, 0.9f, 3.5f}};
+        auto material = MeshBasicMaterial::create();
+        for (int i = 0; i < 5; ++i) {
+            auto mesh = Mesh::create(BoxGeometry::create(sizes[i][0], sizes[i][1], sizes[i][2]), material);
+            mesh->position.set(offsets[i][0], offsets[i][1], offsets[i][2]);
+            parts.root->add(mesh);
+            parts.meshes.push_back(mesh);
+        }
+        return parts;
+    }
+}
+
+TEST_CASE("CollisionWorld: footprint hull", "[benchmark][collision]") {
+    for (int count : {100, 1000, 10000}) {
+        std::mt19937 rng(BenchSeed);
+        std::normal_distribution<float> spread(0.f, 2.f);
+        std::vector<Vector2> points(static_cast<size_t>(count));
+        for (auto& p : points) p.set(spread(rng), spread(rng));
+
+        BENCHMARK(benchName("footprintHull", count, "points")) {
+            return CollisionWorld::footprintHull(points).size();
+        };
+    }
+}
+
+TEST_CASE("CollisionWorld: resolveExcavatorMove", "[benchmark][collision]") {
+    for (int count : {10, 100, 1000}) {
+        std::mt19937 rng(BenchSeed);
+        const float radius = scatterColliders(count, rng);
+
+        // Probes all over the arena, the same sequence every run
+        std::uniform_real_distribution<float> pos(-radius, radius);
+        std::vector<Vector2> probes(256);
+        for (auto& p : probes) p.set(pos(rng), pos(rng));
+        size_t next = 0;
+
+        BENCHMARK(benchName("resolveExcavatorMove", count, "colliders")) {
+            const auto& p = probes[next++ % probes.size()];
+            float x = p.x, z = p.y;
+            return CollisionWorld::resolveExcavatorMove(x, z, 1.2f);
+        };
+    }
+    CollisionWorld::clear();
+}
+
+TEST_CASE("CollisionWorld: resolveExcavatorMeshCollisions", "[benchmark][collision]") {
+    auto parts = makeExcavator();
+    for (int count : {10, 100, 1000}) {
+        std::mt19937 rng(BenchSeed);
+        const float radius = scatterColliders(count, rng);
+
+        std::uniform_real_distribution<float> pos(-radius, radius);
+        std::vector<Vector2> probes(256);
+        for (auto& p : probes) p.set(pos(rng), pos(rng));
+        size_t next = 0;
+
+        BENCHMARK(benchName("resolveExcavatorMeshCollisions", count, "colliders")) {
+            const auto& p = probes[next++ % probes.size()];
+            parts.root->position.set(p.x, 0.f, p.y);
+            parts.root->updateMatrixWorld(true);
+            return CollisionWorld::resolveExcavatorMeshCollisions(parts.root.get(), parts.meshes[0].get(), parts.meshes[1].get(),
+                                                                  parts.meshes[2].get(), parts.meshes[3].get(), parts.meshes[4].get());
+        };
+    }
+    CollisionWorld::clear();
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <string>
+
+// Every benchmark draws its inputs from this seed, so runs (and builds) measure the same work
+constexpr unsigned int BenchSeed = 20240611u;
+
+// "name, 1000 colliders": one benchmark name per size, so results line up across runs
+inline std::string benchName(const std::string& name, int count, const std::string& unit) {
+    return name + ", " + std::to_string(count) + " " + unit;
+}
@@ -0,0 +1,23 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "bench_common.hpp"
+#include "Heightfield.hpp"
+#include "HeightfieldMesh.hpp"
+#include <threepp/materials/MeshBasicMaterial.hpp>
+
+using namespace threepp;
+
+TEST_CASE("Heightfield: dig and re-mesh", "[benchmark][heightfield]") {
+    Heightfield field(Vector3(0.f, 0.f, 0.f), 50.f, 512);
+    field.fill([](float, float) { return 3.f; });
+    HeightfieldMesh mesh(field, MeshBasicMaterial::create());
+
+    // One frame of digging: a short bucket stroke plus re-meshing the touched tiles
+    float x = -20.f;
+    BENCHMARK("Heightfield::excavate + HeightfieldMesh::sync, 512x512") {
+        x = x > 20.f ? -20.f : x + 0.05f;
+        const float removed = field.excavate(Vector3(x, 2.5f, 0.f), Vector3(x + 0.05f, 2.5f, 0.f), 0.6f, 1.f);
+        mesh.sync();
+        return removed;
+    };
+}
@@ -0,0 +1,24 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "bench_common.hpp"
+#include "ParticleSystem.hpp"
+#include <threepp/scenes/Scene.hpp>
+#include <random>
+
+using namespace threepp;
+
+TEST_CASE("ParticleSystem: update", "[benchmark][particle]") {
+    for (int count : {100, 1000, 5000}) {
+        Scene scene;
+        ParticleSystem particles(scene, BenchSeed);
+        std::mt19937 rng(BenchSeed);
+        std::uniform_real_distribution<float> pos(-20.f, 20.f);
+        for (int i = 0; i < count; ++i) particles.spawnParticle(Vector3(pos(rng), 0.f, pos(rng)));
+
+        // A tiny step so the whole set stays alive however many iterations the harness runs
+        BENCHMARK(benchName("ParticleSystem::update", count, "particles")) {
+            particles.update(1e-7f);
+            return particles.getActiveCount();
+        };
+    }
+}
@@ -0,0 +1,18 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "bench_common.hpp"
+#include "PoissonDiskSampler.hpp"
+#include <cmath>
+
+TEST_CASE("PoissonDiskSampler: generate", "[benchmark][poisson]") {
+    // Area / spacing^2 sized so the disc holds well over 100k points
+    BENCHMARK("PoissonDiskSampler::generate, 100k points") {
+        PoissonDiskSampler sampler(240.f, BenchSeed);
+        return sampler.generate(1.f).size();
+    };
+    BENCHMARK("PoissonDiskSampler::generate, 100k points around 200 obstacles") {
+        PoissonDiskSampler sampler(240.f, BenchSeed);
+        for (int i = 0; i < 200; ++i) sampler.addObstacle(std::cos(i * 0.7f) * i, std::sin(i * 0.7f) * i, 3.f);
+        return sampler.generate(1.f).size();
+    };
+}
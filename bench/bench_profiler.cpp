@@ -0,0 +1,15 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "bench_common.hpp"
+#include "FrameProfiler.hpp"
+
+TEST_CASE("FrameProfiler: zone cost", "[benchmark][profiler]") {
+    const auto zone = FrameProfiler::registerZone("bench");
+    FrameProfiler::beginFrame();
+    BENCHMARK("FrameProfiler::Zone, empty") {
+        FrameProfiler::Zone z(zone);
+        return 0;
+    };
+    FrameProfiler::endFrame();
+    FrameProfiler::reset();
+}
@@ -0,0 +1,33 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "bench_common.hpp"
+#include "SoilVolume.hpp"
+#include <threepp/math/Vector3.hpp>
+#include <string>
+
+using namespace threepp;
+
+TEST_CASE("SoilVolume: bucket sweep step", "[benchmark][soil]") {
+    SoilVolume soil(Vector3(0.f, 0.f, 0.f), 0.25f); // one thread per core
+    for (int z = 0; z < 64; ++z) {
+        for (int x = 0; x < 64; ++x) {
+            for (int y = 0; y < 32; ++y) soil.setVoxel(x, y, z, 1.f);
+        }
+    }
+    for (int i = 0; i < 2000 && soil.step() > 0; ++i) {} // settled before the bucket comes in
+
+    // Bricks per second = bricks per step / mean time
+    float x = 1.f;
+    size_t bricks = 0;
+    for (int i = 0; i < 20; ++i) {
+        soil.setBoundary(Vector3(x + i * 0.05f, 6.f, 8.f), 0.6f);
+        bricks += soil.step();
+    }
+    const std::string name = "SoilVolume::step, bucket sweep, ~" + std::to_string(bricks / 20) + " bricks, " +
+                             std::to_string(soil.getThreadCount()) + " threads";
+    BENCHMARK(name) {
+        x = x > 15.f ? 1.f : x + 0.05f;
+        soil.setBoundary(Vector3(x, 6.f, 8.f), 0.6f);
+        return soil.step();
+    };
+}
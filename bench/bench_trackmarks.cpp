@@ -0,0 +1,29 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "bench_common.hpp"
+#include "TrackMarkManager.hpp"
+#include "Settings.hpp"
+#include <threepp/scenes/Scene.hpp>
+#include <cmath>
+
+using namespace threepp;
+
+TEST_CASE("TrackMarkManager: update", "[benchmark][trackmarks]") {
+    Scene scene;
+    TrackMarkManager marks(scene);
+    marks.setSpawnDistance(0.4f);
+    marks.setLifetime(3.f);
+    Settings::distanceAccumulator_ = 0.f;
+
+    // Driving in a circle at about 2 m/s and 60 fps: a mark every few frames, the ring wraps
+    float angle = 0.f;
+    BENCHMARK("TrackMarkManager::update, driving") {
+        angle += 0.002f;
+        return (marks.update(1.f / 60.f, Vector3(16.f * std::cos(angle), 0.f, 16.f * std::sin(angle))), 0);
+    };
+
+    // Standing still is the common case between moves
+    BENCHMARK("TrackMarkManager::update, parked") {
+        return (marks.update(1.f / 60.f, Vector3(16.f, 0.f, 0.f)), 0);
+    };
+}
@@ -0,0 +1,24 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "bench_common.hpp"
+#include "DigZone.hpp"
+#include <random>
+#include <vector>
+
+using namespace threepp;
+
+TEST_CASE("DigZone: isInZone", "[benchmark][zones]") {
+    DigZone zone(Vector3(0.f, 0.f, 18.f), 3.f);
+
+    // Bucket positions around and inside the pile, the same set every run
+    std::mt19937 rng(BenchSeed);
+    std::uniform_real_distribution<float> xz(-5.f, 5.f);
+    std::uniform_real_distribution<float> y(-0.5f, 3.f);
+    std::vector<Vector3> probes(1024);
+    for (auto& p : probes) p.set(xz(rng), y(rng), 18.f + xz(rng));
+    size_t next = 0;
+
+    BENCHMARK("DigZone::isInZone") {
+        return zone.isInZone(probes[next++ % probes.size()]);
+    };
+}
@@ -0,0 +1,13 @@
+# Runs at build time (cmake -P): writes OUTPUT from build_id.h.in with the current git hash.
+# configure_file leaves the file alone when the hash hasn't changed, so nothing recompiles then.
+execute_process(
+        COMMAND git rev-parse --short HEAD
+        WORKING_DIRECTORY ${SOURCE_DIR}
+        OUTPUT_VARIABLE BLOCKS_BUILD_ID
+        OUTPUT_STRIP_TRAILING_WHITESPACE
+        ERROR_QUIET
+)
+if (NOT BLOCKS_BUILD_ID)
+    set(BLOCKS_BUILD_ID "unknown")
+endif()
+configure_file(${SOURCE_DIR}/cmake/build_id.h.in ${OUTPUT} @ONLY)
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#ifndef BLOCKS_ALLOC_TRACKING
+#define BLOCKS_ALLOC_TRACKING 0
+#endif
+
+/**
+ * AllocationTracker: counts heap allocations (operator new calls and the bytes asked for).
+ * A binary that links AllocationHooks.cpp (the blocks_alloc_hooks object library) has its global
+ * operator new/delete replaced; while counting is on, each allocation is added to the allocating
+ * thread's running totals and to a process-wide total. Counting starts off (an allocation then costs
+ * one flag check). Built with BLOCKS_ALLOC_TRACKING=1, FrameProfiler takes the frame thread's totals
+ * at the start and end of every frame and zone, so it reports allocations per frame and per zone.
+ * Over-aligned allocations (alignas > 16) go through the library's own aligned new and aren't counted.
+ * Without the hooks nothing is replaced and every count stays zero.
+ */
+class AllocationTracker {
+public:
+    struct Counts {
+        uint64_t allocations;
+        uint64_t bytes;
+    };
+
+    static constexpr bool compiledIn = BLOCKS_ALLOC_TRACKING != 0;
+
+    static void setEnabled(bool enabled);
+    static bool enabled();
+
+    // Running totals since the program started, counting only while enabled
+    static Counts thread() { return t_counts; }
+    static Counts total();
+
+    // Allocations made by the constructing thread since construction (steady-state checks in tests)
+    class Scope {
+    public:
+        Scope() : start_(thread()) {}
+        Counts counts() const {
+            const Counts now = thread();
+            return {now.allocations - start_.allocations, now.bytes - start_.bytes};
+        }
+
+    private:
+        Counts start_{};
+    };
+
+    // Called by the replaced operator new
+    static void record(size_t bytes);
+
+private:
+    // Read by every profiler zone, so inline here rather than behind a call
+    static inline thread_local Counts t_counts{};
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <threepp/threepp.hpp>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "MeshCache.hpp"
+
+/**
+ * AssetRegistry: geometry and materials shared by everything that asks for the same asset.
+ * A model path is loaded once (through MeshCache); every load() after that gets a new Group whose
+ * meshes point at the same BufferGeometry and Material objects, so the data is held and uploaded to
+ * the GPU once however many copies are in the scene. Procedural geometry and materials are shared
+ * the same way by name.
+ * Shared means shared: changing a material handed out here changes it on every copy. Only recolour
+ * a model's materials (the bucket does) if nothing else loads that model, or give the copy its own.
+ * The counts behind report() are per hand-out: a model loaded twice is one model with two references.
+ */
+class AssetRegistry {
+public:
+    struct Report {
+        size_t models{0};          // model files loaded
+        size_t modelRefs{0};       // load() calls served
+        size_t geometries{0};      // unique geometries held
+        size_t geometryRefs{0};    // geometries handed out (per mesh, per load)
+        size_t materials{0};       // unique materials held
+        size_t materialRefs{0};    // materials handed out
+        size_t uniqueBytes{0};     // vertex + index data actually held
+        size_t referencedBytes{0}; // what it would take with a copy per reference
+    };
+
+    // Model by path: parsed (or read from the mesh cache) on the first call, shared after that.
+    // Bounds and hull as MeshCache returns them; group is null if the file didn't load
+    static MeshCache::Model load(const std::string& path, bool loadMtl = false);
+    // Hand over a model loaded elsewhere (AsyncLoader), later load() calls share it. Main thread
+    static void adopt(const std::string& path, bool loadMtl, MeshCache::MeshData data);
+    static bool has(const std::string& path, bool loadMtl = false);
+
+    // Procedural assets by name, create() only runs the first time a name is asked for
+    static std::shared_ptr<threepp::BufferGeometry> geometry(
+        const std::string& name, const std::function<std::shared_ptr<threepp::BufferGeometry>()>& create);
+    static std::shared_ptr<threepp::Material> material(
+        const std::string& name, const std::function<std::shared_ptr<threepp::Material>()>& create);
+
+    static Report report();
+    // Forget everything (objects already handed out keep their data alive)
+    static void clear();
+
+private:
+    struct MeshEntry {
+        std::string name;
+        std::shared_ptr<threepp::BufferGeometry> geometry;
+        std::shared_ptr<threepp::Material> material;
+    };
+
+    struct ModelEntry {
+        MeshCache::Model info; // bounds and hull, the group itself isn't kept
+        std::vector<MeshEntry> meshes;
+        size_t refs{0};
+    };
+
+    template<class T>
+    struct Shared {
+        std::shared_ptr<T> asset;
+        size_t refs{0};
+    };
+
+    static ModelEntry& insert_(const std::string& key, MeshCache::Model loaded);
+
+    static std::mutex s_mutex;
+    static std::unordered_map<std::string, ModelEntry> s_models;
+    static std::unordered_map<std::string, Shared<threepp::BufferGeometry>> s_geometries;
+    static std::unordered_map<std::string, Shared<threepp::Material>> s_materials;
+};
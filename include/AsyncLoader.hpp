@@ -0,0 +1,74 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include "Settings.hpp"
+
+/**
+ * AsyncLoader: startup assets read on a worker pool while the main thread keeps drawing frames.
+ * A job is split in two: the work (file I/O, parsing) runs on a worker and returns a
+ * finish step, which poll() runs on the main thread. Anything that makes threepp objects goes in
+ * the finish step, threepp isn't thread safe; the GL upload then happens in the next render.
+ * Models are the common case: the worker maps or parses the OBJ (MeshCache::loadData) and the
+ * finish step hands it to the AssetRegistry, so the code that builds the scene later just gets
+ * registry hits. Sounds aren't loader jobs: threepp's Audio opens and decodes a file by path when
+ * it's made, so there's no plain data a worker could hand over. main loads them synchronously on
+ * the main thread once the AudioManager exists, outside the loader's timings.
+ */
+class AsyncLoader {
+public:
+    using Finish = std::function<void()>;
+    using Work = std::function<Finish()>;
+
+    struct Stats {
+        size_t requested{0};
+        size_t finished{0};
+        double firstFrameMs{-1.0};   // from start to the first markFrame(), -1 until then
+        double fullyLoadedMs{-1.0};  // from start to the last finish step, -1 until then
+    };
+
+    // Timings count from start (program start in main). threads = 0: one per core, leaving one for the main thread
+    explicit AsyncLoader(std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now(),
+                         unsigned threads = Settings::assetLoaderThreads_);
+    ~AsyncLoader();
+
+    AsyncLoader(const AsyncLoader&) = delete;
+    AsyncLoader& operator=(const AsyncLoader&) = delete;
+
+    void request(Work work);
+    // OBJ into the AssetRegistry; asking twice for the same model is one job
+    void requestModel(const std::string& path, bool loadMtl = false);
+
+    // Main thread, once per frame: run up to maxFinishes finished jobs' finish steps
+    void poll(size_t maxFinishes = SIZE_MAX);
+    // Block until every job is done and finished (tests, or when there's nothing to draw anyway)
+    void finishAll();
+    // Call once per drawn frame, the first one sets time to first frame
+    void markFrame();
+
+    bool done() const;
+    float progress() const; // finished / requested, 1 when nothing was asked for
+    Stats getStats() const;
+
+private:
+    void workerLoop_();
+    double msSinceStart_() const;
+
+    std::chrono::steady_clock::time_point start_;
+    std::vector<std::thread> workers_;
+    mutable std::mutex mutex_;
+    std::condition_variable workCv_;
+    std::condition_variable readyCv_;
+    std::deque<Work> jobs_;
+    std::deque<Finish> ready_;
+    std::unordered_set<std::string> models_; // already requested
+    Stats stats_;
+    bool stop_{false};
+};
@@ -8,7 +8,15 @@
 
 class AudioManager {
 public:
+    enum class Sound { Startup, Idle, Hydraulics, Steam, Coin };
+
     explicit AudioManager(threepp::AudioListener& listener);
+
+    // Open and decode a sound file, null if it fails. Doesn't touch the manager, but it makes a threepp
+    // object, so main thread only
+    static std::unique_ptr<threepp::Audio> openSound(threepp::AudioListener& listener, const std::string& path);
+    // Take an opened sound and give it its looping/volume
+    void setSound(Sound sound, std::unique_ptr<threepp::Audio> audio);
     
     // sound files
     void loadStartupSound(const std::string& path);
@@ -1,25 +1,25 @@
 #pragma once
 
 #include <threepp/math/Vector3.hpp>
-#include <threepp/objects/Mesh.hpp>
-#include <memory>
+#include <cstddef>
 #include "Settings.hpp"
 
+// Coin: plain data now. Drawing (spin/bob) happens in CoinManager's instanced shader,
+// the coin just remembers where it is and which instance slot draws it.
 class Coin {
 public:
-    Coin(const threepp::Vector3& position, std::shared_ptr<threepp::Mesh> mesh);
+    Coin(const threepp::Vector3& position, size_t instanceId);
     
     bool isCollected() const { return collected_; }
     void collect() { collected_ = true; }
+    // Pool reuse: move to a new spot and become collectable again
+    void respawn(const threepp::Vector3& position) { position_ = position; collected_ = false; }
     
     const threepp::Vector3& getPosition() const { return position_; }
-    std::shared_ptr<threepp::Mesh> getMesh() { return mesh_; }
-    
-    void update(float dt);
+    size_t getInstanceId() const { return instanceId_; }
     
 private:
     threepp::Vector3 position_;
-    std::shared_ptr<threepp::Mesh> mesh_;
+    size_t instanceId_;
     bool collected_{false};
-    float time_{0.f};
 };
@@ -2,24 +2,69 @@
 
 #include "Coin.hpp"
 #include <threepp/scenes/Scene.hpp>
+#include <threepp/objects/InstancedMesh.hpp>
+#include <threepp/materials/ShaderMaterial.hpp>
 #include <vector>
 #include <memory>
+#include <cstdint>
+#include <random>
 #include "Settings.hpp"
+#include "EventStream.hpp"
 
+/**
+ * CoinManager: spawns and collects the coins.
+ * Uncollected coins are indexed in a uniform grid over XZ hashed into a fixed bucket table,
+ * so collection only looks at coins in the cells around the excavator. Collected coins drop
+ * out of the index and are never tested again.
+ * All coins are drawn by one InstancedMesh; spin and bob are computed in its vertex shader from
+ * a global time uniform, so the only per-coin CPU work left is collection.
+ * Coins are pooled: reset() scatters the same coins again instead of rebuilding anything.
+ */
 class CoinManager {
 public:
-    CoinManager(threepp::Scene& scene);
+    // seed: fixed layouts for tests/training runs, random by default
+    CoinManager(threepp::Scene& scene, unsigned int seed = std::random_device{}());
     
     void spawnCoins(int count, float arenaRadius);
-    void update(float dt);
+    void update(float dt); // only advances the shader clock
     bool checkCollection(const threepp::Vector3& position, float collectionRadius = 2.0f);
     
+    // Publish a CoinCollected event per coin picked up (nullptr = don't publish)
+    void setEventStream(EventStream* events) { events_ = events; }
+    
     int getCollectedCount() const { return Settings::collectedCount_; }
     int getTotalCount() const { return static_cast<int>(coins_.size()); }
+    const std::vector<Coin>& getCoins() const { return coins_; }
+    std::shared_ptr<threepp::InstancedMesh> getInstancedMesh() const { return instances_; }
     
+    // Re-scatter every pooled coin and clear progress (no allocations, same buffers)
     void reset();
+    // Drop the pool entirely
+    void clear();
     
 private:
+    void rebuildIndex_();
+    void rebuildInstances_();
+    threepp::Vector3 randomPosition_();
+    size_t bucketOf_(int cx, int cz) const;
+    int cellCoord_(float v) const;
+
     threepp::Scene& scene_;
-    std::vector<std::unique_ptr<Coin>> coins_;
+    std::vector<Coin> coins_;
+    std::mt19937 rng_;
+    float arenaRadius_{0.f}; // from the last spawnCoins, reused by reset
+    EventStream* events_{nullptr};
+
+    // Rendering: one instance per coin, collected coins get a zero-scale matrix
+    float time_{0.f};
+    std::shared_ptr<threepp::BufferGeometry> coinGeometry_;
+    std::shared_ptr<threepp::ShaderMaterial> coinMaterial_;
+    std::shared_ptr<threepp::InstancedMesh> instances_;
+
+    // Spatial hash in counting-sort layout: bucket b owns entries_[bucketStart_[b], bucketStart_[b + 1]),
+    // the first bucketLive_[b] of which are still uncollected
+    float cellSize_{Settings::coinCellSize_};
+    std::vector<uint32_t> bucketStart_;
+    std::vector<uint32_t> bucketLive_;
+    std::vector<uint32_t> entries_; // indices into coins_
 };
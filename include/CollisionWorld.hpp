@@ -2,6 +2,7 @@
 
 #include <threepp/math/Vector3.hpp>
 #include <threepp/math/Vector2.hpp>
+#include <cstdint>
 #include <vector>
 #include <memory>
 
@@ -12,14 +13,21 @@ namespace threepp {
     struct Vector3;
 }
 
+class DebugDraw;
+
 // Minimal collision world: static ground plane and rock mesh colliders
 class CollisionWorld {
 public:
     struct MeshXZCollider {
         // Convex hull of the rock footprint projected to XZ (CCW order)
         std::vector<threepp::Vector2> hull;
+        bool enabled{true}; // disabled colliders keep their slot but don't push
     };
 
+    // Stable id of a mesh collider (index of its slot), valid until removed
+    using ColliderHandle = int;
+    static constexpr ColliderHandle InvalidCollider = -1;
+
     struct NoCollisionZone {
         // Oriented rectangle on XZ plane where collisions are ignored
         threepp::Vector3 center; // use x,z; y ignored
@@ -31,19 +39,34 @@ public:
     // Ground plane Y (after ground is rotated to XZ plane)
     static float groundY();
 
-    // Registers a mesh-based collider by computing the convex hull of all mesh vertices projected to XZ
+    // Registers a static mesh-based collider by computing the convex hull of all mesh vertices projected to XZ.
+    // It can't be changed afterwards, colliders that change use the handles below
     static void addRockMeshColliderFromObject(threepp::Object3D& obj);
 
-    // Recomputes the convex hull from the given object and updates the last mesh collider.
-    // Useful when a pile changes size (e.g., digging reduces the pile).
-    static void updateLastRockMeshColliderFromObject(threepp::Object3D& obj);
+    // Handle based colliders for things that change or come and go (piles, zones).
+    // A degenerate point set still gets a slot (it just doesn't collide until updated).
+    // Removed slots are reused by the next add.
+    static ColliderHandle addMeshColliderFromPoints(std::vector<threepp::Vector2> points);
+    static void updateMeshCollider(ColliderHandle handle, std::vector<threepp::Vector2> points);
+    static void setMeshColliderEnabled(ColliderHandle handle, bool enabled);
+    static bool isMeshColliderEnabled(ColliderHandle handle);
+    static void removeMeshCollider(ColliderHandle handle);
+    // Instanced props: hull is the template's XZ footprint (from footprintHull) at scale 1, yaw 0,
+    // it is only rotated/scaled/moved here, so placing many copies never recomputes a hull
+    static ColliderHandle addMeshColliderFromTemplate(const std::vector<threepp::Vector2>& hull,
+                                                      float x, float z, float yaw, float scale);
+    // Convex hull (CCW) of an XZ point cloud, empty if it has no area
+    static std::vector<threepp::Vector2> footprintHull(std::vector<threepp::Vector2> points);
 
-    // Remove the most recently added mesh collider (e.g., when a dynamic pile is depleted)
-    static void popLastRockMeshCollider();
+    // Colliders currently taking part in collision
+    static size_t getActiveMeshColliderCount();
 
     // Clears all rock colliders (useful when regenerating the environment)
     static void clear();
 
+    // Bumped by every change to the mesh colliders, so cached views of them know when to refresh
+    static uint64_t revision();
+
     // Adjust a proposed excavator (x,z) position to avoid penetrating any rock sphere
     // Returns true if any adjustment was made
     static bool resolveExcavatorMove(float& x, float& z, float excavatorRadius);
@@ -62,19 +85,21 @@ public:
     static void addNoCollisionZone(const NoCollisionZone& zone);
     static void clearNoCollisionZones();
 
-    // Debug visualization
-    static void debugDrawRockHulls(threepp::Scene& scene, std::vector<std::shared_ptr<threepp::Object3D>>& debugObjects);
-    static void debugDrawExcavatorHulls(threepp::Scene& scene, 
+    // Debug visualization: rock hulls go in the static lines (redrawn only when revision() moves),
+    // excavator part hulls in the per-frame lines
+    static void debugDrawRockHulls(DebugDraw& draw);
+    static void debugDrawExcavatorHulls(DebugDraw& draw,
                                          threepp::Object3D* baseMesh,
                                          threepp::Object3D* bodyMesh,
                                          threepp::Object3D* boomMesh,
                                          threepp::Object3D* stickMesh,
-                                         threepp::Object3D* bucketMesh,
-                                         std::vector<std::shared_ptr<threepp::Object3D>>& debugObjects);
+                                         threepp::Object3D* bucketMesh);
 
 private:
     static std::vector<MeshXZCollider> s_rockMeshes;
+    static std::vector<ColliderHandle> s_freeMeshSlots;
     static float s_rockHullPadding;
 
     static std::vector<NoCollisionZone> s_noCollisionZones;
+    static uint64_t s_revision;
 };
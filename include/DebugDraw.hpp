@@ -0,0 +1,75 @@
+#pragma once
+
+#include <threepp/objects/LineSegments.hpp>
+#include <threepp/core/BufferGeometry.hpp>
+#include <threepp/materials/LineBasicMaterial.hpp>
+#include <threepp/math/Color.hpp>
+#include <threepp/math/Vector3.hpp>
+#include <cstdint>
+#include <memory>
+#include "Settings.hpp"
+
+/**
+ * DebugDraw: collision debug lines in two persistent line buffers added to the scene once.
+ * The static buffer holds lines that only change when their source does (rock hulls): the caller
+ * tags them with a revision (CollisionWorld::revision()) and they are rewritten and uploaded only
+ * when it moves. The dynamic buffer (excavator hulls) is refilled every frame between
+ * beginFrame() and endFrame(), written straight into the vertex array and uploaded once, only
+ * as far as the segments written (the attributes' update range, not the whole capacity).
+ * A buffer that runs out of room doubles (a new geometry, rare); otherwise nothing is created per
+ * frame, so debug drawing costs two draw calls and a vertex upload.
+ */
+class DebugDraw {
+public:
+    explicit DebugDraw(threepp::Object3D& parent, size_t initialSegments = static_cast<size_t>(Settings::debugLineCapacity_));
+    ~DebugDraw();
+
+    DebugDraw(const DebugDraw&) = delete;
+    DebugDraw& operator=(const DebugDraw&) = delete;
+
+    // Static lines: if revision differs from the one drawn, clear them and return true so the caller
+    // adds the new set with staticLine(); false means the buffer already shows that revision
+    bool beginStatic(uint64_t revision);
+    void staticLine(const threepp::Vector3& a, const threepp::Vector3& b, const threepp::Color& color);
+
+    // Dynamic lines: cleared by beginFrame(), uploaded by endFrame()
+    void beginFrame();
+    void line(const threepp::Vector3& a, const threepp::Vector3& b, const threepp::Color& color);
+    void endFrame();
+
+    // Hide both buffers (contents are kept); showing again redraws nothing static
+    void setVisible(bool visible);
+    bool visible() const { return visible_; }
+
+    // Drop everything, the next beginStatic() rebuilds whatever revision it gets
+    void clear();
+
+    size_t staticSegments() const { return static_.count; }
+    size_t dynamicSegments() const { return dynamic_.count; }
+    size_t staticCapacity() const { return static_.capacity; }
+    size_t dynamicCapacity() const { return dynamic_.capacity; }
+    // How often the static buffer was rewritten (one per revision change)
+    size_t staticUploads() const { return staticUploads_; }
+
+private:
+    struct Buffer {
+        std::shared_ptr<threepp::BufferGeometry> geometry;
+        std::shared_ptr<threepp::LineSegments> lines;
+        size_t capacity{0}; // segments
+        size_t count{0};
+    };
+
+    void allocate_(Buffer& buffer, size_t capacity);
+    void write_(Buffer& buffer, const threepp::Vector3& a, const threepp::Vector3& b, const threepp::Color& color);
+    void upload_(Buffer& buffer);
+
+    threepp::Object3D& parent_;
+    std::shared_ptr<threepp::LineBasicMaterial> material_;
+    Buffer static_;
+    Buffer dynamic_;
+    uint64_t staticRevision_{0};
+    bool hasStatic_{false};
+    bool staticOpen_{false}; // beginStatic() said rebuild, upload at the next endFrame()
+    size_t staticUploads_{0};
+    bool visible_{true};
+};
@@ -3,16 +3,21 @@
 
 #include <threepp/threepp.hpp>
 #include <memory>
+#include <vector>
+#include "Heightfield.hpp"
+#include "HeightfieldMesh.hpp"
+#include "Settings.hpp"
 
 /**
  * DigZone represents a sand/rock pile that can be "dug" by the excavator bucket.
- * When the bucket enters this zone, it becomes loaded with material.
+ * The pile is a heightfield (same cylinder + dome mound as before) that the bucket carves into,
+ * the removed soil volume goes into the bucket. Only the terrain tiles that changed get re-uploaded.
  */
 class DigZone {
 public:
-    DigZone(const threepp::Vector3& position, float radius);
+    DigZone(const threepp::Vector3& position, float radius, int resolution = Settings::digFieldResolution_);
     
-    // Check if a point (bucket position) is within the dig zone
+    // Check if a point (bucket position) is within the pile (under the soil surface)
     bool isInZone(const threepp::Vector3& point) const;
     
     // Get the visual representation for the scene
@@ -22,8 +27,24 @@ public:
     const threepp::Vector3& getPosition() const { return m_position; }
     float getRadius() const { return m_radius; }
 
-    // Reduce the pile by a fraction [0..1], returns true if changed
+    // Reduce the pile by a fraction [0..1] (uniform shrink of the whole mound), returns true if changed
     bool dig(float fraction);
+
+    // Carve the bucket's sweep from `from` to `to` (sphere of `radius`), taking at most `capacity` m^3.
+    // Returns the soil volume removed, which is exactly what the pile lost.
+    float excavate(const threepp::Vector3& from, const threepp::Vector3& to, float radius, float capacity);
+
+    // Soil left in the pile / at full size (m^3)
+    float getVolume() const { return m_field->volume(); }
+    float getInitialVolume() const { return m_initialVolume; }
+
+    // Pile outline on XZ for the collider
+    void footprint(std::vector<threepp::Vector2>& out) const { m_field->footprint(out); }
+
+    // Upload the terrain tiles changed since the last call (once per frame), returns tiles uploaded
+    size_t update() { return m_mesh->sync(); }
+
+    const Heightfield& getHeightfield() const { return *m_field; }
     
     // Reset to initial state (full size)
     void reset();
@@ -33,8 +54,13 @@ private:
     float m_radius;
     std::shared_ptr<threepp::Group> m_visual;
     float m_scale{1.0f};
+    float m_initialVolume{0.f};
+
+    std::unique_ptr<Heightfield> m_field;
+    std::unique_ptr<HeightfieldMesh> m_mesh;
     
     void createVisual();
+    void buildMound(float scale);
 };
 
 #endif // DIGZONE_HPP
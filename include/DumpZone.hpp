@@ -3,10 +3,15 @@
 
 #include <threepp/threepp.hpp>
 #include <memory>
+#include "Heightfield.hpp"
+#include "HeightfieldMesh.hpp"
+#include "Settings.hpp"
 
 /**
  * DumpZone represents an area where excavated material can be dumped.
  * Tracks how many successful dumps have occurred.
+ * Dumped soil piles up on a heightfield as angle-of-repose cones, so the heap shape
+ * follows the actual deposited volume. The pile mesh is allocated once and deformed in place.
  */
 class DumpZone {
 public:
@@ -15,8 +20,14 @@ public:
     // Check if a point (bucket position) is within the dump zone
     bool isInZone(const threepp::Vector3& point) const;
     
-    // Record a successful dump
+    // Record a successful dump (one full bucket at the middle of the zone)
     void recordDump();
+    // Record a dump of `volume` m^3 released at `position` (clamped onto the platform)
+    void recordDump(const threepp::Vector3& position, float volume);
+
+    // Soil on the platform (m^3)
+    float getVolume() const { return m_field->volume(); }
+    const Heightfield& getHeightfield() const { return *m_field; }
     
     // Get total dumps made (unused)
     // int getDumpCount() const { return m_dumpCount; }
@@ -36,10 +47,10 @@ private:
     float m_radius;
     int m_dumpCount{0};
     std::shared_ptr<threepp::Group> m_visual;
-    std::shared_ptr<threepp::Mesh> m_pileMesh;
+    std::unique_ptr<Heightfield> m_field;
+    std::unique_ptr<HeightfieldMesh> m_pileMesh;
     
     void createVisual();
-    void updatePileHeight();
 };
 
 #endif // DUMPZONE_HPP
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <threepp/math/Vector3.hpp>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "Settings.hpp"
+#include "SpscQueue.hpp"
+
+enum class GameEventType {
+    CoinCollected,
+    Dig,
+    Dump,
+    Reset // consumers should drop whatever they derived from earlier events
+};
+
+struct GameEvent {
+    GameEventType type{GameEventType::CoinCollected};
+    int coinId{-1};                // coin instance id, -1 for non-coin events
+    threepp::Vector3 position{};   // where it happened (coin, bucket...)
+    double timestamp{0.0};         // simulation clock in seconds
+};
+
+/**
+ * EventStream: gameplay events fanned out to independent consumers (audio, UI, telemetry, scoring...).
+ * Every subscriber gets its own SPSC queue, so the simulation thread publishes without locks and
+ * each consumer drains at its own pace on its own thread without touching simulation state.
+ * Subscribe during setup, before anything is published.
+ */
+class EventStream {
+public:
+    using Queue = SpscQueue<GameEvent, Settings::EventQueueCapacity>;
+
+    class Subscription {
+    public:
+        // Consumer side: next event in publish order, false when empty
+        bool poll(GameEvent& out) { return queue_.tryPop(out); }
+        // Events lost because this consumer fell a whole queue behind
+        size_t getDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+    private:
+        friend class EventStream;
+        Queue queue_;
+        std::atomic<size_t> dropped_{0};
+    };
+
+    // Setup only (not safe against a concurrent publish)
+    Subscription& subscribe();
+    size_t getSubscriberCount() const { return subscribers_.size(); }
+
+    // Producer side (simulation thread)
+    void advanceClock(float dt) { now_ += dt; }
+    double now() const { return now_; }
+    void publish(GameEventType type, const threepp::Vector3& position, int coinId = -1);
+
+private:
+    std::vector<std::unique_ptr<Subscription>> subscribers_;
+    double now_{0.0};
+};
@@ -115,7 +115,16 @@ public:
     // Bucket load state for dig/dump gameplay
     bool isBucketLoaded() const { return Settings::bucketLoaded_; }
     void loadBucket();
-    void unloadBucket();
+    // Empties the bucket, returns the soil volume that was in it (m^3)
+    float unloadBucket();
+
+    // Soil in the bucket (m^3). What it can hold depends on the curl: an open bucket spills the heap.
+    float getBucketVolume() const { return bucketVolume_; }
+    float getBucketCapacity() const { return Settings::bucketCapacity_ * bucketFillFactor(Settings::bucketAngle_); }
+    // Adds carved soil up to the current capacity, returns how much fit
+    float addToBucket(float volume);
+    // Fraction of the rated capacity held at a bucket angle: bucketMinFill_ fully open, 1 fully curled
+    static float bucketFillFactor(float bucketAngle);
     
     // Get bucket world position for zone detection
     threepp::Vector3 getBucketWorldPosition() const;
@@ -133,7 +142,7 @@ private:
     // Root of the excavator hierarchy
     std::shared_ptr<threepp::Object3D> root_;
 
-    // Loaded meshes (Groups from OBJLoader)
+    // Loaded meshes (Groups from MeshCache)
     std::array<std::shared_ptr<threepp::Group>, 3> leftTrackMeshes_;
     std::array<std::shared_ptr<threepp::Group>, 3> rightTrackMeshes_;
     std::shared_ptr<threepp::Group> baseMesh_;
@@ -158,4 +167,6 @@ private:
 
     // Particle system for dust effects
     ParticleSystem* particleSystem_{nullptr};
+
+    float bucketVolume_ = 0.0f; // m^3 of soil carried
 };
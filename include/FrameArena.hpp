@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+/**
+ * FrameArena: bump allocator for scratch data that only lives until the end of the frame (hull
+ * point lists of the excavator parts). Allocating is a pointer bump, freeing does nothing; reset()
+ * at the end of the frame makes the whole arena free again. It is a std::pmr::memory_resource, so
+ * std::pmr::vector and friends can live in it.
+ * When a frame needs more than the block holds, extra blocks are taken from the heap and the next
+ * reset() swaps them all for one block big enough, so a steady frame runs out of one block and
+ * never touches the heap.
+ * Rewind scopes hand memory back early (stack order), so code that can also run outside a frame
+ * (tests, benchmarks, startup) doesn't keep growing the arena.
+ * Not thread safe: frame() is the frame loop's arena, use it from that thread only.
+ */
+class FrameArena : public std::pmr::memory_resource {
+public:
+    explicit FrameArena(size_t capacity);
+    ~FrameArena() override;
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // The frame loop's arena (Settings::frameArenaBytes_ to start with)
+    static FrameArena& frame();
+
+    // Everything handed out becomes free again; also folds overflow blocks into one
+    void reset();
+
+    // Bytes in use now, at most this frame (since reset) and at most in any frame so far
+    size_t used() const { return usedBefore_ + offset_; }
+    size_t frameHighWater() const { return frameHighWater_; }
+    size_t highWater() const { return highWater_; }
+    size_t lastFrameBytes() const { return lastFrameBytes_; }
+    size_t capacity() const;
+    // Heap blocks taken after the first one (frames that didn't fit), over the arena's life
+    size_t overflowBlocks() const { return overflowBlocks_; }
+
+    // Hands back everything allocated from the arena during the scope
+    class Rewind {
+    public:
+        explicit Rewind(FrameArena& arena)
+            : arena_(arena), block_(arena.current_), offset_(arena.offset_), usedBefore_(arena.usedBefore_) {}
+        ~Rewind() {
+            arena_.current_ = block_;
+            arena_.offset_ = offset_;
+            arena_.usedBefore_ = usedBefore_;
+        }
+
+        Rewind(const Rewind&) = delete;
+        Rewind& operator=(const Rewind&) = delete;
+
+    private:
+        FrameArena& arena_;
+        size_t block_;
+        size_t offset_;
+        size_t usedBefore_;
+    };
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks_;
+    size_t current_{0};     // block being bumped
+    size_t offset_{0};      // into the current block
+    size_t usedBefore_{0};  // bytes handed out from the blocks before the current one
+    size_t frameHighWater_{0};
+    size_t highWater_{0};
+    size_t lastFrameBytes_{0};
+    size_t overflowBlocks_{0};
+};
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "AllocationTracker.hpp"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#ifndef BLOCKS_PROFILING
+#define BLOCKS_PROFILING 1
+#endif
+
+/**
+ * FrameProfiler: CPU time of named zones in the frame loop, kept for the last HistoryFrames frames.
+ * A zone is a scope: PROFILE_ZONE("collision") times the rest of the block it's in. Each frame keeps
+ * the summed time and call count per zone plus the individual zone events (start, length, nesting
+ * depth) for a timeline, in a fixed ring so nothing is allocated while running.
+ * Only the thread that runs the frame loop records (the first beginFrame() picks it); zones hit on
+ * worker threads are skipped. A zone costs two clock reads and a few stores, see zoneCostNs().
+ * With AllocationTracker compiled in, frames and zones also record the heap allocations the frame
+ * thread made inside them (a zone includes the zones nested in it, like its time).
+ * Built with BLOCKS_PROFILING=0 the PROFILE_* macros expand to nothing.
+ */
+class FrameProfiler {
+public:
+    using Clock = std::chrono::steady_clock;
+    using ZoneId = uint8_t;
+
+    static constexpr size_t MaxZones = 32;
+    static constexpr size_t HistoryFrames = 240;     // 4 s at 60 fps
+    static constexpr size_t MaxEventsPerFrame = 128; // timeline entries, later ones still count in the sums
+
+    struct Event {
+        ZoneId zone{0};
+        uint8_t depth{0};
+        float startMs{0.f}; // from the start of the frame
+        float durationMs{0.f};
+    };
+
+    struct Frame {
+        float frameMs{0.f}; // beginFrame() to endFrame()
+        std::array<float, MaxZones> zoneMs{};
+        std::array<uint16_t, MaxZones> zoneCalls{};
+        uint32_t allocations{0}; // whole frame
+        uint64_t allocatedBytes{0};
+        std::array<uint32_t, MaxZones> zoneAllocations{};
+        std::array<uint64_t, MaxZones> zoneAllocatedBytes{};
+        std::array<Event, MaxEventsPerFrame> events{};
+        uint16_t eventCount{0};
+    };
+
+    // Per-frame time of one zone over the history, frames it didn't run in left out
+    struct ZoneStats {
+        float lastMs{0.f};
+        float minMs{0.f};
+        float avgMs{0.f};
+        float p99Ms{0.f};
+        float avgAllocations{0.f}; // per frame it ran in
+        size_t frames{0};
+    };
+
+    class Zone {
+    public:
+        explicit Zone(ZoneId id) : id_(id) {
+            if (!t_frameThread || !s_enabled) return;
+            depth_ = s_depth++;
+            if constexpr (AllocationTracker::compiledIn) allocStart_ = AllocationTracker::thread();
+            start_ = Clock::now();
+            active_ = true;
+        }
+        ~Zone() {
+            if (!active_) return;
+            const auto end = Clock::now();
+            if constexpr (AllocationTracker::compiledIn) {
+                const auto allocEnd = AllocationTracker::thread();
+                record_(id_, depth_, start_, end,
+                        {allocEnd.allocations - allocStart_.allocations, allocEnd.bytes - allocStart_.bytes});
+            } else {
+                record_(id_, depth_, start_, end, AllocationTracker::Counts{});
+            }
+        }
+
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+
+    private:
+        ZoneId id_;
+        uint8_t depth_{0};
+        bool active_{false};
+        Clock::time_point start_;
+        AllocationTracker::Counts allocStart_{};
+    };
+
+    // Same name, same id. Thread safe; PROFILE_ZONE calls it once per call site
+    static ZoneId registerZone(const char* name);
+    static const char* zoneName(ZoneId id);
+    static size_t zoneCount();
+
+    static void beginFrame();
+    static void endFrame();
+    // Off: zones are skipped and the history stays as it is (pausing the panel)
+    static void setEnabled(bool enabled);
+    static bool enabled();
+
+    // Completed frames held, and one of them by age (0 = the last one)
+    static size_t frameCount();
+    static const Frame& frame(size_t age);
+    static ZoneStats stats(ZoneId id);
+
+    // Measured cost of one zone (enter + leave), for the overhead estimate
+    static double zoneCostNs();
+    // Forget the history (zone names stay registered)
+    static void reset();
+
+private:
+    static void record_(ZoneId id, uint8_t depth, Clock::time_point start, Clock::time_point end,
+                        const AllocationTracker::Counts& allocs);
+    static void calibrate_();
+
+    // Read on every zone, so inline here rather than behind a call
+    static inline thread_local bool t_frameThread{false};
+    static inline bool s_enabled{true};
+    static inline uint8_t s_depth{0};
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+#if BLOCKS_PROFILING
+#define PROFILE_ZONE(name)                                                                                      \
+    static const FrameProfiler::ZoneId PROFILE_CONCAT(profileZoneId_, __LINE__) = FrameProfiler::registerZone(name); \
+    const FrameProfiler::Zone PROFILE_CONCAT(profileZone_, __LINE__)(PROFILE_CONCAT(profileZoneId_, __LINE__))
+#define PROFILE_FRAME_BEGIN() FrameProfiler::beginFrame()
+#define PROFILE_FRAME_END() FrameProfiler::endFrame()
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_FRAME_BEGIN() ((void)0)
+#define PROFILE_FRAME_END() ((void)0)
+#endif
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <threepp/math/Vector3.hpp>
+#include <threepp/objects/Mesh.hpp>
+#include <threepp/textures/DataTexture.hpp>
+#include <threepp/materials/MeshBasicMaterial.hpp>
+#include <threepp/geometries/PlaneGeometry.hpp>
+#include <vector>
+#include <memory>
+#include "Settings.hpp"
+
+/**
+ * GroundImprintAtlas: persistent track history baked into a tiled texture on the ground plane.
+ * The atlas covers a fixed square around the origin and is split into tiles that are
+ * created the first time something is stamped on them. Every tile is its own small texture,
+ * so only the tiles stamped since the last flush get re-uploaded.
+ * Memory is bounded by the area covered, not by how far the excavator drives.
+ */
+class GroundImprintAtlas {
+public:
+    // ground: object the tiles get parented to (the ground plane, rotated flat onto XZ)
+    // halfExtent: atlas covers [-halfExtent, halfExtent] on both X and Z
+    GroundImprintAtlas(threepp::Object3D& ground, float halfExtent,
+                       float texelsPerMeter = Settings::imprintTexelsPerMeter_,
+                       int tileTexels = Settings::imprintTileTexels_);
+
+    // Darken an oriented rectangle (yaw around Y, width along local X, length along local Z)
+    void stamp(const threepp::Vector3& center, float yaw, float width, float length, float strength);
+
+    // Upload the tiles touched since the last flush (call once per frame)
+    void flush();
+
+    // Imprint darkness at a world position [0..1] (0 outside the atlas or on untouched ground)
+    float intensityAt(float x, float z) const;
+
+    // Forget all imprints (keeps the allocated tiles)
+    void clear();
+
+    size_t getTileCount() const { return allocatedTiles_; }
+    size_t getMaxTileCount() const { return tiles_.size(); }
+    size_t getDirtyTileCount() const { return dirtyTiles_.size(); }
+    size_t getMemoryBytes() const { return allocatedTiles_ * bytesPerTile(); }
+    size_t getMaxMemoryBytes() const { return tiles_.size() * bytesPerTile(); }
+
+private:
+    struct Tile {
+        std::vector<unsigned char> alpha;              // CPU copy of the imprint darkness
+        std::shared_ptr<threepp::DataTexture> texture; // RGBA, alpha channel = darkness
+        std::shared_ptr<threepp::Mesh> mesh;
+        bool dirty{false};
+    };
+
+    size_t bytesPerTile() const { return static_cast<size_t>(tileTexels_) * tileTexels_ * 5; } // alpha + RGBA
+    Tile& tileAt_(int tx, int tz);
+
+    threepp::Object3D& ground_;
+    float halfExtent_;
+    float texelsPerMeter_;
+    int tileTexels_;
+    int tilesPerSide_;
+    int texelsPerSide_;
+    size_t allocatedTiles_{0};
+
+    std::vector<Tile> tiles_;       // tilesPerSide_^2, row-major over (x, z)
+    std::vector<int> dirtyTiles_;   // indices into tiles_
+    std::shared_ptr<threepp::PlaneGeometry> tileGeometry_;
+};
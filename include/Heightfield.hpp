@@ -0,0 +1,86 @@
+#pragma once
+
+#include <threepp/math/Vector2.hpp>
+#include <threepp/math/Vector3.hpp>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "Settings.hpp"
+
+/**
+ * Heightfield: regular grid of soil heights over a square patch of ground (world space).
+ * Soil can only sit on or above the floor (the ground the patch lies on).
+ * Every sample stands for one spacing x spacing column, so volume() is exactly the
+ * sum of what excavate() took out and what deposit() put in.
+ * Edits mark fixed-size tiles dirty so a renderer only has to rebuild what changed.
+ */
+class Heightfield {
+public:
+    // center: middle of the patch on the floor, size: edge length in meters, resolution: samples per side
+    Heightfield(const threepp::Vector3& center, float size, int resolution,
+                int tileCells = Settings::heightfieldTileCells_);
+
+    int getResolution() const { return resolution_; }
+    float getSpacing() const { return spacing_; }
+    float getSize() const { return size_; }
+    float getFloor() const { return center_.y; }
+    const threepp::Vector3& getCenter() const { return center_; }
+
+    // Raw samples (i along X, j along Z), world Y
+    float sample(int i, int j) const { return heights_[static_cast<size_t>(j) * resolution_ + i]; }
+    float sampleClamped(int i, int j) const;
+    float sampleX(int i) const { return center_.x - size_ * 0.5f + i * spacing_; }
+    float sampleZ(int j) const { return center_.z - size_ * 0.5f + j * spacing_; }
+
+    // Bilinear surface height at a world position (floor outside the patch)
+    float heightAt(float x, float z) const;
+    bool contains(float x, float z) const;
+
+    // Overwrite every sample from a height function (world x, z) -> world y, marks everything dirty
+    void fill(const std::function<float(float, float)>& heightFn);
+
+    // Sweep a sphere of `radius` from `from` to `to` (the bucket) and take out the soil above it.
+    // Never removes more than maxVolume (m^3); returns what was actually removed.
+    float excavate(const threepp::Vector3& from, const threepp::Vector3& to, float radius, float maxVolume);
+
+    // Pour `volume` m^3 of soil onto (x, z). Loose soil comes to rest as a cone at the angle of repose
+    // draped over whatever is already there (the new surface is max(old, cone)), the apex height is
+    // solved so exactly `volume` is added. Returns the volume placed (0 if the point is off the patch).
+    float deposit(const threepp::Vector3& at, float volume, float reposeAngle = Settings::reposeAngle_);
+
+    // Back to bare floor everywhere (keeps the storage)
+    void clear();
+
+    // Soil above the floor in m^3
+    float volume() const;
+
+    // Outline of the soil above floor + minHeight, two points per grid row (XZ), for colliders
+    void footprint(std::vector<threepp::Vector2>& out, float minHeight = 0.05f) const;
+
+    // Dirty tiles since the last clearDirty()
+    int getTileCells() const { return tileCells_; }
+    int getTilesPerSide() const { return tilesPerSide_; }
+    const std::vector<int>& getDirtyTiles() const { return dirtyTiles_; }
+    void clearDirty();
+
+    // Mark the tiles whose vertices (or normals) depend on samples [i0..i1] x [j0..j1]
+    void markDirty(int i0, int j0, int i1, int j1);
+
+private:
+    float& at_(int i, int j) { return heights_[static_cast<size_t>(j) * resolution_ + i]; }
+    int toI_(float x) const; // nearest sample, may be out of range
+    int toJ_(float z) const;
+
+    threepp::Vector3 center_;
+    float size_;
+    int resolution_;
+    float spacing_;
+    int tileCells_;
+    int tilesPerSide_;
+
+    std::vector<float> heights_;
+    std::vector<int> scratchIndex_;     // samples touched by the current edit (reused, no per-call allocs)
+    std::vector<float> scratchAmount_;
+    std::vector<uint8_t> tileDirty_;
+    std::vector<int> dirtyTiles_;
+};
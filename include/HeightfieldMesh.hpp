@@ -0,0 +1,42 @@
+#pragma once
+
+#include <threepp/objects/Group.hpp>
+#include <threepp/objects/Mesh.hpp>
+#include <threepp/core/BufferGeometry.hpp>
+#include <threepp/materials/Material.hpp>
+#include <memory>
+#include <vector>
+#include "Heightfield.hpp"
+
+/**
+ * HeightfieldMesh: draws a Heightfield as a grid of tile meshes.
+ * Each tile owns a preallocated position/normal buffer. sync() only rewrites and re-uploads the
+ * tiles the heightfield marked dirty (positions and normals), so a scoop costs a few tiles, not the field.
+ * Vertices are relative to the field center: parent root() at Heightfield::getCenter().
+ * Bare floor is pushed just under the ground so the flat part of the patch doesn't z-fight with it.
+ */
+class HeightfieldMesh {
+public:
+    HeightfieldMesh(Heightfield& field, std::shared_ptr<threepp::Material> material);
+
+    std::shared_ptr<threepp::Group> root() const { return root_; }
+
+    // Rebuild dirty tiles and clear the field's dirty list, returns how many tiles were uploaded
+    size_t sync();
+
+    size_t getTileCount() const { return tiles_.size(); }
+
+private:
+    struct Tile {
+        int i0, j0;         // first sample of the tile
+        int cellsX, cellsZ; // edge tiles can be smaller
+        std::shared_ptr<threepp::BufferGeometry> geometry;
+        std::shared_ptr<threepp::Mesh> mesh;
+    };
+
+    void writeTile_(Tile& tile);
+
+    Heightfield& field_;
+    std::shared_ptr<threepp::Group> root_;
+    std::vector<Tile> tiles_;
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Settings.hpp"
+
+/**
+ * MaterialLedger: keeps track of where the soil is for productivity numbers.
+ * Everything the bucket carves out of a dig zone is recorded as dug and everything it releases
+ * over a dump zone as dumped, so dug == in bucket + dumped at all times.
+ * All counters are plain floats, reading them every frame costs nothing.
+ */
+class MaterialLedger {
+public:
+    // Advance the ledger clock (simulation seconds), decays the recent rate
+    void advance(float dt);
+
+    // Soil moved from a dig zone into the bucket (m^3)
+    void recordDug(float volume);
+    // Soil released from the bucket onto a dump zone (m^3), can't exceed what's in the bucket.
+    // Returns the volume actually booked.
+    float recordDumped(float volume);
+
+    float getDug() const { return dug_; }
+    float getDumped() const { return dumped_; }
+    float getInBucket() const { return dug_ - dumped_; }
+    float getElapsed() const { return elapsed_; }
+
+    // Dumped m^3 per hour over the whole session
+    float getProductivity() const;
+    // Dumped m^3 per hour over roughly the last Settings::productivityWindow_ seconds
+    float getRecentProductivity() const { return recentRate_ * 3600.f; }
+
+    void reset();
+
+private:
+    float dug_{0.f};
+    float dumped_{0.f};
+    float elapsed_{0.f};
+    float recentRate_{0.f}; // m^3/s, exponential moving average
+};
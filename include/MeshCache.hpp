@@ -0,0 +1,97 @@
+#pragma once
+
+#include <threepp/math/Vector2.hpp>
+#include <threepp/math/Vector3.hpp>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace threepp {
+    class Group;
+}
+
+/**
+ * MeshCache: OBJ models stored as a compact binary the second time round.
+ * The first load parses the OBJ text into plain arrays (no threepp objects, so it can run on any
+ * thread), welds each sub-mesh into indexed triangles and writes them out (positions, normals and
+ * uint32 indices as separate arrays, per-part bounds, the model's bounds and XZ hull). Later loads
+ * map that file in one go; each array is laid out the way threepp's attributes hold it, so a hit is
+ * one copy per attribute and toGroup() moves those into the geometry.
+ * A cache file is keyed by a hash of the OBJ (and its MTL when materials are loaded); a changed
+ * source, a different loader flag or a damaged file just falls back to parsing and rewrites it.
+ * Like OBJLoader there's one sub-mesh per group/object/material, so a group that switches material
+ * part way (usemtl, e.g. Gate.obj's black frame and gold film) keeps both colours. Materials keep the
+ * MTL diffuse colour only (the MTLs in models/ define nothing else).
+ */
+class MeshCache {
+public:
+    static constexpr uint32_t Version = 3;
+
+    struct Part {
+        std::string name;
+        std::array<float, 3> color{1.f, 1.f, 1.f}; // material diffuse
+        std::vector<float> positions;              // xyz per vertex
+        std::vector<float> normals;                // xyz per vertex, same count as positions
+        std::vector<uint32_t> indices;             // triangles
+        threepp::Vector3 boundsMin, boundsMax;
+
+        size_t vertexCount() const { return positions.size() / 3; }
+    };
+
+    struct MeshData {
+        std::vector<Part> parts;
+        threepp::Vector3 boundsMin, boundsMax;  // whole model, model space
+        std::vector<threepp::Vector2> hull;     // whole model XZ footprint (CCW), empty if it has no area
+    };
+
+    struct Model {
+        std::shared_ptr<threepp::Group> group; // null if the OBJ didn't load
+        threepp::Vector3 boundsMin, boundsMax;
+        std::vector<threepp::Vector2> hull;
+    };
+
+    struct Stats {
+        size_t hits{0};      // loads served from a cache file
+        size_t misses{0};    // loads that parsed the OBJ
+        double cacheMs{0.0}; // time spent in cache hits (hash + map + build)
+        double parseMs{0.0}; // time spent in misses (parse + weld + write)
+    };
+
+    // OBJ through the cache (Settings::meshCache_ off: plain OBJLoader, bounds and hull left empty)
+    static Model load(const std::string& objPath, bool loadMtl = false);
+    // The data half of load(): mapped from the cache or parsed and written. Safe off the main thread
+    static std::optional<MeshData> loadData(const std::string& objPath, bool loadMtl = false);
+    // The threepp half: scene objects from the data (main thread)
+    static Model toModel(MeshData data);
+
+    // OBJ (+ MTL diffuse colours) straight to mesh data, nullopt if there's nothing to load
+    static std::optional<MeshData> parseObj(const std::filesystem::path& path, bool loadMtl);
+
+    // FNV-1a over the file contents, 0 if it can't be read
+    static uint64_t hashFile(const std::filesystem::path& path);
+    // Cache key of an OBJ: its hash, folded with the MTL next to it and the loader flag
+    static uint64_t sourceKey(const std::filesystem::path& objPath, bool loadMtl);
+    // <meshCacheDir_>/<stem>-<hash of the canonical path>[.mtl].meshbin
+    static std::filesystem::path cachePathFor(const std::filesystem::path& objPath, bool loadMtl);
+
+    // Indexed part from triangle soup (or an indexed mesh), identical position + normal pairs are shared
+    static Part weld(const std::string& name, const std::array<float, 3>& color,
+                     const std::vector<float>& positions, const std::vector<float>& normals,
+                     const std::vector<uint32_t>& index = {});
+    // Part bounds, model bounds and hull from the parts' vertices
+    static void computeBounds(MeshData& data);
+
+    static bool write(const std::filesystem::path& path, const MeshData& data, uint64_t key);
+    // Memory-maps the file; nullopt if it's missing, for another key or not a valid cache file
+    static std::optional<MeshData> read(const std::filesystem::path& path, uint64_t key);
+
+    // Moves the parts' arrays into the geometry attributes
+    static std::shared_ptr<threepp::Group> toGroup(MeshData data);
+
+    static Stats getStats();
+    static void resetStats();
+};
@@ -4,32 +4,90 @@
 #include <vector>
 #include <memory>
 #include <random>
+#include "PropTemplate.hpp"
+
+class PoissonDiskSampler;
 
 /**
  * ObjectSpawner: Procedurally generates environment objects (rocks, debris, crates)
  * in a circular arena pattern for the excavator to interact with.
+ * Props are drawn per template, not per object: every sub-mesh of a prop model is one
+ * InstancedMesh holding all copies, so thousands of debris pieces are a handful of draw calls.
+ * Colliders reuse the template's XZ hull, moved/rotated/scaled per instance (no per-object hull).
+ * Placement is Poisson-disk sampled from randomSeed: per-class spacing, and nothing solid overlaps
+ * anything else solid or a keep-out area.
  */
 class ObjectSpawner {
 public:
+    // Circle on XZ that props stay out of (castle, dig/dump zones, excavator start)
+    struct KeepOut {
+        float x = 0.f, z = 0.f;
+        float radius = 0.f;
+    };
+
     struct SpawnConfig {
         float arenaRadius = 30.0f;          // Radius of circular spawn area
         int smallObjectCount = 100;         // Small debris (rocks, chunks)
         int mediumObjectCount = 30;         // Medium objects (barrels, crates)
         int largeObjectCount = 8;           // Large obstacles (boulders, blocks)
+        int railCount = 8;                  // Rails (models/rAIL.obj)
+        // Minimum distance between two props of one class (m), solid ones also never overlap
+        float smallSpacing = 0.3f;
+        float mediumSpacing = 3.0f;
+        float largeSpacing = 6.0f;
+        float railSpacing = 8.0f;
         unsigned int randomSeed = 12345;    // For reproducible generation
+        std::vector<KeepOut> keepOut;       // Areas left clear of props
+        bool perimeterWall = true;          // Ring of big rocks around the arena (off when the site goes on past it)
+    };
+
+    enum class PropClass { Debris, Crate, Boulder, Rail, PerimeterRock };
+
+    struct Prop {
+        PropClass type;
+        float x, z;     // ground position
+        float yaw;      // rotation around Y (radians)
+        float scale;    // template scale
+        float radius;   // footprint radius (m)
+        bool collides;
+    };
+
+    // What generateEnvironment put in the scene
+    struct PropStats {
+        size_t instances = 0; // props placed
+        size_t drawCalls = 0; // InstancedMeshes (one per template sub-mesh)
+        size_t colliders = 0; // template colliders registered
     };
 
     explicit ObjectSpawner(threepp::Scene& scene);
     ObjectSpawner(threepp::Scene& scene, const SpawnConfig& config);
 
-    // Generate and place all environment objects
+    // Generate and place all environment objects (again: replaces the previous props)
     void generateEnvironment();
 
+    // Ground plane built by generateEnvironment (null before that)
+    std::shared_ptr<threepp::Mesh> groundMesh() const { return ground_; }
+    float groundRadius() const { return config_.arenaRadius * 1.5f; }
+
+    const std::vector<Prop>& getProps() const { return props_; }
+    const PropStats& getPropStats() const { return stats_; }
+    const std::vector<std::shared_ptr<threepp::InstancedMesh>>& getPropMeshes() const { return propMeshes_; }
+
 private:
     void spawnGroundPlane_();
-    void spawnPerimeterRocks_();
+    void placePerimeterRocks_(const PropTemplate& rock, PoissonDiskSampler& sampler);
+    // Up to `count` props of one class out of the sampler; solid ones become obstacles for the next class
+    void scatterProps_(PropClass type, int count, const PropTemplate& tmpl, float minScale, float maxScale,
+                       float spacing, bool collides, PoissonDiskSampler& sampler);
+    void buildInstances_(const PropTemplate& tmpl, const std::vector<PropClass>& types);
+    void clearProps_();
 
     threepp::Scene& scene_;
     SpawnConfig config_;
     std::mt19937 rng_;
+    std::shared_ptr<threepp::Mesh> ground_;
+
+    std::vector<Prop> props_;
+    std::vector<std::shared_ptr<threepp::InstancedMesh>> propMeshes_;
+    PropStats stats_;
 };
@@ -3,20 +3,39 @@
 #include <threepp/threepp.hpp>
 #include <vector>
 #include <memory>
+#include <random>
 
 /**
  * ParticleSystem: Manages dust/dirt particles that spawn during excavator movement.
  * Particles fade out over a lifetime and are automatically cleaned up.
+ * Dead particles keep their mesh and material, hidden in the scene, and the next spawn reuses them
+ * (swapping in its shape), so once the pool has grown to the peak count spawning doesn't allocate.
+ * When a camera is attached, emitters far from it spawn less often, offscreen emitters
+ * don't spawn at all and distant particles are drawn as point sprites instead of meshes.
  */
 class ParticleSystem {
 public:
     struct Particle {
         std::shared_ptr<threepp::Mesh> mesh;
+        threepp::MeshBasicMaterial* material{nullptr}; // the mesh's own, for the fade
         float lifetime{0.0f};  // Time alive (seconds)
         float maxLifetime{1.0f}; // Time until fully transparent
     };
 
-    ParticleSystem(threepp::Scene& scene);
+    // Per-frame counters (refreshed by update)
+    struct Stats {
+        size_t simulated{0};       // particles alive and simulated
+        size_t rendered{0};        // particles drawn (meshes + sprites)
+        size_t sprites{0};         // particles drawn as point sprites
+        size_t culledSpawns{0};    // spawns skipped because the emitter was offscreen
+        size_t decimatedSpawns{0}; // spawns skipped by the distance rate reduction
+    };
+
+    // seed: jitter and shape choice, fixed for benchmarks/tests, random by default
+    ParticleSystem(threepp::Scene& scene, unsigned int seed = std::random_device{}());
+
+    // Camera used for LOD and culling (nullptr = full fidelity everywhere)
+    void setCamera(const threepp::Camera* camera);
 
     // Spawn a particle at a given position
     void spawnParticle(const threepp::Vector3& position);
@@ -26,18 +45,42 @@ public:
 
     // Get count for debugging
     size_t getActiveCount() const { return particles_.size(); }
-    
+
+    // Simulated vs rendered counts for the last update
+    const Stats& getStats() const { return stats_; }
+
     // Get all particles (for reset cleanup)
     const std::vector<Particle>& getParticles() const { return particles_; }
-    
+
     // Clear all particles
     void clearParticles();
 
+    // Hidden meshes waiting for reuse
+    size_t getPooledCount() const { return pool_.size(); }
+
 private:
+    void refreshFrustum_();
+    void release_(Particle& p);
+
     threepp::Scene& scene_;
     std::vector<Particle> particles_;
+    std::vector<Particle> pool_; // dead particles, meshes hidden in the scene
     std::shared_ptr<threepp::MeshBasicMaterial> particleMaterial_;
     std::shared_ptr<threepp::BufferGeometry> sphereGeometry_;
     std::shared_ptr<threepp::BufferGeometry> pyramidGeometry_;
     std::shared_ptr<threepp::BufferGeometry> boxGeometry_;
+
+    // LOD state
+    const threepp::Camera* camera_{nullptr};
+    threepp::Frustum frustum_;
+    float spawnCredit_{0.f}; // fractional spawns owed at reduced rates
+    std::mt19937 rng_;
+    Stats stats_;
+    size_t pendingCulled_{0};
+    size_t pendingDecimated_{0};
+
+    // Distant particles collapse into one preallocated point cloud
+    std::shared_ptr<threepp::Points> sprites_;
+    std::shared_ptr<threepp::BufferGeometry> spriteGeometry_;
+    size_t lastSpriteCount_{0};
 };
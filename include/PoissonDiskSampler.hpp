@@ -0,0 +1,52 @@
+#pragma once
+
+#include <threepp/math/Vector2.hpp>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/**
+ * PoissonDiskSampler: Bridson's algorithm over a disc centered on the origin (XZ, returned as Vector2 x,y).
+ * Every point is at least minDistance from every other one, and nothing is left that a new point could
+ * fit into. Points are found by trying `attempts` candidates in the ring [r, 2r] around a random active
+ * point; a background grid of r/sqrt(2) cells holds at most one point each, so a candidate only checks
+ * the 5x5 cells around it and the whole run is O(n).
+ * Obstacles (keep-out circles, things placed by an earlier pass) live in a coarse grid of their own.
+ * With a point budget (maxPoints) it stops once that many are placed; those start as darts thrown over
+ * the whole disc, so a partial set is spread over the region instead of grown around one spot.
+ * Same seed, same calls, same points.
+ */
+class PoissonDiskSampler {
+public:
+    struct Obstacle {
+        float x, z;
+        float radius;
+    };
+
+    PoissonDiskSampler(float regionRadius, unsigned int seed, int attempts = 30);
+
+    // Nothing generated afterwards comes closer than radius + its own pointRadius
+    void addObstacle(float x, float z, float radius);
+    void clearObstacles() { obstacles_.clear(); }
+    const std::vector<Obstacle>& getObstacles() const { return obstacles_; }
+
+    // Points of one class: >= minDistance apart, pointRadius fully inside the region and clear of obstacles.
+    // All that fit, or the first maxPoints (fewer only when the region is full)
+    std::vector<threepp::Vector2> generate(float minDistance, float pointRadius = 0.f, size_t maxPoints = SIZE_MAX);
+
+    float getRegionRadius() const { return regionRadius_; }
+
+private:
+    bool isBlocked_(float x, float z, float pointRadius) const;
+    void buildObstacleGrid_(float pointRadius);
+
+    float regionRadius_;
+    int attempts_;
+    std::mt19937 rng_;
+
+    std::vector<Obstacle> obstacles_;
+    // Coarse grid over the region: obstacle indices overlapping each cell (grown by the point radius)
+    float obstacleCell_{2.f};
+    int obstacleCells_{0};
+    std::vector<std::vector<int>> obstacleGrid_;
+};
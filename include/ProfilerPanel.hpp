@@ -0,0 +1,19 @@
+#pragma once
+
+/**
+ * ProfilerPanel: ImGui window over the FrameProfiler history.
+ * Frame time graph, a table of rolling min/avg/p99 per zone, and a timeline of one frame with
+ * nested zones stacked under their parents (pick the frame with the slider, pause to hold it).
+ * Also shows the frame arena's use and high water; builds with allocation tracking also get
+ * allocations per frame and per zone.
+ * Call draw() from inside the ImGui frame (the UI callback).
+ */
+class ProfilerPanel {
+public:
+    void draw();
+
+    bool visible{false};
+
+private:
+    int frameAge_{0}; // frame shown in the timeline, 0 = the last one
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <threepp/threepp.hpp>
+#include <memory>
+#include <vector>
+
+/**
+ * PropTemplate: one prop model ready to be drawn instanced.
+ * Geometry/material per sub-mesh plus the model's XZ footprint at scale 1, yaw 0 (for template colliders).
+ * Copies are placed with a ground position, a yaw and a uniform scale.
+ * Nothing changes after it's built, so background threads may read the footprint and matrices.
+ */
+struct PropTemplate {
+    std::vector<std::shared_ptr<threepp::BufferGeometry>> geometries;
+    std::vector<std::shared_ptr<threepp::Material>> materials;
+    std::vector<threepp::Matrix4> partMatrices; // sub-mesh relative to the template root
+    std::vector<threepp::Vector2> hull;         // XZ, CCW
+    float extent = 1.f;                         // footprint radius at scale 1
+    float lift = 0.f;                           // raise by lift * scale to sit on the ground
+
+    static PropTemplate loadRock(); // models/Rock2.obj, low-poly spheres if it doesn't load
+    static PropTemplate crate();
+    static PropTemplate loadRail(); // empty if the model doesn't load
+
+    bool empty() const { return geometries.empty(); }
+
+    // Hull and extent from the vertices of every sub-mesh
+    void computeFootprint();
+    // Footprint known up front (cached with the model), extent follows from it
+    void setHull(std::vector<threepp::Vector2> footprint);
+
+    // Matrix of one copy, multiply by partMatrices[i] for sub-mesh i
+    threepp::Matrix4 placement(float x, float z, float yaw, float scale) const;
+
+    // One InstancedMesh per sub-mesh with room for `count` copies
+    std::vector<std::shared_ptr<threepp::InstancedMesh>> createInstances(size_t count) const;
+};
@@ -53,9 +53,55 @@ namespace Settings {
     inline bool bucketUseMaxEnd_{false};
     inline float stickNudgeZ_{0.f}; // small offset to tweak position
     inline float bucketNudgeZ_{0.f};
+    inline int debugLineCapacity_{4096}; // collision debug line segments per buffer to start with, doubles when full
 
     inline bool bucketLoaded_{false}; // whether bucket has material (for dig/dump)
 
+    //-----------------------------------------
+    //----------Terrain / digging--------------
+    //-----------------------------------------
+    inline int heightfieldTileCells_{32};   // cells per terrain tile edge, tiles re-upload independently
+    inline int digFieldResolution_{128};    // samples per side of the dig pile heightfield
+    inline float bucketCarveRadius_{0.6f};  // sphere swept through the soil by the bucket (m)
+    inline float bucketCapacity_{1.5f};     // soil the bucket holds before it counts as loaded (m^3)
+    inline float reposeAngle_{0.6f};        // steepest stable soil slope (radians, ~34 degrees for loose dirt)
+    inline int dumpFieldResolution_{96};    // samples per side of the dump pile heightfield
+    inline float bucketMinFill_{0.6f};      // fraction of bucketCapacity_ kept with the bucket fully open (curl adds the rest)
+    inline float productivityWindow_{60.f}; // seconds the "recent" m^3/h figure averages over
+    inline float zoneCellSize_{8.f};        // grid cell edge for looking up dig/dump zones (m)
+
+    // Voxel soil mode (spill and overhangs around the bucket)
+    inline bool voxelSoilMode_{false};
+    inline float soilVoxelSize_{0.25f};     // voxel edge (m)
+    inline int soilCohesion_{3};            // full side neighbours needed to hold a voxel up (overhangs)
+    inline float soilSpillRate_{0.5f};      // fraction of a voxel that can slide off an edge per tick
+    inline int soilThreads_{0};             // solver threads, 0 = one per core
+    constexpr int MaxSoilVoxels = 32768;    // instanced cubes drawn for the voxel soil
+
+    //-----------------------------------------
+    //----------World streaming----------------
+    //-----------------------------------------
+    inline bool worldStreaming_{false};       // big site around the arena, streamed in chunks (read at startup)
+    inline float chunkSize_{32.f};            // chunk edge (m)
+    inline int chunkLoadRadius_{3};           // chunks kept loaded around the excavator (circle, in chunks)
+    inline float siteRadius_{2000.f};         // nothing is generated past this (m)
+    inline int chunkIntegrationsPerFrame_{2}; // finished chunks added to the scene per frame (spreads the uploads)
+
+    //-----------------------------------------
+    //----------Asset loading------------------
+    //-----------------------------------------
+    inline bool meshCache_{true};                  // load OBJs through the binary mesh cache
+    inline const char* meshCacheDir_{"mesh_cache"}; // cache files, relative to the working directory
+    inline unsigned assetLoaderThreads_{0};         // startup loader workers, 0 = one per core but the main thread
+
+    //-----------------------------------------
+    //----------Profiling----------------------
+    //-----------------------------------------
+    inline bool startupReport_{true};                          // write the startup phase report at the first frame
+    inline const char* startupReportJson_{"startup_profile.json"}; // this run, overwritten
+    inline const char* startupReportCsv_{"startup_history.csv"};   // one row per phase per run, appended
+    inline int frameArenaBytes_{256 * 1024};                   // per-frame scratch arena to start with, grows to fit the biggest frame
+
     //------------------------------------------------
     //----------Excavator movement variables----------
     //------------------------------------------------
@@ -74,6 +120,13 @@ namespace Settings {
     inline constexpr float particleSpawnInterval_{0.05f}; // spawn every 50ms when moving
     inline constexpr float speedThresholdForParticles_{0.3f}; // min speed to spawn particles
 
+    // Camera distance LOD for particles (meters from the camera)
+    inline float particleLodNear_{12.f};        // full spawn rate inside this distance
+    inline float particleLodFar_{35.f};         // spawn rate bottoms out at this distance
+    inline float particleLodMinRate_{0.25f};    // fraction of spawns kept at/after the far distance
+    inline float particleSpriteDistance_{20.f}; // beyond this particles are drawn as point sprites
+    constexpr int MaxParticleSprites = 512;     // size of the preallocated sprite buffer
+
     //-----------------------------------------
     //----------Audio system settings----------
     //-----------------------------------------
@@ -84,10 +137,14 @@ namespace Settings {
     //----------Coin variables----------
     //----------------------------------
     inline int collectedCount_ = 0;
-    // Coin animation tuning (per-coin state lives in Coin now)
+    // Coin animation tuning (fed to the instanced coin shader as uniforms)
     inline float rotationSpeed_ = 1.5f; // slower spin
     inline float bobHeight_ = 0.4f;     // slightly lower amplitude
     inline float bobSpeed_ = 1.2f;      // much slower bob
+    inline float coinCellSize_ = 4.f;   // spatial hash cell edge (meters), about the pickup diameter
+
+    // Gameplay events (coin/dig/dump), per consumer queue length
+    constexpr int EventQueueCapacity = 256; // power of two
 
     //----------------------------------------
     //----------Track mark variables----------
@@ -98,4 +155,15 @@ namespace Settings {
     inline float markWidth_ = 0.25f;    // default individual track imprint width 
     inline float markLength_ = 0.25f;   // default imprint length along travel 
     inline float trackSeparation_ = 1.0f; // distance between track centers
+    constexpr int MaxTrackMarks = 1024;   // ring buffer size (oldest marks get overwritten)
+
+    // Persistent imprints stamped into the ground atlas (outlive the decals above)
+    inline float imprintTexelsPerMeter_ = 8.f; // atlas resolution
+    inline int imprintTileTexels_ = 64;        // tile edge in texels, tiles upload independently
+    inline float imprintStrength_ = 0.35f;     // how much one pass darkens the ground [0..1]
+
+    // Traffic heatmap (where the machines drive the most)
+    inline int heatmapResolution_ = 128;       // cells per side over the ground plane
+    inline float heatmapSampleDistance_ = 0.25f; // meters driven per recorded sample
+    inline bool showHeatmap_ = false;          // overlay toggle in the UI
 }
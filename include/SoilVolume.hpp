@@ -0,0 +1,143 @@
+#pragma once
+
+#include <threepp/math/Vector3.hpp>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "Settings.hpp"
+
+class Heightfield;
+
+/**
+ * SoilVolume: sparse voxel soil for the bucket/soil interaction the heightfield can't do
+ * (spill off the bucket edge, overhangs that crumble).
+ * Voxels hold a fill fraction [0..1] and live in 8x8x8 bricks that are only allocated where there is soil.
+ * step() moves soil down (and diagonally down off edges, 45 degree slopes), voxels held by enough full
+ * neighbours stay put, so undercut soil hangs for a bit and collapses from the corners in.
+ * Only bricks where something moved (or that received soil, or touch the bucket) are updated, settled
+ * soil costs nothing. Bricks are processed in 8 parity passes on a worker pool: bricks in one pass are
+ * two apart, so their +-1 voxel neighbourhoods never overlap. Results don't depend on the thread count.
+ * The pool's threads start with the first step that has work to split, so a volume that is never
+ * stepped (voxel mode left off) costs no threads.
+ * Soil is only ever moved, never created or lost (totalSoil() stays the same).
+ */
+class SoilVolume {
+public:
+    static constexpr int BrickSize = 8;
+    static constexpr int BrickVoxels = BrickSize * BrickSize * BrickSize;
+
+    // origin: world position of voxel (0,0,0)'s min corner, its y is the floor. threads: 0 = one per core
+    explicit SoilVolume(const threepp::Vector3& origin, float voxelSize = Settings::soilVoxelSize_,
+                        int threads = Settings::soilThreads_);
+    ~SoilVolume();
+
+    SoilVolume(const SoilVolume&) = delete;
+    SoilVolume& operator=(const SoilVolume&) = delete;
+
+    float getVoxelSize() const { return voxelSize_; }
+    const threepp::Vector3& getOrigin() const { return origin_; }
+    // Threads step() uses (the calling one included), whether or not the pool has started yet
+    int getThreadCount() const { return threadCount_; }
+    // Pool threads running now: none until a step had work to split
+    int getStartedWorkerCount() const { return static_cast<int>(workers_.size()); }
+
+    // Voxel fill at integer voxel coords (y >= 0 is above the floor), 0 where nothing is allocated
+    float voxel(int x, int y, int z) const;
+    void setVoxel(int x, int y, int z, float fill);
+    threepp::Vector3 voxelCenter(int x, int y, int z) const;
+
+    // Soil columns under a heightfield (e.g. a DigZone pile), replaces nothing, adds on top of what's there
+    void fillFromHeightfield(const Heightfield& field);
+    void clear();
+
+    // The bucket as a moving boundary: soil inside the sphere is pushed up out of it, and nothing
+    // falls into it while it's there. Call every frame with the bucket's current bounds.
+    void setBoundary(const threepp::Vector3& center, float radius);
+    void clearBoundary();
+
+    // One simulation tick, returns the number of bricks updated
+    size_t step();
+
+    // Total soil in m^3 (sum of fill x voxel volume)
+    float totalSoil() const;
+    size_t getBrickCount() const { return bricks_.size(); }
+    size_t getActiveBrickCount() const { return active_.size(); }
+    // Bumped whenever soil moved, for renderers
+    uint64_t getRevision() const { return revision_; }
+
+    // Calls fn(x, y, z, fill) for every voxel with soil
+    template<class Fn>
+    void forEachVoxel(Fn&& fn) const {
+        for (const auto& brick : bricks_) {
+            for (int i = 0; i < BrickVoxels; ++i) {
+                const float fill = brick->fill[i];
+                if (fill <= 0.f) continue;
+                fn(brick->bx * BrickSize + (i % BrickSize),
+                   brick->by * BrickSize + (i / BrickSize) % BrickSize,
+                   brick->bz * BrickSize + i / (BrickSize * BrickSize), fill);
+            }
+        }
+    }
+
+private:
+    struct Brick {
+        int bx, by, bz;
+        std::array<float, BrickVoxels> fill{};  // x fastest, then y, then z
+        std::array<Brick*, 27> neighbors{};      // (dx+1) + 3(dy+1) + 9(dz+1), refreshed before each step
+        std::array<uint64_t, BrickVoxels / 64> held{}; // voxels cohesion keeps up this step
+        std::atomic<uint8_t> woken{0};           // received soil from a neighbour this step
+        bool active{false};
+        float moved{0.f};
+    };
+
+    using BrickKey = uint64_t;
+    static BrickKey key_(int bx, int by, int bz);
+    Brick* find_(int bx, int by, int bz) const;
+    Brick& getOrCreate_(int bx, int by, int bz);
+    void activate_(Brick& brick);
+    void activateAround_(const threepp::Vector3& center, float radius); // voxel units
+
+    void markHeld_(Brick& brick);
+    void updateBrick_(Brick& brick);
+    bool blocked_(int x, int y, int z) const;
+
+    // Worker pool: runs job(i) for i in [0, count) on all threads, returns when all are done
+    void parallelFor_(size_t count, const std::function<void(size_t)>& job);
+    void startWorkers_();
+    void workerLoop_();
+    void runJobs_();
+
+    threepp::Vector3 origin_;
+    float voxelSize_;
+
+    std::vector<std::unique_ptr<Brick>> bricks_;
+    std::unordered_map<BrickKey, Brick*> lookup_;
+    std::vector<Brick*> active_;
+    std::vector<Brick*> previousActive_; // reused between steps
+    std::array<std::vector<Brick*>, 8> passes_;
+    uint64_t revision_{0};
+
+    bool hasBoundary_{false};
+    threepp::Vector3 boundaryCenter_; // in voxel units
+    float boundaryRadius_{0.f};
+
+    int threadCount_;
+    std::vector<std::thread> workers_; // threadCount_ - 1 once started
+    std::mutex poolMutex_;
+    std::condition_variable poolCv_;
+    std::condition_variable doneCv_;
+    std::atomic<const std::function<void(size_t)>*> job_{nullptr};
+    std::atomic<size_t> jobCount_{0};
+    std::atomic<size_t> nextJob_{0};
+    std::atomic<size_t> doneJobs_{0};
+    uint64_t generation_{0};
+    int busy_{0};
+    bool stop_{false};
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <threepp/objects/InstancedMesh.hpp>
+#include <threepp/materials/Material.hpp>
+#include <cstdint>
+#include <memory>
+#include "SoilVolume.hpp"
+#include "Settings.hpp"
+
+/**
+ * SoilVolumeMesh: draws a SoilVolume as instanced cubes (one draw call), voxels at least half full.
+ * sync() only rewrites the instance matrices when the volume's revision changed, slots that were
+ * used last time but not anymore are collapsed to zero scale. Capped at `capacity` cubes.
+ */
+class SoilVolumeMesh {
+public:
+    SoilVolumeMesh(const SoilVolume& volume, std::shared_ptr<threepp::Material> material,
+                   size_t capacity = Settings::MaxSoilVoxels);
+
+    std::shared_ptr<threepp::InstancedMesh> mesh() const { return mesh_; }
+
+    // Returns true if the instances were rewritten
+    bool sync();
+    size_t getDrawnCount() const { return drawn_; }
+
+private:
+    const SoilVolume& volume_;
+    std::shared_ptr<threepp::InstancedMesh> mesh_;
+    size_t capacity_;
+    size_t drawn_{0};
+    uint64_t revision_{~uint64_t{0}};
+};
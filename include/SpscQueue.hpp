@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * SpscQueue: fixed-size lock-free ring for exactly one producer thread and one consumer thread.
+ * Head and tail live on separate cache lines and each side caches the other's index, so the
+ * common case of push/pop touches no shared line at all.
+ * Capacity must be a power of two. Full queue -> tryPush returns false (caller decides what to drop).
+ */
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    // Producer side
+    bool tryPush(const T& item) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tailCache_ == Capacity) {
+            tailCache_ = tail_.load(std::memory_order_acquire);
+            if (head - tailCache_ == Capacity) return false;
+        }
+        slots_[head & kMask] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool tryPop(T& out) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == headCache_) {
+            headCache_ = head_.load(std::memory_order_acquire);
+            if (tail == headCache_) return false;
+        }
+        out = slots_[tail & kMask];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Only exact when neither side is running
+    size_t sizeApprox() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+    bool empty() const { return sizeApprox() == 0; }
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    static constexpr size_t kMask = Capacity - 1;
+
+    alignas(64) std::atomic<size_t> head_{0}; // next slot to write (producer)
+    size_t tailCache_{0};                     // producer's last view of tail_
+    alignas(64) std::atomic<size_t> tail_{0}; // next slot to read (consumer)
+    size_t headCache_{0};                     // consumer's last view of head_
+    alignas(64) std::array<T, Capacity> slots_{};
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/**
+ * StartupProfiler: wall and CPU time of each startup phase, written out as a report that can be
+ * compared build to build (JSON for the last run, one CSV row per phase appended per run).
+ * main() steps through its top-level phases with phase(); code further down (the excavator, the
+ * spawner) opens nested ones with a Scope, named after the phase they run in ("excavator/load").
+ * CPU time is the main thread's own, so a phase that mostly waits (the loading screen while the
+ * workers parse) shows a low CPU time next to its wall time.
+ * Nothing is recorded until begin() is called, so tests and tools that build the same objects pay
+ * nothing. Main thread only.
+ */
+class StartupProfiler {
+public:
+    struct Phase {
+        std::string name;  // nested phases: "parent/child"
+        int depth{0};
+        double startMs{0.0}; // since program start
+        double wallMs{0.0};
+        double cpuMs{0.0};
+    };
+
+    // Nested phase for the lifetime of the object (no-op when the profiler isn't running)
+    class Scope {
+    public:
+        explicit Scope(const std::string& name);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        size_t index_{SIZE_MAX}; // own phase, SIZE_MAX when not recording
+    };
+
+    // Start recording; phase times count from programStart
+    static void begin(std::chrono::steady_clock::time_point programStart);
+    // Close the open top-level phase (and anything left inside it) and start the next one
+    static void phase(const std::string& name);
+    // Close everything and stop recording; the total is taken here
+    static void finish();
+    static bool running();
+
+    static std::vector<Phase> phases();
+    static double totalWallMs();
+    static double totalCpuMs();
+
+    // Fixed format (3 decimals, phases in start order) so two reports diff cleanly
+    static std::string toJson(const std::string& build);
+    // Header: build,timestamp,phase,depth,wall_ms,cpu_ms. One row per phase plus a "total" row
+    static std::string toCsvRows(const std::string& build, bool withHeader);
+    static bool writeJson(const std::filesystem::path& path, const std::string& build);
+    // Appends this run to a history file, the header is only written to a new file
+    static bool appendCsv(const std::filesystem::path& path, const std::string& build);
+
+    // CPU time used by the calling thread so far
+    static double threadCpuMs();
+
+private:
+    struct Open {
+        size_t index; // into s_phases
+        double cpuStart;
+    };
+
+    static void open_(const std::string& name);
+    static void close_();
+
+    static bool s_running;
+    static std::chrono::steady_clock::time_point s_programStart;
+    static double s_cpuStart;
+    static double s_totalWallMs;
+    static double s_totalCpuMs;
+    static std::string s_timestamp;
+    static std::vector<Phase> s_phases;
+    static std::vector<Open> s_open; // innermost last
+};
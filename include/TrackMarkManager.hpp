@@ -2,12 +2,22 @@
 
 #include <threepp/scenes/Scene.hpp>
 #include <threepp/objects/Mesh.hpp>
-#include <threepp/geometries/PlaneGeometry.hpp>
-#include <threepp/materials/MeshStandardMaterial.hpp>
+#include <threepp/core/BufferGeometry.hpp>
+#include <threepp/materials/ShaderMaterial.hpp>
 #include <vector>
 #include <memory>
 #include "Settings.hpp"
+#include "GroundImprintAtlas.hpp"
+#include "TrafficHeatmap.hpp"
 
+/**
+ * TrackMarkManager: leaves track imprints behind the excavator.
+ * All marks live in one preallocated ring buffer of quads (a single draw call).
+ * Each vertex stores its spawn time and the fade is done in the shader, so there is
+ * no per-frame CPU work per mark; the oldest quads simply get overwritten.
+ * Optionally every mark is also stamped into a persistent ground atlas (see GroundImprintAtlas)
+ * and the path driven is sampled into a traffic heatmap.
+ */
 class TrackMarkManager {
 public:
     explicit TrackMarkManager(threepp::Scene& scene);
@@ -19,15 +29,47 @@ public:
     void setSpawnDistance(float d) { Settings::spawnDistance_ = d; }
     void setLifetime(float seconds) { Settings::lifetime_ = seconds; }
 
-private:
-    struct Mark {
-        std::shared_ptr<threepp::Mesh> mesh;
-        float timeRemaining;
-    };
+    // Number of marks that are still visible (diagnostics/tests, walks the ring)
+    size_t getMarkCount() const;
+
+    // Capacity of the ring buffer (in marks, two per spawn)
+    size_t getCapacity() const { return capacity_; }
+
+    // The ring's geometry (diagnostics/tests: inspect what gets uploaded)
+    std::shared_ptr<threepp::BufferGeometry> getGeometry() const { return geometry_; }
+
+    // Hide every mark (e.g. on game reset). Persistent imprints are kept.
+    void clear();
+
+    // Persistent mode: also stamp every mark into a tiled texture on the ground plane
+    // halfExtent: the atlas covers [-halfExtent, halfExtent] on X and Z
+    void enablePersistentGround(threepp::Object3D& ground, float halfExtent);
+    GroundImprintAtlas* persistentGround() { return imprints_.get(); }
 
+    // Count every heatmapSampleDistance_ the excavator drives into this heatmap writer (nullptr to stop)
+    void setHeatmapWriter(TrafficHeatmap::Writer* writer) { heatmap_ = writer; }
+
+private:
     threepp::Scene& scene_;
-    std::vector<Mark> marks_;
     threepp::Vector3 lastSpawnPos_{};
     bool hasSpawnedFirst_ = false;
+    threepp::Vector3 lastFramePos_{}; // for the heatmap, which samples the path driven
+    float heatmapDistance_{0.f};      // driven since the last heatmap sample
+
+    // Ring buffer of quads in one dynamic geometry
+    size_t capacity_;
+    size_t head_{0};    // next quad slot to overwrite
+    size_t dirtyStart_{0}; // first quad written since the last upload
+    size_t dirtyCount_{0}; // quads written since the last upload (capped at capacity_)
+    float time_{0.f};   // local clock fed to the shader
+    std::shared_ptr<threepp::BufferGeometry> geometry_;
+    std::shared_ptr<threepp::ShaderMaterial> material_;
+    std::shared_ptr<threepp::Mesh> mesh_;
+
+    std::unique_ptr<GroundImprintAtlas> imprints_; // null unless persistent mode is on
+    TrafficHeatmap::Writer* heatmap_{nullptr};     // owned by the TrafficHeatmap
+
     void spawnMark(const threepp::Vector3& pos, const threepp::Vector3& forwardDir);
+    void writeQuad_(const threepp::Vector3& center, float yaw, float width, float length);
+    void uploadWrittenQuads_();
 };
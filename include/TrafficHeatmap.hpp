@@ -0,0 +1,78 @@
+#pragma once
+
+#include <threepp/math/Vector3.hpp>
+#include <threepp/objects/Mesh.hpp>
+#include <threepp/textures/DataTexture.hpp>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Settings.hpp"
+
+/**
+ * TrafficHeatmap: how often machines have been on each patch of ground (a proxy for soil compaction).
+ * Fixed resolution grid over XZ, recording a position is a single integer increment.
+ * Every excavator (or thread) records into its own Writer grid so nothing is shared while driving;
+ * the grids are only summed when somebody reads the map (overlay refresh, export, queries).
+ */
+class TrafficHeatmap {
+public:
+    // One grid per producer. Only the owning thread may call record().
+    class Writer {
+    public:
+        // O(1): bump the cell under pos (positions outside the map are ignored)
+        void record(const threepp::Vector3& pos);
+
+    private:
+        friend class TrafficHeatmap;
+        explicit Writer(const TrafficHeatmap& owner);
+
+        const TrafficHeatmap& owner_;
+        // Single writer, so load+store is enough; atomics just keep concurrent reads clean
+        std::vector<std::atomic<uint32_t>> cells_;
+    };
+
+    // halfExtent: map covers [-halfExtent, halfExtent] on X and Z, resolution: cells per side
+    explicit TrafficHeatmap(float halfExtent, int resolution = Settings::heatmapResolution_);
+
+    // Thread safe. The returned writer lives as long as the heatmap.
+    Writer& createWriter();
+
+    // Sum of all writers, row-major (row 0 at the +Z edge like the ground textures)
+    std::vector<uint64_t> merged() const;
+    uint64_t countAt(float x, float z) const;
+    uint64_t totalSamples() const;
+
+    // Zero every writer (not safe while writers are recording)
+    void clear();
+
+    int getResolution() const { return resolution_; }
+    float getHalfExtent() const { return halfExtent_; }
+    float getCellSize() const { return cellSize_; }
+    size_t getWriterCount() const;
+
+    // Flat overlay above the ground showing the merged map; refreshOverlay() re-merges and re-uploads
+    std::shared_ptr<threepp::Mesh> overlay();
+    void refreshOverlay();
+
+    // CSV: "x,z,count" per cell (cell centers in meters)
+    // Binary: "HEAT", uint32 version, int32 resolution, float halfExtent, resolution^2 uint64 counts
+    bool exportCsv(const std::filesystem::path& path) const;
+    bool exportBinary(const std::filesystem::path& path) const;
+
+private:
+    int cellIndex_(float x, float z) const; // -1 outside the map
+
+    float halfExtent_;
+    int resolution_;
+    float cellSize_;
+
+    mutable std::mutex writersMutex_;        // guards the writer list, never the counts
+    std::deque<std::unique_ptr<Writer>> writers_;
+
+    std::shared_ptr<threepp::DataTexture> overlayTexture_;
+    std::shared_ptr<threepp::Mesh> overlayMesh_;
+};
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <threepp/threepp.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "CollisionWorld.hpp"
+#include "ObjectSpawner.hpp"
+#include "PropTemplate.hpp"
+#include "Settings.hpp"
+
+/**
+ * WorldStreamer: a job site far bigger than the arena, kept in memory a few chunks at a time.
+ * The XZ plane is cut into square chunks; the ones within loadRadius chunks of the focus (the excavator)
+ * are resident, anything past loadRadius + 1 is dropped again (the extra ring stops chunks flickering
+ * in and out at a border). A chunk's content only depends on the seed and its coordinates, so leaving
+ * and coming back gives the same props.
+ * A background thread samples the props (Poisson-disk, per chunk) and computes the instance matrices;
+ * every request carries the chunk's generation, so a chunk dropped before the worker gets to it is
+ * skipped rather than generated, and a result for an older copy of a chunk is never shown;
+ * update() on the main thread only adds finished chunks to the scene (a few per frame) and registers
+ * their colliders by handle. Resident chunks, meshes and colliders are bounded by the load radius,
+ * not by the size of the site.
+ */
+class WorldStreamer {
+public:
+    struct Config {
+        float chunkSize = Settings::chunkSize_;
+        int loadRadius = Settings::chunkLoadRadius_;
+        float siteRadius = Settings::siteRadius_;   // nothing is generated past this (m)
+        unsigned int seed = 12345;
+        int debrisPerChunk = 150;
+        int cratesPerChunk = 4;
+        int bouldersPerChunk = 2;
+        std::vector<ObjectSpawner::KeepOut> keepOut; // e.g. the hand-built arena
+        std::shared_ptr<threepp::Material> groundMaterial; // chunk ground tiles, plain dirt if null
+    };
+
+    struct Stats {
+        size_t resident = 0;  // chunks in the scene
+        size_t pending = 0;   // chunks requested or being generated
+        size_t instances = 0; // props in resident chunks
+        size_t drawCalls = 0; // meshes in resident chunks (ground tiles + instanced props)
+        size_t colliders = 0; // colliders registered by resident chunks
+        size_t loaded = 0;    // chunks brought in so far
+        size_t unloaded = 0;  // chunks dropped so far
+        size_t generated = 0; // chunks the worker sampled (requests dropped before it got to them don't count)
+    };
+
+    WorldStreamer(threepp::Object3D& parent, const Config& config);
+    ~WorldStreamer();
+
+    WorldStreamer(const WorldStreamer&) = delete;
+    WorldStreamer& operator=(const WorldStreamer&) = delete;
+
+    // Once per frame: drop far chunks, request near ones, add up to maxIntegrations finished ones
+    void update(const threepp::Vector3& focus, int maxIntegrations = Settings::chunkIntegrationsPerFrame_);
+    // Block until every requested chunk is generated and in the scene (loading screens, tests)
+    void finishLoading();
+
+    int chunkOf(float v) const;
+    bool isResident(int cx, int cz) const;
+    const Stats& getStats() const { return stats_; }
+    // Most chunks that can be resident at once for this load radius
+    size_t getMaxResidentChunks() const;
+
+private:
+    using ChunkKey = int64_t;
+    static ChunkKey key_(int cx, int cz) { return (static_cast<int64_t>(cx) << 32) ^ static_cast<uint32_t>(cz); }
+
+    // One prop kind the worker fills chunks with
+    struct PropKind {
+        size_t tmpl; // index into templates_
+        int count;
+        float minScale, maxScale;
+        float spacing;
+        bool collides;
+    };
+
+    struct Placement {
+        float x, z, yaw, scale;
+        bool collides;
+    };
+
+    // A chunk to generate, for the generation it was asked for in
+    struct Request {
+        int cx, cz;
+        uint64_t generation;
+    };
+
+    // Worker output: everything the main thread needs to show a chunk
+    struct ChunkData {
+        int cx, cz;
+        uint64_t generation;
+        std::vector<std::vector<Placement>> placements{}; // per template
+        std::vector<std::vector<threepp::Matrix4>> matrices{}; // per template, instance-major then sub-mesh
+    };
+
+    struct Chunk {
+        int cx, cz;
+        uint64_t generation{0}; // new every time the chunk is asked for
+        bool resident{false};   // false while the worker still has it
+        std::vector<std::shared_ptr<threepp::Object3D>> meshes{};
+        std::vector<CollisionWorld::ColliderHandle> colliders{};
+        size_t instances{0};
+    };
+
+    ChunkData generate_(const Request& request) const;
+    void integrate_(ChunkData& data);
+    void integrateReady_(size_t maxCount);
+    void unload_(Chunk& chunk);
+    void workerLoop_();
+
+    threepp::Object3D& parent_;
+    Config config_;
+    std::vector<PropTemplate> templates_; // rock, crate
+    std::vector<PropKind> kinds_;         // boulders, crates, debris (big to small)
+    std::shared_ptr<threepp::BufferGeometry> tileGeometry_;
+    std::shared_ptr<threepp::Material> tileMaterial_;
+
+    std::unordered_map<ChunkKey, Chunk> chunks_;
+    Stats stats_;
+
+    // Worker: requests_ in, ready_ out, all guarded by mutex_.
+    // wanted_ is the generation each requested chunk is wanted in, the worker checks it instead of chunks_
+    std::thread worker_;
+    std::mutex mutex_;
+    std::condition_variable workCv_;
+    std::condition_variable idleCv_;
+    std::deque<Request> requests_;
+    std::vector<ChunkData> ready_;
+    std::unordered_map<ChunkKey, uint64_t> wanted_;
+    uint64_t nextGeneration_{1};
+    size_t generated_{0};
+    bool busy_{false};
+    bool stop_{false};
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <threepp/math/Vector3.hpp>
+#include <threepp/core/Object3D.hpp>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "CollisionWorld.hpp"
+#include "DigZone.hpp"
+#include "DumpZone.hpp"
+#include "Settings.hpp"
+
+/**
+ * ZoneManager: owns every dig (stockpile) and dump (loading point) zone on the site.
+ * Zones are bucketed in a uniform XZ grid by their radius, so "which zone is the bucket in"
+ * only tests the zones registered in the bucket's cell: O(1) no matter how many sites there are.
+ * Each dig zone gets a CollisionWorld handle. Carving through the manager keeps the collider
+ * hull, the visibility (dug out piles disappear) and the terrain mesh up to date.
+ */
+class ZoneManager {
+public:
+    using ZoneId = int;
+
+    explicit ZoneManager(threepp::Object3D& parent, float cellSize = Settings::zoneCellSize_);
+    ~ZoneManager();
+
+    ZoneManager(const ZoneManager&) = delete;
+    ZoneManager& operator=(const ZoneManager&) = delete;
+
+    ZoneId addDigZone(const threepp::Vector3& position, float radius, int resolution = Settings::digFieldResolution_);
+    ZoneId addDumpZone(const threepp::Vector3& position, float radius);
+
+    // Zone containing the point (bucket position), -1 if none. Dug out piles don't count.
+    ZoneId findDigZone(const threepp::Vector3& point) const;
+    ZoneId findDumpZone(const threepp::Vector3& point) const;
+
+    DigZone& getDigZone(ZoneId id) { return *digZones_[id].zone; }
+    DumpZone& getDumpZone(ZoneId id) { return *dumpZones_[id]; }
+    size_t getDigZoneCount() const { return digZones_.size(); }
+    size_t getDumpZoneCount() const { return dumpZones_.size(); }
+
+    // Carve a dig zone (see DigZone::excavate), its collider and visibility follow in update()
+    float excavate(ZoneId id, const threepp::Vector3& from, const threepp::Vector3& to, float radius, float capacity);
+    bool isDepleted(ZoneId id) const { return digZones_[id].depleted; }
+    CollisionWorld::ColliderHandle getCollider(ZoneId id) const { return digZones_[id].collider; }
+
+    // Once per frame: refit the colliders of carved piles and upload changed terrain tiles
+    void update();
+
+    // Every pile back to full size, dump piles cleared, colliders and visuals restored
+    void reset();
+
+private:
+    struct DigEntry {
+        std::unique_ptr<DigZone> zone;
+        CollisionWorld::ColliderHandle collider{CollisionWorld::InvalidCollider};
+        bool changed{false};
+        bool depleted{false};
+    };
+
+    // Zones overlapping a grid cell, dig ids are stored as is, dump ids as ~id
+    using CellKey = int64_t;
+    CellKey key_(int cx, int cz) const { return (static_cast<int64_t>(cx) << 32) ^ static_cast<uint32_t>(cz); }
+    int cell_(float v) const;
+    void insert_(const threepp::Vector3& position, float radius, int entry);
+    void syncCollider_(DigEntry& entry);
+
+    threepp::Object3D& parent_;
+    float cellSize_;
+    std::vector<DigEntry> digZones_;
+    std::vector<std::unique_ptr<DumpZone>> dumpZones_;
+    std::unordered_map<CellKey, std::vector<int>> cells_;
+    std::vector<threepp::Vector2> footprint_; // reused for collider refits
+};
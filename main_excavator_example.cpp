@@ -2,39 +2,61 @@
 #include <iostream>
 #include <fstream>
 #include <cmath>
+#include <algorithm>
 
 #include "World.hpp"
 #include "Renderer.hpp"
 #include "Excavator.hpp"
 #include "ObjectSpawner.hpp"
+#include "WorldStreamer.hpp"
 #include "ParticleSystem.hpp"
 #include "CollisionWorld.hpp"
+#include "DebugDraw.hpp"
 #include "DigZone.hpp"
 #include "DumpZone.hpp"
+#include "ZoneManager.hpp"
+#include "SoilVolume.hpp"
+#include "SoilVolumeMesh.hpp"
 #include "AudioManager.hpp"
 #include "CoinManager.hpp"
+#include "EventStream.hpp"
 #include "TrackMarkManager.hpp"
-// Load external models
-#include <threepp/loaders/OBJLoader.hpp>
+#include "TrafficHeatmap.hpp"
+#include "MaterialLedger.hpp"
+#include "MeshCache.hpp"
+#include "AssetRegistry.hpp"
+#include "AsyncLoader.hpp"
+#include "StartupProfiler.hpp"
+#include "AllocationTracker.hpp"
+#include "FrameArena.hpp"
+#include "FrameProfiler.hpp"
+#include "ProfilerPanel.hpp"
 #include <threepp/audio/Audio.hpp>
 #include <threepp/objects/Text.hpp>
 #include <filesystem>
+#include <chrono>
 #include "threepp/extras/imgui/ImguiContext.hpp"
+#include "build_id.h" // BLOCKS_BUILD_ID, the git hash, regenerated on every build
 
 using namespace threepp;
 
 int main() {
     std::ofstream logFile("run.log", std::ios::app);
     logFile << "[start] program begin" << std::endl;
+    const auto startupBegin = std::chrono::steady_clock::now();
+    StartupProfiler::begin(startupBegin);
     try {
+        StartupProfiler::phase("canvas");
         Canvas::Parameters params;
         params.title("Blocks Excavator").size(1280, 720).vsync(true).resizable(true);
         Canvas canvas(params);
         logFile << "[init] canvas created" << std::endl;
+    StartupProfiler::phase("renderer");
     Renderer renderer(canvas);
     logFile << "[init] renderer constructed" << std::endl;
     renderer.setClearColor(Color(0.5f, 0.7f, 1.0f));
 
+    StartupProfiler::phase("world");
     World world;
     logFile << "[init] world constructed" << std::endl;
 
@@ -47,18 +69,6 @@ int main() {
     directionalLight->castShadow = true;
     world.scene().add(directionalLight);
 
-    // --- Setup Environment ---
-    ObjectSpawner::SpawnConfig spawnConfig;
-    spawnConfig.arenaRadius = 30.0f;
-    spawnConfig.smallObjectCount = 100;
-    spawnConfig.mediumObjectCount = 30;
-    spawnConfig.largeObjectCount = 8;
-    
-    ObjectSpawner spawner(world.scene(), spawnConfig);
-    logFile << "[init] spawner constructed" << std::endl;
-    spawner.generateEnvironment();
-    logFile << "[init] environment generated" << std::endl;
-
     // Asset path resolver (works from build dirs too)
     auto resolveAssetPath = [](const std::string& rel) -> std::string {
         using std::filesystem::exists;
@@ -87,6 +97,90 @@ int main() {
     excavatorPaths.arm2        = resolveAssetPath("models/Arm2.obj");
     excavatorPaths.bucket      = resolveAssetPath("models/Bucket.obj");
 
+    // --- Startup assets ---
+    StartupProfiler::phase("assets"); // mostly the loading screen, the main thread waits on the workers
+    // Models load on worker threads while the main thread shows a loading screen.
+    // The scene below is built once they're all in, from AssetRegistry hits.
+    AsyncLoader loader(startupBegin);
+    for (const auto* path : {&excavatorPaths.leftTrack0, &excavatorPaths.leftTrack1, &excavatorPaths.leftTrack2,
+                             &excavatorPaths.rightTrack0, &excavatorPaths.rightTrack1, &excavatorPaths.rightTrack2,
+                             &excavatorPaths.base, &excavatorPaths.body, &excavatorPaths.arm1,
+                             &excavatorPaths.arm2, &excavatorPaths.bucket}) {
+        loader.requestModel(*path); // the right track asks for the left track's files again, loaded once
+    }
+    const std::vector<std::string> castlePartNames = {"WallLeft", "WallRight", "WallBack", "DoorLeft", "DoorRight"};
+    for (const auto& name : castlePartNames) loader.requestModel(resolveAssetPath("models/" + name + ".obj"), true);
+    loader.requestModel(resolveAssetPath("models/Rock2.obj"), true);
+    loader.requestModel(resolveAssetPath("models/rAIL.obj"), true);
+
+    {
+        // Loading screen: a progress bar over the sky
+        Scene loadingScene;
+        OrthographicCamera loadingCamera(-1, 1, 1, -1, 0, 1);
+        auto barGeometry = PlaneGeometry::create(1, 0.04f);
+        barGeometry->translate(0.5f, 0, 0); // grows to the right
+        auto barMaterial = MeshBasicMaterial::create();
+        barMaterial->color.setRGB(0.9f, 0.68f, 0.14f); // excavator yellow
+        auto bar = Mesh::create(barGeometry, barMaterial);
+        bar->position.set(-0.6f, 0, -0.5f);
+        loadingScene.add(bar);
+
+        while (!loader.done()) {
+            const bool open = canvas.animateOnce([&] {
+                loader.poll(4); // a few models per frame, their scene objects are made here
+                bar->scale.x = std::max(0.01f, 1.2f * loader.progress());
+                renderer.render(loadingScene, loadingCamera);
+                loader.markFrame();
+            });
+            if (!open) {
+                logFile << "[end] window closed while loading" << std::endl;
+                return 0;
+            }
+        }
+    }
+    const auto loadStats = loader.getStats();
+    logFile << "[init] assets loaded (" << loadStats.finished << " jobs)" << std::endl;
+
+    // --- Setup Environment ---
+    StartupProfiler::phase("spawner");
+    ObjectSpawner::SpawnConfig spawnConfig;
+    spawnConfig.arenaRadius = 30.0f;
+    spawnConfig.smallObjectCount = 100;
+    spawnConfig.mediumObjectCount = 30;
+    spawnConfig.largeObjectCount = 8;
+    spawnConfig.railCount = 8;
+    // Keep the start, the castle, the dig pile in its doorway and the dump zone clear of props
+    const Vector3 castlePos{0, 0, 18};
+    const float doorwayOffsetWorld = 2.3f;
+    const Vector3 dumpPos{10, 0, -10};
+    spawnConfig.keepOut = {
+        {0.f, 0.f, 4.f},
+        {castlePos.x, castlePos.z, 8.f},
+        {castlePos.x, castlePos.z - doorwayOffsetWorld, 4.f},
+        {dumpPos.x, dumpPos.z, 4.f}
+    };
+    spawnConfig.perimeterWall = !Settings::worldStreaming_; // the site goes on past the arena
+    
+    ObjectSpawner spawner(world.scene(), spawnConfig);
+    logFile << "[init] spawner constructed" << std::endl;
+    spawner.generateEnvironment();
+    logFile << "[init] environment generated" << std::endl;
+
+    // Big site around the arena, streamed in chunks around the excavator
+    std::unique_ptr<WorldStreamer> streamer;
+    if (Settings::worldStreaming_) {
+        StartupProfiler::phase("streamer");
+        WorldStreamer::Config streamConfig;
+        streamConfig.seed = spawnConfig.randomSeed;
+        streamConfig.keepOut = {{0.f, 0.f, spawner.groundRadius()}}; // the arena is hand-built
+        streamConfig.groundMaterial = spawner.groundMesh()->material();
+        streamer = std::make_unique<WorldStreamer>(world.scene(), streamConfig);
+        streamer->update(Vector3(0, 0, 0));
+        streamer->finishLoading(); // the first ring is there before the first frame
+        logFile << "[init] world streamer constructed" << std::endl;
+    }
+
+    StartupProfiler::phase("excavator");
     Excavator excavator(excavatorPaths, world.scene());
     logFile << "[init] excavator constructed" << std::endl;
 
@@ -94,15 +188,15 @@ int main() {
     excavator.root()->position.set(0, 0, 0);
     
     // --- Particle System ---
+    StartupProfiler::phase("particles");
     ParticleSystem particleSystem(world.scene());
     logFile << "[init] particleSystem constructed" << std::endl;
     excavator.setParticleSystem(&particleSystem);
     
     // --- Castle + Doorway Pile ---
+    StartupProfiler::phase("castle");
     // --- Load Castle ---
-    const Vector3 castlePos{0, 0, 18};
     const float castleScale = 0.03f;
-    const float doorwayOffsetWorld = 2.3f;
     
     // Helper to align castle to ground
     auto alignToGround = [](std::shared_ptr<Object3D> obj) {
@@ -113,16 +207,14 @@ int main() {
         if (bmin.y != 0.f) obj->position.y -= bmin.y;
     };
     
-    OBJLoader loader;
     std::shared_ptr<Object3D> castle;
     Vector3 pilePos;
     
     // Try loading split wall/door parts, instead of a single model so that i dont need to worry about being able to drive through an empty model ( was air colliding)
-    std::vector<std::string> partNames = {"WallLeft", "WallRight", "WallBack", "DoorLeft", "DoorRight"};
     std::vector<std::shared_ptr<Object3D>> loadedParts;
-    for (const auto& name : partNames) {
+    for (const auto& name : castlePartNames) {
         try {
-            auto part = loader.load(resolveAssetPath("models/" + name + ".obj"), true);
+            auto part = AssetRegistry::load(resolveAssetPath("models/" + name + ".obj"), true).group;
             if (part) loadedParts.push_back(part);
         } catch (...) {}
     }
@@ -145,13 +237,14 @@ int main() {
         pilePos = castle->position + toCenter * doorwayOffsetWorld;
         
         world.scene().add(castle);
+        StartupProfiler::Scope hulls("hulls");
         for (auto& child : castle->children) {
             if (child) CollisionWorld::addRockMeshColliderFromObject(*child);
         }
     } else {
         // Fallback: single Castle.obj with no-collision doorway zone
         try {
-            castle = loader.load(resolveAssetPath("models/Castle.obj"), true);
+            castle = AssetRegistry::load(resolveAssetPath("models/Castle.obj"), true).group;
             castle->position.copy(castlePos);
             castle->scale.setScalar(castleScale);
             castle->rotation.set(threepp::math::PI * 1.5f, 0.f, threepp::math::PI / 2.0f);
@@ -162,7 +255,10 @@ int main() {
             pilePos = castle->position + toCenter * doorwayOffsetWorld;
             
             world.scene().add(castle);
-            CollisionWorld::addRockMeshColliderFromObject(*castle);
+            {
+                StartupProfiler::Scope hulls("hulls");
+                CollisionWorld::addRockMeshColliderFromObject(*castle);
+            }
             
             // Add doorway pass-through zone
             CollisionWorld::NoCollisionZone doorZone{
@@ -177,62 +273,33 @@ int main() {
         }
     }
 
-    // --- Place Rails around perimeter for the (assorted objects requirenmetn) ---
-    {
-        auto railPath = resolveAssetPath("models/rAIL.obj");
-        std::cout << "Loading rail from " << railPath << " (with .mtl)..." << std::endl;
-        
-        OBJLoader loader;
-        auto railTemplate = loader.load(railPath, true);
-        
-        if (railTemplate) {
-            std::cout << "Rail template loaded successfully!" << std::endl;
-            
-            // Place 8 rails around the perimeter in a circle cus i cant be bothered to fix them spawning inside other models
-            const int railCount = 8;
-            const float railRadius = 20.0f; // Closer to center cus they were clipping in da rocks
-            const float angleOffset = 22.5f * (threepp::math::PI / 180.0f); // Offset by 22.5 degrees so they dont look boring
-            
-            for (int i = 0; i < railCount; i++) {
-                float angle = (i / float(railCount)) * 2.0f * threepp::math::PI + angleOffset;
-                
-                auto rail = railTemplate->clone();
-                
-                // Scale rail appropriately
-                rail->scale.setScalar(0.04f);
-                
-                // Rotate rail to stand upright (idk but everything seems to be the wrong way round)
-                rail->rotation.x = -threepp::math::PI / 2.0f; // Stand upright (flipped)
-                rail->rotation.z = angle; // Align with circle tangent
-                
-                rail->updateMatrixWorld(true);
-                
-                // Position on the plane surface
-                rail->position.x = railRadius * std::cos(angle);
-                rail->position.y = 0.0f; // On the ground
-                rail->position.z = railRadius * std::sin(angle);
-                
-                std::cout << "Placed rail " << i << " at (" << rail->position.x << ", " << rail->position.y << ", " << rail->position.z << ")" << std::endl;
-                
-                world.scene().add(rail);
-                CollisionWorld::addRockMeshColliderFromObject(*rail);
-            }
-            
-            std::cout << "Placed " << railCount << " rails around perimeter" << std::endl;
-        } else {
-            std::cout << "Failed to load rail model" << std::endl;
-        }
-    }
-
+    // Dig and dump sites (the manager adds visuals and pile colliders to the scene)
+    StartupProfiler::phase("zones");
+    ZoneManager zones(world.scene());
     // Place the dig pile at the doorway position
-    DigZone digZone(pilePos, 3.0f);
+    zones.addDigZone(pilePos, 3.0f);
     logFile << "[init] digZone constructed" << std::endl;
-    world.scene().add(digZone.getVisual());
-    CollisionWorld::addRockMeshColliderFromObject(*digZone.getVisual());
-    
-    DumpZone dumpZone(Vector3(10, 0, -10), 3.0f);
+    zones.addDumpZone(dumpPos, 3.0f);
     logFile << "[init] dumpZone constructed" << std::endl;
-    world.scene().add(dumpZone.getVisual());
+
+    // Voxel soil mode: the pile as voxels the bucket pushes around (spill, overhangs), off by default
+    SoilVolume soil(pilePos);
+    auto soilMaterial = MeshPhongMaterial::create();
+    soilMaterial->color = Color(0.6f, 0.4f, 0.2f); // same dirt as the pile
+    SoilVolumeMesh soilMesh(soil, soilMaterial);
+    soilMesh.mesh()->visible = false;
+    world.scene().add(soilMesh.mesh());
+    // Swap the first pile between its heightfield and voxels
+    auto applySoilMode = [&] {
+        if (Settings::voxelSoilMode_) {
+            soil.clear();
+            soil.fillFromHeightfield(zones.getDigZone(0).getHeightfield());
+        } else {
+            soil.clearBoundary();
+        }
+        zones.getDigZone(0).getVisual()->visible = !Settings::voxelSoilMode_ && !zones.isDepleted(0);
+        soilMesh.mesh()->visible = Settings::voxelSoilMode_;
+    };
     
     std::cout << "Excavator root has " << excavator.root()->children.size() << " children\n";
     
@@ -244,10 +311,12 @@ int main() {
     }
 
     // --- Camera ---
+    StartupProfiler::phase("scene setup");
     PerspectiveCamera camera(60, canvas.aspect(), 0.1, 1000);
     // Start camera behind excavator
     camera.position.set(-5, 5, -5);
     camera.lookAt(0, 0, 0);
+    particleSystem.setCamera(&camera); // distance LOD + offscreen culling for dust
 
     Clock clock;
 
@@ -275,11 +344,14 @@ int main() {
 
     // Debug collision visualization cus im stil colliding w air
     bool showCollisionDebug = false;
-    std::vector<std::shared_ptr<Object3D>> debugObjects;
+    DebugDraw debugDraw(world.scene());
+    debugDraw.setVisible(false);
 
     // Digging state
     int digScoops = 0;
-    bool pileGone = false;
+    MaterialLedger ledger;            // dug/dumped m^3 and productivity
+    Vector3 prevBucketPos;            // last frame's bucket position, the carve sweeps from here
+    bool hasPrevBucketPos = false;
 
     // --- Fade overlay for reset transition ---
     bool isResetting = false;
@@ -302,12 +374,13 @@ int main() {
     overlayScene.add(overlayMesh);
 
     // --- Audio System ---
+    StartupProfiler::phase("audio");
     AudioListener audioListener;
     camera.add(audioListener); // Attach listener to camera
     AudioManager audioManager(audioListener);
     logFile << "[init] audioManager constructed" << std::endl;
     
-    // Load sound files
+    // Load sound files (synchronously: threepp's Audio opens and decodes from a path on the main thread)
     audioManager.loadStartupSound(resolveAssetPath("models/startExcavator.wav"));
     audioManager.loadIdleSound(resolveAssetPath("models/idleExcavator.wav"));
     audioManager.loadHydraulicsSound(resolveAssetPath("models/hydraulicsExcavator.wav"));
@@ -318,30 +391,98 @@ int main() {
     audioManager.startEngine();
     std::cout << "[audio] Engine startup sequence initiated" << std::endl;
 
+    // --- Gameplay events ---
+    StartupProfiler::phase("coins");
+    // Sim publishes coin/dig/dump events, audio and UI each drain their own queue
+    EventStream gameEvents;
+    auto& audioEvents = gameEvents.subscribe();
+    auto& uiEvents = gameEvents.subscribe();
+    int uiCoinsCollected = 0;
+    int uiDigs = 0;
+    int uiDumps = 0;
+
     // --- Coin System ---
     CoinManager coinManager(world.scene());
+    coinManager.setEventStream(&gameEvents);
     logFile << "[init] coinManager constructed" << std::endl;
     coinManager.spawnCoins(15, spawnConfig.arenaRadius); // 15 coins scattered around
 
     // --- Track marks ---
+    StartupProfiler::phase("track marks");
     TrackMarkManager trackMarks(world.scene());
     logFile << "[init] trackMarks constructed" << std::endl;
     // Spawn marks 1.5x quicker: reduce distance (0.6 / 1.5 ≈ 0.4)
     trackMarks.setSpawnDistance(0.4f);
     trackMarks.setLifetime(3.f);       // disappear after 3 seconds they kinda look invisible before that but whatever
+    // Keep a faint permanent history baked into the ground texture (bounded by arena size)
+    if (auto ground = spawner.groundMesh()) {
+        trackMarks.enablePersistentGround(*ground, spawner.groundRadius());
+    }
+
+    // --- Traffic heatmap (compaction planning) ---
+    StartupProfiler::phase("heatmap");
+    // Each excavator gets its own writer, the map is merged only when drawn or exported
+    TrafficHeatmap heatmap(spawner.groundRadius());
+    trackMarks.setHeatmapWriter(&heatmap.createWriter());
+    world.scene().add(heatmap.overlay());
+    float heatmapRefreshTimer = 0.f;
 
     // --- ImGui UI  ---
+    StartupProfiler::phase("ui");
+    ProfilerPanel profilerPanel;
     ImguiFunctionalContext ui(canvas.windowPtr(), [&] {
         ImGui::SetNextWindowPos({0, 0}, 0, {0, 0});
-        ImGui::SetNextWindowSize({690, 120}, 0); // reduced height cus i just have 2 thingys in ther rn
+        ImGui::SetNextWindowSize({690, streamer ? 305.f : 275.f}, 0);
         ImGui::Begin("Excavator UI");
         ImGui::SetWindowFontScale(1.5f); // Increase text size
-        ImGui::Text("Coins collected: %d", coinManager.getCollectedCount());
+        // Counters are built from the event stream, not by polling the sim
+        GameEvent event;
+        while (uiEvents.poll(event)) {
+            switch (event.type) {
+                case GameEventType::CoinCollected: uiCoinsCollected++; break;
+                case GameEventType::Dig: uiDigs++; break;
+                case GameEventType::Dump: uiDumps++; break;
+                case GameEventType::Reset: uiCoinsCollected = uiDigs = uiDumps = 0; break;
+            }
+        }
+        ImGui::Text("Coins collected: %d   Scoops: %d   Dumps: %d", uiCoinsCollected, uiDigs, uiDumps);
+        ImGui::Text("Soil moved: %.1f m3 (%.1f in bucket)   %.0f m3/h (last min %.0f)",
+                    ledger.getDumped(), ledger.getInBucket(), ledger.getProductivity(), ledger.getRecentProductivity());
+        const auto& particleStats = particleSystem.getStats();
+        ImGui::Text("Particles: %zu simulated / %zu rendered (%zu sprites)",
+                    particleStats.simulated, particleStats.rendered, particleStats.sprites);
+        const auto& propStats = spawner.getPropStats();
+        ImGui::Text("Props: %zu instances in %zu draw calls (%zu colliders)",
+                    propStats.instances, propStats.drawCalls, propStats.colliders);
+        if (streamer) {
+            const auto& streamStats = streamer->getStats();
+            ImGui::Text("Chunks: %zu loaded, %zu loading, %zu props, %zu colliders",
+                        streamStats.resident, streamStats.pending, streamStats.instances, streamStats.colliders);
+        }
         ImGui::SliderFloat("Master Volume", &masterVolume, 0.f, 1.f);
         if (ImGui::IsItemEdited()) {
             audioListener.setMasterVolume(masterVolume);
         }
+        if (ImGui::Checkbox("Traffic heatmap", &Settings::showHeatmap_)) {
+            heatmap.overlay()->visible = Settings::showHeatmap_;
+            heatmap.refreshOverlay();
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Export heatmap")) {
+            const bool ok = heatmap.exportCsv("traffic_heatmap.csv") && heatmap.exportBinary("traffic_heatmap.bin");
+            std::cout << (ok ? "[heatmap] exported traffic_heatmap.csv/.bin" : "[heatmap] export failed") << std::endl;
+        }
+        if (ImGui::Checkbox("Voxel soil", &Settings::voxelSoilMode_)) applySoilMode();
+        if (Settings::voxelSoilMode_) {
+            ImGui::SameLine();
+            ImGui::Text("%zu/%zu bricks active", soil.getActiveBrickCount(), soil.getBrickCount());
+        }
+#if BLOCKS_PROFILING
+        ImGui::SameLine();
+        ImGui::Checkbox("Frame profiler", &profilerPanel.visible);
+#endif
         ImGui::End();
+        profilerPanel.draw();
     });
     // Capture mouse so camera orbit doesn't move while interacting with UI cus it was pissing me off
     IOCapture imguiCapture{};
@@ -361,36 +502,27 @@ int main() {
     auto performReset = [&]() {
         std::cout << "Performing reset..." << std::endl;
         
-        // Clear particles
+        // Clear particles and track marks
         particleSystem.clearParticles();
+        trackMarks.clear();
         
-        // Clear debug objects
-        for (auto& obj : debugObjects) {
-            if (obj) {
-                world.scene().remove(*obj);
-            }
-        }
-        debugObjects.clear();
+        // Clear debug lines
+        debugDraw.clear();
+        debugDraw.setVisible(false);
         showCollisionDebug = false;
         
+        // Reset zones (dug out piles come back with their colliders)
+        zones.reset();
+        applySoilMode();
+        
         // Reset gameplay counters
         digScoops = 0;
-        pileGone = false;
-        
-        // Re-add dig pile visual if it was removed
-        auto pileVisual = digZone.getVisual();
-        if (pileVisual && !pileVisual->parent) {
-            world.scene().add(pileVisual);
-        }
-        
-        // Reset zones
-        digZone.reset();
-        CollisionWorld::updateLastRockMeshColliderFromObject(*digZone.getVisual());
-        dumpZone.reset();
+        ledger.reset();
+        hasPrevBucketPos = false;
         
-        // Reset coins
+        // Reset coins (same pool, new spots)
         coinManager.reset();
-        coinManager.spawnCoins(15, spawnConfig.arenaRadius);
+        gameEvents.publish(GameEventType::Reset, Vector3());
         
         // Reset excavator
         excavator.reset();
@@ -505,10 +637,22 @@ int main() {
     CameraOrbitListener orbitListener(isMouseButtonDown, lastMousePos, cameraAngleH, cameraAngleV);
     canvas.addMouseListener(orbitListener);
 
+    // Shared geometry/materials: what's held vs what a copy per use would take
+    const auto assets = AssetRegistry::report();
+    logFile << "[assets] " << assets.models << " models (" << assets.modelRefs << " loads), "
+            << assets.geometries << " geometries (" << assets.geometryRefs << " refs), "
+            << assets.materials << " materials (" << assets.materialRefs << " refs), "
+            << assets.uniqueBytes / 1024 << " KB held vs " << assets.referencedBytes / 1024 << " KB unshared" << std::endl;
+
     // --- Animate ---
+    StartupProfiler::phase("first frame");
     logFile << "[loop] starting animate" << std::endl;
+    // Count heap allocations from here on (builds with -DBLOCKS_ALLOC_TRACKING=ON), per frame and zone in the profiler
+    AllocationTracker::setEnabled(AllocationTracker::compiledIn);
     canvas.animate([&] {
+        PROFILE_FRAME_BEGIN();
         float dt = clock.getDelta();
+        gameEvents.advanceClock(dt);
 
         // --- Handle reset fade animation ---
         if (isResetting) {
@@ -608,72 +752,133 @@ int main() {
         updateJoint(yDown && !rDown && !tDown, hDown && !fDown && !gDown, 0.5f, bucketAngle, prevBucketAngle,
                    [&](float a) { excavator.setBucketAngle(a); }, 0.25f, 0.22f);
 
-        // Update excavator (track animation)
-        excavator.update(dt);
+        // Update excavator (track animation, collision)
+        {
+            PROFILE_ZONE("excavator");
+            excavator.update(dt);
+        }
+
+        // Stream chunks in ahead of the excavator and drop the ones behind it
+        if (streamer) {
+            PROFILE_ZONE("streaming");
+            streamer->update(excavator.root()->position);
+        }
         
         // Update track marks before coin collection (uses excavator position)
-        trackMarks.update(dt, excavator.root()->position);
+        {
+            PROFILE_ZONE("track marks");
+            trackMarks.update(dt, excavator.root()->position);
+        }
+
+        // Re-merge the heatmap a couple of times a second while it's on screen
+        if (Settings::showHeatmap_) {
+            heatmapRefreshTimer += dt;
+            if (heatmapRefreshTimer >= 0.5f) {
+                heatmap.refreshOverlay();
+                heatmapRefreshTimer = 0.f;
+            }
+        }
 
         // Update & collect coins
-        coinManager.update(dt);
-        Vector3 excavatorPos = excavator.root()->position;
-        if (coinManager.checkCollection(excavatorPos, 3.0f)) {
-            audioManager.playCoin();
+        {
+            PROFILE_ZONE("coins");
+            coinManager.update(dt);
+            Vector3 excavatorPos = excavator.root()->position;
+            coinManager.checkCollection(excavatorPos, 3.0f); // publishes CoinCollected events
         }
         
         // Update particle system
-        particleSystem.update(dt);
+        {
+            PROFILE_ZONE("particles");
+            particleSystem.update(dt);
+        }
+        ledger.advance(dt);
         
         // --- Dig/Dump Gameplay Logic ---
-        Vector3 bucketPos = excavator.getBucketWorldPosition();
+        {
+            PROFILE_ZONE("zones");
+            Vector3 bucketPos = excavator.getBucketWorldPosition();
         
-        // Check if bucket is in dig zone and not loaded
-        if (!pileGone && !excavator.isBucketLoaded() && digZone.isInZone(bucketPos)) {
-            excavator.loadBucket();
-            // Shrink the dig pile a bit and update its collider hull
-            // Aim for ~5 scoops to nearly clear the pile (down to ~5% scale)(maybe lower 5 is a bit many whem its driving this painfully slow, idek tho looks unnatural)
-            // Slightly faster: ~5 scoops target, a touch stronger than 0.20
-            // f=0.21 => per-scoop scale=0.79, volume factor ≈ 0.79^3 ≈ 0.493
-            const float digFraction = 0.21f;
-            if (digZone.dig(digFraction)) {
-                CollisionWorld::updateLastRockMeshColliderFromObject(*digZone.getVisual());
+            // Check if bucket is in dig zone and not loaded
+            // The bucket carves the pile along its path since last frame until it holds a full load
+            if (!hasPrevBucketPos) {
+                prevBucketPos = bucketPos;
+                hasPrevBucketPos = true;
             }
-            
-            digScoops++;
-            if (digScoops >= 5 && !pileGone) {
-                pileGone = true;
-                // Remove visual and collider so the pile fully disappears
-                world.scene().remove(*digZone.getVisual());
-                CollisionWorld::popLastRockMeshCollider();
+            const ZoneManager::ZoneId digSite =
+                (excavator.isBucketLoaded() || Settings::voxelSoilMode_) ? -1 : zones.findDigZone(bucketPos);
+            if (digSite >= 0) {
+                // Whatever the pile loses goes into the bucket, how much fits depends on the curl
+                const float capacity = excavator.getBucketCapacity();
+                const float removed = zones.excavate(digSite, prevBucketPos, bucketPos, Settings::bucketCarveRadius_,
+                                                     std::max(0.0f, capacity - excavator.getBucketVolume()));
+                excavator.addToBucket(removed);
+                ledger.recordDug(removed);
+
+                // Close enough to full (the last bits only come off a little at a time)
+                if (excavator.getBucketVolume() >= capacity * 0.95f) {
+                    excavator.loadBucket();
+                    gameEvents.publish(GameEventType::Dig, bucketPos);
+                    digScoops++;
+                }
             }
-        }
+            prevBucketPos = bucketPos;
+
+            // Voxel soil: the bucket is a moving boundary, only bricks around it and falling soil get simulated
+            if (Settings::voxelSoilMode_ && excavator.bucketMesh()) {
+                Box3 bucketBox;
+                bucketBox.setFromObject(*excavator.bucketMesh());
+                Vector3 center, size;
+                bucketBox.getCenter(center);
+                bucketBox.getSize(size);
+                soil.setBoundary(center, 0.5f * std::min({size.x, size.y, size.z}));
+                soil.step();
+                soilMesh.sync();
+            }
+
+            // Refit carved pile colliders (dug out piles vanish) and upload only the carved terrain tiles
+            zones.update();
         
-        // Check if bucket is in dump zone and loaded
-        if (excavator.isBucketLoaded() && dumpZone.isInZone(bucketPos)) {
-            excavator.unloadBucket();
-            dumpZone.recordDump();
+            // Check if bucket is in a dump zone and loaded
+            const ZoneManager::ZoneId dumpSite = excavator.isBucketLoaded() ? zones.findDumpZone(bucketPos) : -1;
+            if (dumpSite >= 0) {
+                const float dumped = ledger.recordDumped(excavator.unloadBucket());
+                zones.getDumpZone(dumpSite).recordDump(bucketPos, dumped); // heaps up where the bucket opened
+                gameEvents.publish(GameEventType::Dump, bucketPos);
+            }
+        }
+
+        // Audio consumer: one coin sound per batch no matter how many were grabbed this frame
+        {
+            bool coinThisFrame = false;
+            GameEvent event;
+            while (audioEvents.poll(event)) {
+                if (event.type == GameEventType::CoinCollected) coinThisFrame = true;
+            }
+            if (coinThisFrame) audioManager.playCoin();
         }
 
         // Debug visualization
         if (showCollisionDebug) {
+            PROFILE_ZONE("debug draw");
             try {
-                CollisionWorld::debugDrawRockHulls(world.scene(), debugObjects);
-                CollisionWorld::debugDrawExcavatorHulls(world.scene(),
+                debugDraw.setVisible(true);
+                debugDraw.beginFrame();
+                CollisionWorld::debugDrawRockHulls(debugDraw);
+                CollisionWorld::debugDrawExcavatorHulls(debugDraw,
                     excavator.baseMesh(),
                     excavator.bodyMesh(),
                     excavator.boomMesh(),
                     excavator.stickMesh(),
-                    excavator.bucketMesh(),
-                    debugObjects);
+                    excavator.bucketMesh());
+                debugDraw.endFrame();
             } catch (const std::exception& e) {
                 std::cerr << "Debug draw error: " << e.what() << std::endl;
                 showCollisionDebug = false;
+                debugDraw.setVisible(false);
             }
-        } else if (!debugObjects.empty()) {
-            for (auto& obj : debugObjects) {
-                world.scene().remove(*obj);
-            }
-            debugObjects.clear();
+        } else if (debugDraw.visible()) {
+            debugDraw.setVisible(false);
         }
 
         // --- Update camera position (orbit around excavator) ---
@@ -684,8 +889,14 @@ int main() {
         camera.position.z = target.z + cameraDistance * std::sin(cameraAngleV) * std::sin(cameraAngleH);
         camera.lookAt(target);
 
-        renderer.render(world.scene(), camera);
-        ui.render();
+        {
+            PROFILE_ZONE("render");
+            renderer.render(world.scene(), camera);
+        }
+        {
+            PROFILE_ZONE("ui");
+            ui.render();
+        }
         
         // Render fade overlay on top if active
         if (fadeOpacity > 0.0f) {
@@ -693,11 +904,37 @@ int main() {
             renderer.render(overlayScene, overlayCamera);
             renderer.setAutoClear(true); // Re-enable for next frame
         }
-        
+
+        // Startup time: loading screen up, assets in (cold = meshes parsed, warm = mesh cache hits), first game frame
+        static bool firstFrame = true;
+        if (firstFrame) {
+            firstFrame = false;
+            const double startupMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startupBegin).count();
+            const auto meshStats = MeshCache::getStats();
+            logFile << "[startup] first frame after " << loadStats.firstFrameMs << " ms, fully loaded after "
+                    << loadStats.fullyLoadedMs << " ms, playable after " << startupMs << " ms (meshes: "
+                    << meshStats.hits << " cached in " << meshStats.cacheMs << " ms, "
+                    << meshStats.misses << " parsed in " << meshStats.parseMs << " ms)" << std::endl;
+
+            // Per phase wall/CPU time: this run as JSON, and a row per phase added to the history
+            StartupProfiler::finish();
+            if (Settings::startupReport_) {
+                const bool written = StartupProfiler::writeJson(Settings::startupReportJson_, BLOCKS_BUILD_ID) &&
+                                     StartupProfiler::appendCsv(Settings::startupReportCsv_, BLOCKS_BUILD_ID);
+                logFile << "[startup] " << StartupProfiler::phases().size() << " phases, "
+                        << StartupProfiler::totalCpuMs() << " ms main thread CPU, report "
+                        << (written ? "written to " : "failed: ") << Settings::startupReportJson_ << ", "
+                        << Settings::startupReportCsv_ << std::endl;
+            }
+        }
+
         // heartbeat
         static double acc = 0.0;
         acc += dt;
         if (acc > 1.0) { logFile << "[loop] 1s tick" << std::endl; acc = 0.0; }
+        // This frame's scratch (hulls, debug vertices) is done with
+        FrameArena::frame().reset();
+        PROFILE_FRAME_END();
     });
     logFile << "[end] exited animate" << std::endl;
     logFile.close();
@@ -0,0 +1,40 @@
+#include "AllocationTracker.hpp"
+#include <cstdlib>
+#include <new>
+
+// Global operator new/delete replacements feeding AllocationTracker: malloc/free underneath, every form
+// of new counted once. The array and sized forms are replaced too so no path mixes our malloc with the
+// library's delete. Only linked into the targets that count (see blocks_alloc_hooks in CMakeLists.txt)
+namespace {
+    void* allocate(std::size_t size) {
+        AllocationTracker::record(size);
+        if (size == 0) size = 1;
+        // As the standard new does: on failure let the installed new_handler free memory and retry
+        while (true) {
+            if (void* p = std::malloc(size)) return p;
+            std::new_handler handler = std::get_new_handler();
+            if (!handler) throw std::bad_alloc();
+            handler();
+        }
+    }
+
+    void* allocateNoThrow(std::size_t size) noexcept {
+        try {
+            return allocate(size);
+        } catch (...) {
+            return nullptr;
+        }
+    }
+}
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocateNoThrow(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocateNoThrow(size); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
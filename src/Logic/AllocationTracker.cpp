@@ -0,0 +1,28 @@
+#include "AllocationTracker.hpp"
+#include <atomic>
+
+namespace {
+    std::atomic<bool> s_enabled{false};
+    std::atomic<uint64_t> s_totalAllocations{0};
+    std::atomic<uint64_t> s_totalBytes{0};
+}
+
+void AllocationTracker::setEnabled(bool enabled) {
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool AllocationTracker::enabled() {
+    return s_enabled.load(std::memory_order_relaxed);
+}
+
+AllocationTracker::Counts AllocationTracker::total() {
+    return {s_totalAllocations.load(std::memory_order_relaxed), s_totalBytes.load(std::memory_order_relaxed)};
+}
+
+void AllocationTracker::record(size_t bytes) {
+    if (!s_enabled.load(std::memory_order_relaxed)) return;
+    ++t_counts.allocations;
+    t_counts.bytes += bytes;
+    s_totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    s_totalBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
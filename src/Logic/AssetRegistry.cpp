@@ -0,0 +1,132 @@
+#include "AssetRegistry.hpp"
+#include <filesystem>
+
+using namespace threepp;
+
+std::mutex AssetRegistry::s_mutex;
+std::unordered_map<std::string, AssetRegistry::ModelEntry> AssetRegistry::s_models;
+std::unordered_map<std::string, AssetRegistry::Shared<BufferGeometry>> AssetRegistry::s_geometries;
+std::unordered_map<std::string, AssetRegistry::Shared<Material>> AssetRegistry::s_materials;
+
+namespace {
+    // Vertex attributes + index, the part that goes to the GPU
+    size_t geometryBytes(BufferGeometry& geometry) {
+        size_t bytes = 0;
+        for (const char* name : {"position", "normal", "uv", "color"}) {
+            if (auto* attr = geometry.getAttribute<float>(name)) bytes += attr->array().size() * sizeof(float);
+        }
+        if (auto* index = geometry.getIndex()) bytes += index->array().size() * sizeof(unsigned int);
+        return bytes;
+    }
+
+    // "models/Arm1.obj" and "../models/Arm1.obj" are the same file
+    std::string modelKey(const std::string& path, bool loadMtl) {
+        std::error_code ec;
+        auto canonical = std::filesystem::weakly_canonical(path, ec);
+        return (ec ? path : canonical.string()) + (loadMtl ? "|mtl" : "");
+    }
+}
+
+AssetRegistry::ModelEntry& AssetRegistry::insert_(const std::string& key, MeshCache::Model loaded) {
+    ModelEntry entry;
+    loaded.group->traverseType<Mesh>([&](Mesh& m) {
+        entry.meshes.push_back({m.name, m.geometry(), m.material()});
+    });
+    loaded.group.reset();
+    entry.info = std::move(loaded);
+    return s_models.emplace(key, std::move(entry)).first->second;
+}
+
+MeshCache::Model AssetRegistry::load(const std::string& path, bool loadMtl) {
+    const auto key = modelKey(path, loadMtl);
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    auto it = s_models.find(key);
+    ModelEntry* entry = it != s_models.end() ? &it->second : nullptr;
+    if (!entry) {
+        auto loaded = MeshCache::load(path, loadMtl);
+        if (!loaded.group) return loaded; // not kept, it may show up later
+        entry = &insert_(key, std::move(loaded));
+    }
+
+    ++entry->refs;
+    MeshCache::Model model = entry->info;
+    model.group = Group::create();
+    for (const auto& m : entry->meshes) {
+        auto mesh = Mesh::create(m.geometry, m.material);
+        mesh->name = m.name;
+        model.group->add(mesh);
+    }
+    return model;
+}
+
+void AssetRegistry::adopt(const std::string& path, bool loadMtl, MeshCache::MeshData data) {
+    const auto key = modelKey(path, loadMtl);
+    std::lock_guard<std::mutex> lock(s_mutex);
+    if (s_models.count(key)) return;
+    insert_(key, MeshCache::toModel(std::move(data)));
+}
+
+bool AssetRegistry::has(const std::string& path, bool loadMtl) {
+    const auto key = modelKey(path, loadMtl);
+    std::lock_guard<std::mutex> lock(s_mutex);
+    return s_models.count(key) > 0;
+}
+
+std::shared_ptr<BufferGeometry> AssetRegistry::geometry(
+    const std::string& name, const std::function<std::shared_ptr<BufferGeometry>()>& create) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    auto& shared = s_geometries[name];
+    if (!shared.asset) shared.asset = create();
+    ++shared.refs;
+    return shared.asset;
+}
+
+std::shared_ptr<Material> AssetRegistry::material(
+    const std::string& name, const std::function<std::shared_ptr<Material>()>& create) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    auto& shared = s_materials[name];
+    if (!shared.asset) shared.asset = create();
+    ++shared.refs;
+    return shared.asset;
+}
+
+AssetRegistry::Report AssetRegistry::report() {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    Report r;
+    for (const auto& [key, entry] : s_models) {
+        ++r.models;
+        r.modelRefs += entry.refs;
+        r.geometries += entry.meshes.size();
+        r.geometryRefs += entry.meshes.size() * entry.refs;
+        r.materials += entry.meshes.size();
+        r.materialRefs += entry.meshes.size() * entry.refs;
+        for (const auto& m : entry.meshes) {
+            if (!m.geometry) continue;
+            const size_t bytes = geometryBytes(*m.geometry);
+            r.uniqueBytes += bytes;
+            r.referencedBytes += bytes * entry.refs;
+        }
+    }
+    for (const auto& [name, shared] : s_geometries) {
+        if (!shared.asset) continue;
+        ++r.geometries;
+        r.geometryRefs += shared.refs;
+        const size_t bytes = geometryBytes(*shared.asset);
+        r.uniqueBytes += bytes;
+        r.referencedBytes += bytes * shared.refs;
+    }
+    for (const auto& [name, shared] : s_materials) {
+        if (!shared.asset) continue;
+        ++r.materials;
+        r.materialRefs += shared.refs;
+    }
+    return r;
+}
+
+void AssetRegistry::clear() {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_models.clear();
+    s_geometries.clear();
+    s_materials.clear();
+}
@@ -0,0 +1,127 @@
+#include "AsyncLoader.hpp"
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include "AssetRegistry.hpp"
+#include "MeshCache.hpp"
+
+AsyncLoader::AsyncLoader(std::chrono::steady_clock::time_point start, unsigned threads)
+    : start_(start) {
+    if (threads == 0) {
+        const unsigned cores = std::thread::hardware_concurrency();
+        threads = std::max(1u, cores > 1 ? cores - 1 : 1u);
+    }
+    for (unsigned i = 0; i < threads; ++i) workers_.emplace_back([this] { workerLoop_(); });
+}
+
+AsyncLoader::~AsyncLoader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    workCv_.notify_all();
+    for (auto& worker : workers_) worker.join();
+}
+
+void AsyncLoader::request(Work work) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(std::move(work));
+        ++stats_.requested;
+    }
+    workCv_.notify_one();
+}
+
+void AsyncLoader::requestModel(const std::string& path, bool loadMtl) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!models_.insert(path + (loadMtl ? "|mtl" : "")).second) return;
+    }
+    request([path, loadMtl]() -> Finish {
+        // Shared so the finish step can be a copyable std::function
+        auto data = std::make_shared<std::optional<MeshCache::MeshData>>(MeshCache::loadData(path, loadMtl));
+        return [path, loadMtl, data] {
+            if (*data) AssetRegistry::adopt(path, loadMtl, std::move(**data));
+        };
+    });
+}
+
+void AsyncLoader::poll(size_t maxFinishes) {
+    for (size_t n = 0; n < maxFinishes; ++n) {
+        Finish finish;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (ready_.empty()) return;
+            finish = std::move(ready_.front());
+            ready_.pop_front();
+        }
+        if (finish) finish();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.finished;
+        if (stats_.finished == stats_.requested) stats_.fullyLoadedMs = msSinceStart_();
+    }
+}
+
+void AsyncLoader::finishAll() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            readyCv_.wait(lock, [this] { return !ready_.empty() || stats_.finished == stats_.requested; });
+            if (ready_.empty()) return;
+        }
+        poll();
+    }
+}
+
+void AsyncLoader::markFrame() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stats_.firstFrameMs < 0.0) stats_.firstFrameMs = msSinceStart_();
+}
+
+bool AsyncLoader::done() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_.finished == stats_.requested;
+}
+
+float AsyncLoader::progress() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stats_.requested == 0) return 1.f;
+    return static_cast<float>(stats_.finished) / static_cast<float>(stats_.requested);
+}
+
+AsyncLoader::Stats AsyncLoader::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+double AsyncLoader::msSinceStart_() const {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_).count();
+}
+
+void AsyncLoader::workerLoop_() {
+    while (true) {
+        Work work;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            workCv_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+            if (stop_) return;
+            work = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+
+        // A failed job still counts as finished, or the loading screen would never end
+        Finish finish;
+        try {
+            finish = work();
+        } catch (const std::exception& e) {
+            std::cerr << "AsyncLoader: job failed: " << e.what() << std::endl;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ready_.push_back(std::move(finish));
+        }
+        readyCv_.notify_all();
+    }
+}
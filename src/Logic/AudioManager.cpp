@@ -8,58 +8,68 @@ AudioManager::AudioManager(threepp::AudioListener& listener)
     : listener_(listener) {}
 
 //---- LOADS ----
-void AudioManager::loadStartupSound(const std::string& path) {
+std::unique_ptr<threepp::Audio> AudioManager::openSound(threepp::AudioListener& listener, const std::string& path) {
     try {
-        startupSound_ = std::make_unique<threepp::Audio>(listener_, path);
-        startupSound_->setLooping(false);
-        startupSound_->setVolume(0.5f);
-        std::cout << "Loaded startup sound: " << path << std::endl;
+        return std::make_unique<threepp::Audio>(listener, path);
     } catch (const std::exception& e) {
-        std::cerr << "Failed to load startup sound: " << e.what() << std::endl;
+        std::cerr << "Failed to load sound " << path << ": " << e.what() << std::endl;
+        return nullptr;
     }
 }
 
-void AudioManager::loadIdleSound(const std::string& path) {
-    try {
-        idleSound_ = std::make_unique<threepp::Audio>(listener_, path);
-        idleSound_->setLooping(true);
-        idleSound_->setVolume(0.2f);
-        std::cout << "Loaded idle sound: " << path << std::endl;
-    } catch (const std::exception& e) {
-        std::cerr << "Failed to load idle sound: " << e.what() << std::endl;
+void AudioManager::setSound(Sound sound, std::unique_ptr<threepp::Audio> audio) {
+    if (!audio) return;
+    switch (sound) {
+        case Sound::Startup:
+            audio->setLooping(false);
+            audio->setVolume(0.5f);
+            startupSound_ = std::move(audio);
+            std::cout << "Loaded startup sound" << std::endl;
+            break;
+        case Sound::Idle:
+            audio->setLooping(true);
+            audio->setVolume(0.2f);
+            idleSound_ = std::move(audio);
+            std::cout << "Loaded idle sound" << std::endl;
+            break;
+        case Sound::Hydraulics:
+            audio->setLooping(true);
+            audio->setVolume(0.4f);
+            hydraulicsSound_ = std::move(audio);
+            std::cout << "Loaded hydraulics sound" << std::endl;
+            break;
+        case Sound::Steam:
+            audio->setLooping(true);
+            audio->setVolume(0.35f);
+            steamSound_ = std::move(audio);
+            std::cout << "Loaded steam sound" << std::endl;
+            break;
+        case Sound::Coin:
+            audio->setVolume(0.5f * effectsVolume_);
+            coinSound_ = std::move(audio);
+            std::cout << "Loaded coin sound" << std::endl;
+            break;
     }
 }
 
+void AudioManager::loadStartupSound(const std::string& path) {
+    setSound(Sound::Startup, openSound(listener_, path));
+}
+
+void AudioManager::loadIdleSound(const std::string& path) {
+    setSound(Sound::Idle, openSound(listener_, path));
+}
+
 void AudioManager::loadHydraulicsSound(const std::string& path) {
-    try {
-        hydraulicsSound_ = std::make_unique<threepp::Audio>(listener_, path);
-        hydraulicsSound_->setLooping(true);
-        hydraulicsSound_->setVolume(0.4f);
-        std::cout << "Loaded hydraulics sound: " << path << std::endl;
-    } catch (const std::exception& e) {
-        std::cerr << "Failed to load hydraulics sound: " << e.what() << std::endl;
-    }
+    setSound(Sound::Hydraulics, openSound(listener_, path));
 }
 
 void AudioManager::loadSteamSound(const std::string& path) {
-    try {
-        steamSound_ = std::make_unique<threepp::Audio>(listener_, path);
-        steamSound_->setLooping(true);
-        steamSound_->setVolume(0.35f);
-        std::cout << "Loaded steam sound: " << path << std::endl;
-    } catch (const std::exception& e) {
-        std::cerr << "Failed to load steam sound: " << e.what() << std::endl;
-    }
+    setSound(Sound::Steam, openSound(listener_, path));
 }
 
 void AudioManager::loadCoinSound(const std::string& path) {
-    try {
-        coinSound_ = std::make_unique<threepp::Audio>(listener_, path);
-        coinSound_->setVolume(0.5f * effectsVolume_);
-        std::cout << "Loaded coin sound: " << path << std::endl;
-    } catch (const std::exception& e) {
-        std::cerr << "Failed to load coin sound: " << e.what() << std::endl;
-    }
+    setSound(Sound::Coin, openSound(listener_, path));
 }
 
 void AudioManager::startEngine() {
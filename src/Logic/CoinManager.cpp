@@ -1,63 +1,213 @@
 #include "CoinManager.hpp"
 #include "Settings.hpp"
 #include <threepp/geometries/CylinderGeometry.hpp>
-#include <threepp/materials/MeshStandardMaterial.hpp>
 #include <threepp/math/MathUtils.hpp>
+#include <algorithm>
+#include <cmath>
 #include <random>
 
 using namespace Settings;
 
-CoinManager::CoinManager(threepp::Scene& scene) : scene_(scene) {}
+namespace {
+    // Spin around world Y and bob, both offset by a per-instance phase hashed from the coin's
+    // position (no extra instance attribute needed). Lighting is a cheap fixed-direction lambert.
+    const char* kCoinVertexShader = R"(
+        uniform float uTime;
+        uniform float uSpin;
+        uniform float uBobHeight;
+        uniform float uBobSpeed;
+        varying vec3 vNormal;
+
+        float hash(vec2 p) {
+            return fract(sin(dot(p, vec2(12.9898, 78.233))) * 43758.5453);
+        }
+
+        void main() {
+            vec3 base = instanceMatrix[3].xyz;
+            float phase = hash(base.xz) * 6.2831853;
+
+            float a = uTime * uSpin + phase;
+            float c = cos(a);
+            float s = sin(a);
+            mat3 spin = mat3(c, 0.0, -s,  0.0, 1.0, 0.0,  s, 0.0, c);
+
+            mat3 shape = mat3(instanceMatrix); // zero for collected coins -> degenerate, not drawn
+            vec3 local = spin * (shape * position);
+            float bob = sin(uTime * uBobSpeed + phase) * uBobHeight;
+            vec3 world = base + local + vec3(0.0, bob, 0.0);
+
+            vNormal = normalize(spin * normal);
+            gl_Position = projectionMatrix * viewMatrix * modelMatrix * vec4(world, 1.0);
+        }
+    )";
+
+    const char* kCoinFragmentShader = R"(
+        uniform vec3 uColor;
+        varying vec3 vNormal;
+        void main() {
+            vec3 lightDir = normalize(vec3(0.4, 1.0, 0.3));
+            float diffuse = abs(dot(normalize(vNormal), lightDir)); // both faces catch light
+            gl_FragColor = vec4(uColor * (0.45 + 0.75 * diffuse), 1.0);
+        }
+    )";
+
+    // Collected coins collapse to nothing instead of being removed from the buffer
+    const threepp::Matrix4& hiddenMatrix() {
+        static const threepp::Matrix4 m = threepp::Matrix4().makeScale(0.f, 0.f, 0.f);
+        return m;
+    }
+}
+
+CoinManager::CoinManager(threepp::Scene& scene, unsigned int seed) : scene_(scene), rng_(seed) {
+    coinGeometry_ = threepp::CylinderGeometry::create(0.5f, 0.5f, 0.1f, 16);
+    coinGeometry_->rotateX(threepp::math::PI / 2.0f); // stand upright, spin happens around Y in the shader
+
+    coinMaterial_ = threepp::ShaderMaterial::create();
+    coinMaterial_->vertexShader = kCoinVertexShader;
+    coinMaterial_->fragmentShader = kCoinFragmentShader;
+    coinMaterial_->uniforms = {
+        {"uTime", threepp::Uniform(0.f)},
+        {"uSpin", threepp::Uniform(rotationSpeed_)},
+        {"uBobHeight", threepp::Uniform(bobHeight_)},
+        {"uBobSpeed", threepp::Uniform(bobSpeed_)},
+        {"uColor", threepp::Uniform(threepp::Color(0xFFD700))} // Gold
+    };
+}
 
 void CoinManager::spawnCoins(int count, float arenaRadius) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> angleDist(0.0f, threepp::math::TWO_PI);
-    std::uniform_real_distribution<float> radiusDist(5.0f, arenaRadius - 3.0f);
-    std::uniform_real_distribution<float> rotationDist(0.0f, threepp::math::TWO_PI);
-    
-    auto coinGeometry = threepp::CylinderGeometry::create(0.5f, 0.5f, 0.1f, 16);
-    auto coinMaterial = threepp::MeshStandardMaterial::create();
-    coinMaterial->color.setHex(0xFFD700); // Gold 
-    coinMaterial->metalness = 0.8f;
-    coinMaterial->roughness = 0.2f;
-    
+    arenaRadius_ = arenaRadius;
+    coins_.reserve(coins_.size() + count);
     for (int i = 0; i < count; ++i) {
-        float angle = angleDist(gen);
-        float radius = radiusDist(gen);
-        
-        threepp::Vector3 pos(
-            radius * std::cos(angle),
-            1.0f, // Hover above ground
-            radius * std::sin(angle)
-        );
-        
-        auto coinMesh = threepp::Mesh::create(coinGeometry, coinMaterial);
-        coinMesh->rotation.x = threepp::math::PI / 2.0f; // Lay flat initially
-        coinMesh->rotation.z = rotationDist(gen); // Random starting rotation
-        scene_.add(coinMesh);
-        
-        auto coin = std::make_unique<Coin>(pos, coinMesh);
-        coins_.push_back(std::move(coin));
+        coins_.emplace_back(randomPosition_(), coins_.size());
     }
+
+    rebuildInstances_();
+    rebuildIndex_();
 }
 
-void CoinManager::update(float dt) {
-    for (auto& coin : coins_) {
-        coin->update(dt);
+threepp::Vector3 CoinManager::randomPosition_() {
+    std::uniform_real_distribution<float> angleDist(0.0f, threepp::math::TWO_PI);
+    std::uniform_real_distribution<float> radiusDist(5.0f, arenaRadius_ - 3.0f);
+    float angle = angleDist(rng_);
+    float radius = radiusDist(rng_);
+
+    return threepp::Vector3(
+        radius * std::cos(angle),
+        1.0f, // Hover above ground
+        radius * std::sin(angle)
+    );
+}
+
+void CoinManager::rebuildInstances_() {
+    if (instances_) scene_.remove(*instances_);
+
+    instances_ = threepp::InstancedMesh::create(coinGeometry_, coinMaterial_, coins_.size());
+    instances_->frustumCulled = false; // bounds would only cover one coin at the origin
+    threepp::Matrix4 m;
+    for (const auto& coin : coins_) {
+        if (coin.isCollected()) {
+            instances_->setMatrixAt(coin.getInstanceId(), hiddenMatrix());
+        } else {
+            const auto& p = coin.getPosition();
+            instances_->setMatrixAt(coin.getInstanceId(), m.makeTranslation(p.x, p.y, p.z));
+        }
+    }
+    instances_->instanceMatrix()->needsUpdate();
+    scene_.add(instances_);
+}
+
+int CoinManager::cellCoord_(float v) const {
+    return static_cast<int>(std::floor(v / cellSize_));
+}
+
+size_t CoinManager::bucketOf_(int cx, int cz) const {
+    // Classic spatial hash primes, table size is a power of two
+    const uint32_t h = (static_cast<uint32_t>(cx) * 73856093u) ^ (static_cast<uint32_t>(cz) * 19349663u);
+    return h & (bucketLive_.size() - 1);
+}
+
+void CoinManager::rebuildIndex_() {
+    cellSize_ = std::max(0.01f, coinCellSize_);
+
+    // ~2 buckets per coin keeps collisions between unrelated cells rare
+    size_t buckets = 1;
+    while (buckets < coins_.size() * 2) buckets <<= 1;
+    bucketStart_.assign(buckets + 1, 0);
+    bucketLive_.assign(buckets, 0);
+
+    // Counting sort: count, prefix sum, scatter (collected coins stay out)
+    for (const auto& coin : coins_) {
+        if (coin.isCollected()) continue;
+        const auto& p = coin.getPosition();
+        bucketLive_[bucketOf_(cellCoord_(p.x), cellCoord_(p.z))]++;
+    }
+    for (size_t b = 0; b < buckets; ++b) {
+        bucketStart_[b + 1] = bucketStart_[b] + bucketLive_[b];
+    }
+    entries_.assign(bucketStart_[buckets], 0);
+    std::fill(bucketLive_.begin(), bucketLive_.end(), 0);
+    for (uint32_t i = 0; i < coins_.size(); ++i) {
+        if (coins_[i].isCollected()) continue;
+        const auto& p = coins_[i].getPosition();
+        const size_t b = bucketOf_(cellCoord_(p.x), cellCoord_(p.z));
+        entries_[bucketStart_[b] + bucketLive_[b]++] = i;
     }
 }
 
+void CoinManager::update(float dt) {
+    // Everything per coin happens in the vertex shader
+    time_ += dt;
+    coinMaterial_->uniforms.at("uTime").value<float>() = time_;
+    coinMaterial_->uniforms.at("uSpin").value<float>() = rotationSpeed_;
+    coinMaterial_->uniforms.at("uBobHeight").value<float>() = bobHeight_;
+    coinMaterial_->uniforms.at("uBobSpeed").value<float>() = bobSpeed_;
+}
+
 bool CoinManager::checkCollection(const threepp::Vector3& position, float collectionRadius) {
+    if (bucketLive_.empty()) return false;
+
     bool collected = false;
-    for (auto& coin : coins_) {
-        if (!coin->isCollected()) {
-            float distance = position.distanceTo(coin->getPosition());
-            if (distance < collectionRadius) {
-                coin->collect();
-                scene_.remove(*coin->getMesh());
+    const float radiusSq = collectionRadius * collectionRadius;
+
+    auto scanBucket = [&](size_t b) {
+        const uint32_t start = bucketStart_[b];
+        uint32_t i = 0;
+        bool hidAny = false;
+        while (i < bucketLive_[b]) {
+            Coin& coin = coins_[entries_[start + i]];
+            if (position.distanceToSquared(coin.getPosition()) < radiusSq) {
+                coin.collect();
+                instances_->setMatrixAt(coin.getInstanceId(), hiddenMatrix());
+                hidAny = true;
+                if (events_) {
+                    events_->publish(GameEventType::CoinCollected, coin.getPosition(), static_cast<int>(coin.getInstanceId()));
+                }
                 collectedCount_++;
                 collected = true;
+                // Swap-remove: move the last live entry here and shrink the live range
+                std::swap(entries_[start + i], entries_[start + --bucketLive_[b]]);
+            } else {
+                ++i;
+            }
+        }
+        if (hidAny) instances_->instanceMatrix()->needsUpdate();
+    };
+
+    // Cells overlapping the pickup radius on XZ
+    const int cx0 = cellCoord_(position.x - collectionRadius);
+    const int cx1 = cellCoord_(position.x + collectionRadius);
+    const int cz0 = cellCoord_(position.z - collectionRadius);
+    const int cz1 = cellCoord_(position.z + collectionRadius);
+    const size_t cells = static_cast<size_t>(cx1 - cx0 + 1) * static_cast<size_t>(cz1 - cz0 + 1);
+
+    if (cells >= bucketLive_.size()) {
+        // Radius covers more cells than there are buckets, just sweep the table once
+        for (size_t b = 0; b < bucketLive_.size(); ++b) scanBucket(b);
+    } else {
+        // Unrelated cells can share a bucket, the distance test sorts them out
+        for (int cz = cz0; cz <= cz1; ++cz) {
+            for (int cx = cx0; cx <= cx1; ++cx) {
+                scanBucket(bucketOf_(cx, cz));
             }
         }
     }
@@ -65,9 +215,29 @@ bool CoinManager::checkCollection(const threepp::Vector3& position, float collec
 }
 
 void CoinManager::reset() {
+    if (!instances_) return; // nothing spawned (or cleared), nothing to re-scatter
+
+    // Same coins, same instanced mesh: just move them and rewrite the matrices in place
+    threepp::Matrix4 m;
     for (auto& coin : coins_) {
-        scene_.remove(*coin->getMesh());
+        coin.respawn(randomPosition_());
+        const auto& p = coin.getPosition();
+        instances_->setMatrixAt(coin.getInstanceId(), m.makeTranslation(p.x, p.y, p.z));
+    }
+    instances_->instanceMatrix()->needsUpdate();
+
+    rebuildIndex_(); // table sizes don't change, so this reuses the existing storage
+    collectedCount_ = 0;
+}
+
+void CoinManager::clear() {
+    if (instances_) {
+        scene_.remove(*instances_);
+        instances_.reset();
     }
     coins_.clear();
+    bucketStart_.clear();
+    bucketLive_.clear();
+    entries_.clear();
     collectedCount_ = 0;
 }
@@ -1,24 +1,36 @@
 #include "CollisionWorld.hpp"
+#include "DebugDraw.hpp"
+#include "FrameArena.hpp"
 #include <threepp/threepp.hpp>
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <limits>
+#include <memory_resource>
 #include <iostream>
 
 using namespace threepp;
 
 // use convex hulls so you dont have to do full mesh to mesh collision
 std::vector<CollisionWorld::MeshXZCollider> CollisionWorld::s_rockMeshes;
+std::vector<CollisionWorld::ColliderHandle> CollisionWorld::s_freeMeshSlots;
 float CollisionWorld::s_rockHullPadding = 0.005f; // shrink hull by 5mm cus its colliding w air
 std::vector<CollisionWorld::NoCollisionZone> CollisionWorld::s_noCollisionZones;
+uint64_t CollisionWorld::s_revision = 0;
 
 float CollisionWorld::groundY() {
     return 0.0f;
 }
 
+uint64_t CollisionWorld::revision() {
+    return s_revision;
+}
+
 void CollisionWorld::clear() {
     s_rockMeshes.clear();
+    s_freeMeshSlots.clear();
     s_noCollisionZones.clear();
+    s_revision++;
 }
 
 namespace {
@@ -31,7 +43,9 @@ inline float cross2(const threepp::Vector2& a, const threepp::Vector2& b, const
     return abx * acy - aby * acx;
 }
 
-std::vector<threepp::Vector2> convexHull(std::vector<threepp::Vector2> pts) {
+// Works on std::vector and std::pmr::vector alike, the hull lives wherever the input did
+template<class Points>
+Points convexHull(Points pts) {
     if (pts.size() < 3) return pts;
     
     // Remove duplicates
@@ -45,12 +59,12 @@ std::vector<threepp::Vector2> convexHull(std::vector<threepp::Vector2> pts) {
     
     if (pts.size() < 3) return pts;
     
-    std::vector<threepp::Vector2> lower;
+    Points lower(pts.get_allocator());
     for (const auto& p : pts) {
         while (lower.size() >= 2 && cross2(lower[lower.size()-2], lower[lower.size()-1], p) <= 0) lower.pop_back();
         lower.push_back(p);
     }
-    std::vector<threepp::Vector2> upper;
+    Points upper(pts.get_allocator());
     for (int i = static_cast<int>(pts.size()) - 1; i >= 0; --i) {
         const auto& p = pts[i];
         while (upper.size() >= 2 && cross2(upper[upper.size()-2], upper[upper.size()-1], p) <= 0) upper.pop_back();
@@ -62,14 +76,14 @@ std::vector<threepp::Vector2> convexHull(std::vector<threepp::Vector2> pts) {
     return lower.empty() ? pts : lower; // CCW order
 }
 
-// Compute convex hull for a single object
-std::vector<threepp::Vector2> computeObjectHull(threepp::Object3D* obj, float minY = -0.1f) {
+// Compute convex hull for a single object, per frame, so the points and the hull come from scratch memory
+std::pmr::vector<threepp::Vector2> computeObjectHull(threepp::Object3D* obj, std::pmr::memory_resource* scratch, float minY = -0.1f) {
+    std::pmr::vector<threepp::Vector2> pts(scratch);
     if (!obj) {
         std::cout << "computeObjectHull: null object" << std::endl;
-        return {};
+        return pts;
     }
     obj->updateMatrixWorld(true);
-    std::vector<threepp::Vector2> pts;
     pts.reserve(256);
     
     obj->traverseType<threepp::Mesh>([&](threepp::Mesh& m){
@@ -92,12 +106,11 @@ std::vector<threepp::Vector2> computeObjectHull(threepp::Object3D* obj, float mi
     });
     
     if (pts.size() < 3) {
-        return {};
+        pts.clear();
+        return pts;
     }
     auto hull = convexHull(std::move(pts));
-    if (hull.size() < 3) {
-        return {};
-    }
+    if (hull.size() < 3) hull.clear();
     return hull;
 }
 }
@@ -163,43 +176,97 @@ void CollisionWorld::addRockMeshColliderFromObject(Object3D& obj) {
     MeshXZCollider mc;
     mc.hull = std::move(hull);
     s_rockMeshes.push_back(std::move(mc));
+    s_revision++;
     std::cout << "addRockMeshColliderFromObject: added collider" << std::endl;
 }
 
-void CollisionWorld::updateLastRockMeshColliderFromObject(Object3D& obj) {
-    if (s_rockMeshes.empty()) return;
-    // Recompute hull just like addRockMeshColliderFromObject, but replace the last entry
-    obj.updateMatrixWorld(true);
-    std::vector<threepp::Vector2> pts;
-    pts.reserve(512);
+CollisionWorld::ColliderHandle CollisionWorld::addMeshColliderFromPoints(std::vector<threepp::Vector2> points) {
+    MeshXZCollider mc;
+    if (points.size() >= 3) {
+        mc.hull = convexHull(std::move(points));
+        if (mc.hull.size() < 3) mc.hull.clear();
+    }
 
-    obj.traverseType<threepp::Mesh>([&](threepp::Mesh& m){
-        m.updateMatrixWorld(true);
-        auto geom = m.geometry();
-        if (!geom) return;
-        const auto* pos = geom->getAttribute<float>("position");
-        if (!pos) return;
-        threepp::Vector3 v;
-        for (int i = 0, c = pos->count(); i < c; ++i) {
-            v.x = pos->getX(i);
-            v.y = pos->getY(i);
-            v.z = pos->getZ(i);
-            v.applyMatrix4(*m.matrixWorld);
-            pts.emplace_back(v.x, v.z);
-        }
-    });
+    s_revision++;
+    if (!s_freeMeshSlots.empty()) {
+        const ColliderHandle handle = s_freeMeshSlots.back();
+        s_freeMeshSlots.pop_back();
+        s_rockMeshes[handle] = std::move(mc);
+        return handle;
+    }
+    s_rockMeshes.push_back(std::move(mc));
+    return static_cast<ColliderHandle>(s_rockMeshes.size() - 1);
+}
 
-    if (pts.size() < 3) return;
-    auto hull = convexHull(std::move(pts));
-    if (hull.size() < 3) return;
+void CollisionWorld::updateMeshCollider(ColliderHandle handle, std::vector<threepp::Vector2> points) {
+    if (handle < 0 || handle >= static_cast<ColliderHandle>(s_rockMeshes.size())) return;
+    auto& hull = s_rockMeshes[handle].hull;
+    s_revision++;
+    if (points.size() < 3) {
+        hull.clear(); // nothing left to collide with
+        return;
+    }
+    hull = convexHull(std::move(points));
+    if (hull.size() < 3) hull.clear();
+}
 
-    s_rockMeshes.back().hull = std::move(hull);
+void CollisionWorld::setMeshColliderEnabled(ColliderHandle handle, bool enabled) {
+    if (handle < 0 || handle >= static_cast<ColliderHandle>(s_rockMeshes.size())) return;
+    if (s_rockMeshes[handle].enabled == enabled) return;
+    s_rockMeshes[handle].enabled = enabled;
+    s_revision++;
 }
 
-void CollisionWorld::popLastRockMeshCollider() {
-    if (!s_rockMeshes.empty()) {
-        s_rockMeshes.pop_back();
+bool CollisionWorld::isMeshColliderEnabled(ColliderHandle handle) {
+    if (handle < 0 || handle >= static_cast<ColliderHandle>(s_rockMeshes.size())) return false;
+    return s_rockMeshes[handle].enabled;
+}
+
+void CollisionWorld::removeMeshCollider(ColliderHandle handle) {
+    if (handle < 0 || handle >= static_cast<ColliderHandle>(s_rockMeshes.size())) return;
+    if (std::find(s_freeMeshSlots.begin(), s_freeMeshSlots.end(), handle) != s_freeMeshSlots.end()) return; // already free
+    auto& mc = s_rockMeshes[handle];
+    mc.hull.clear();
+    mc.enabled = false;
+    s_freeMeshSlots.push_back(handle);
+    s_revision++;
+}
+
+CollisionWorld::ColliderHandle CollisionWorld::addMeshColliderFromTemplate(const std::vector<threepp::Vector2>& hull,
+                                                                          float x, float z, float yaw, float scale) {
+    MeshXZCollider mc;
+    if (hull.size() >= 3) {
+        // Same rotation as Object3D::rotation.y, a uniform positive scale keeps the hull CCW
+        const float c = std::cos(yaw);
+        const float s = std::sin(yaw);
+        mc.hull.reserve(hull.size());
+        for (const auto& p : hull) {
+            mc.hull.emplace_back(x + scale * (c * p.x + s * p.y), z + scale * (-s * p.x + c * p.y));
+        }
+    }
+
+    s_revision++;
+    if (!s_freeMeshSlots.empty()) {
+        const ColliderHandle handle = s_freeMeshSlots.back();
+        s_freeMeshSlots.pop_back();
+        s_rockMeshes[handle] = std::move(mc);
+        return handle;
     }
+    s_rockMeshes.push_back(std::move(mc));
+    return static_cast<ColliderHandle>(s_rockMeshes.size() - 1);
+}
+
+std::vector<threepp::Vector2> CollisionWorld::footprintHull(std::vector<threepp::Vector2> points) {
+    if (points.size() < 3) return {};
+    auto hull = convexHull(std::move(points));
+    if (hull.size() < 3) hull.clear();
+    return hull;
+}
+
+size_t CollisionWorld::getActiveMeshColliderCount() {
+    return static_cast<size_t>(std::count_if(s_rockMeshes.begin(), s_rockMeshes.end(), [](const MeshXZCollider& mc) {
+        return mc.enabled && mc.hull.size() >= 3;
+    }));
 }
 
 void CollisionWorld::addNoCollisionZone(const NoCollisionZone& zone) {
@@ -224,7 +291,7 @@ bool CollisionWorld::resolveExcavatorMove(float& x, float& z, float excavatorRad
     // This loop finds the closest point on the hull edges and pushes out if inside (2)
     for (const auto& mc : s_rockMeshes) {
         const auto& poly = mc.hull;
-        if (poly.size() < 3) continue;
+        if (!mc.enabled || poly.size() < 3) continue;
         // Find maximum signed distance to polygon edges using outward normals (CCW hull)
         float maxD = -std::numeric_limits<float>::infinity();
         threepp::Vector2 bestN{0,0};
@@ -262,19 +329,20 @@ bool CollisionWorld::resolveExcavatorMeshCollisions(threepp::Object3D* root,
                                                       threepp::Object3D* stickMesh,
                                                       threepp::Object3D* bucketMesh) {
     if (!root) return false;
+    // Part hulls are scratch, handed back to the frame arena on the way out
+    FrameArena& arena = FrameArena::frame();
+    FrameArena::Rewind rewind(arena);
     
     // Check base/tracks, body, and boom for collision, bucket not included cus of digging
-    std::vector<threepp::Object3D*> parts;
-    if (baseMesh) parts.push_back(baseMesh);
-    if (bodyMesh) parts.push_back(bodyMesh);
-    if (boomMesh) parts.push_back(boomMesh);
+    const std::array<threepp::Object3D*, 3> parts{baseMesh, bodyMesh, boomMesh};
     
     bool adjusted = false;
     threepp::Vector3 totalPush{0, 0, 0};
     
     // For each excavator part, compute its convex hull and check against rock hulls
     for (auto* part : parts) {
-        auto partHull = computeObjectHull(part);
+        if (!part) continue;
+        auto partHull = computeObjectHull(part, &arena);
         if (partHull.size() < 3) continue;
 
         // If any vertex of this part is in a pass-through zone, skip mesh/AABB collision for this part (helped with air collision around the enterance)
@@ -295,7 +363,7 @@ bool CollisionWorld::resolveExcavatorMeshCollisions(threepp::Object3D* root,
         // Check this excavator parts hull against each rock hull
         for (const auto& mc : s_rockMeshes) {
             const auto& rockHull = mc.hull;
-            if (rockHull.size() < 3) continue;
+            if (!mc.enabled || rockHull.size() < 3) continue;
             
             // Find the deepest edge on the rock hull
             float maxPenetration = -std::numeric_limits<float>::infinity();
@@ -344,87 +412,44 @@ bool CollisionWorld::resolveExcavatorMeshCollisions(threepp::Object3D* root,
     return adjusted;
 }
 
-void CollisionWorld::debugDrawRockHulls(threepp::Scene& scene, std::vector<std::shared_ptr<threepp::Object3D>>& debugObjects) {
-    // Clear previous debug objects from scene cus they were lingering
-    for (auto& obj : debugObjects) {
-        if (obj) scene.remove(*obj);
-    }
-    debugObjects.clear();
-    
-    // Draw rock hulls
+void CollisionWorld::debugDrawRockHulls(DebugDraw& draw) {
+    // The lines stay in the static buffer until a collider changes
+    if (!draw.beginStatic(s_revision)) return;
+
+    const Color red(Color::red);
     for (const auto& mc : s_rockMeshes) {
         const auto& hull = mc.hull;
-        if (hull.size() < 3) continue;
-        
-        std::vector<float> vertices;
-        vertices.reserve(hull.size() * 6);
-        
+        if (!mc.enabled || hull.size() < 3) continue;
+
         for (size_t i = 0; i < hull.size(); ++i) {
             const auto& p = hull[i];
             const auto& next = hull[(i + 1) % hull.size()];
-            
-            vertices.push_back(p.x);
-            vertices.push_back(0.1f); // move up so i can see the debug lines
-            vertices.push_back(p.y);
-            
-            vertices.push_back(next.x);
-            vertices.push_back(0.1f);
-            vertices.push_back(next.y);
-        }
-        
-        if (vertices.empty()) continue;
-        
-        try {
-            auto geom = threepp::BufferGeometry::create();
-            geom->setAttribute("position", FloatBufferAttribute::create(std::vector<float>(vertices), 3)); // I get a no instance of overloaded function error but it still works so imma not question it
-            auto mat = threepp::LineBasicMaterial::create();
-            mat->color = threepp::Color::red;
-            auto line = threepp::LineSegments::create(geom, mat);
-            scene.add(line);
-            debugObjects.push_back(line);
-        } catch (...) {
-            // Ignore errors creating debug geometry
+            // move up so i can see the debug lines
+            draw.staticLine(Vector3(p.x, 0.1f, p.y), Vector3(next.x, 0.1f, next.y), red);
         }
     }
 }
 
-void CollisionWorld::debugDrawExcavatorHulls(threepp::Scene& scene,
+void CollisionWorld::debugDrawExcavatorHulls(DebugDraw& draw,
                                               threepp::Object3D* baseMesh,
                                               threepp::Object3D* bodyMesh,
                                               threepp::Object3D* boomMesh,
                                               threepp::Object3D* stickMesh,
-                                              threepp::Object3D* bucketMesh,
-                                              std::vector<std::shared_ptr<threepp::Object3D>>& debugObjects) {
-    std::vector<threepp::Object3D*> parts;
-    if (baseMesh) parts.push_back(baseMesh);
-    if (bodyMesh) parts.push_back(bodyMesh);
-    if (boomMesh) parts.push_back(boomMesh);
-    if (stickMesh) parts.push_back(stickMesh);
-    if (bucketMesh) parts.push_back(bucketMesh);
-    
+                                              threepp::Object3D* bucketMesh) {
+    const std::array<threepp::Object3D*, 5> parts{baseMesh, bodyMesh, boomMesh, stickMesh, bucketMesh};
+    const Color green(Color::green);
+    FrameArena::Rewind rewind(FrameArena::frame());
+
     for (auto* part : parts) {
-        auto hull = computeObjectHull(part);
+        if (!part) continue;
+        auto hull = computeObjectHull(part, &FrameArena::frame());
         if (hull.size() < 3) continue;
-        
-        std::vector<float> vertices;
+
         for (size_t i = 0; i < hull.size(); ++i) {
             const auto& p = hull[i];
-            vertices.push_back(p.x);
-            vertices.push_back(0.2f); // slightly higher than rock hulls
-            vertices.push_back(p.y);
-            
             const auto& next = hull[(i + 1) % hull.size()];
-            vertices.push_back(next.x);
-            vertices.push_back(0.2f);
-            vertices.push_back(next.y);
+            // slightly higher than rock hulls
+            draw.line(Vector3(p.x, 0.2f, p.y), Vector3(next.x, 0.2f, next.y), green);
         }
-        
-        auto geom = threepp::BufferGeometry::create();
-        geom->setAttribute("position", FloatBufferAttribute::create(vertices, 3)); // same overload error but imma not question it
-        auto mat = threepp::LineBasicMaterial::create();
-        mat->color = threepp::Color::green;
-        auto line = threepp::LineSegments::create(geom, mat);
-        scene.add(line);
-        debugObjects.push_back(line);
     }
 }
@@ -3,51 +3,49 @@
 
 using namespace threepp;
 
-DigZone::DigZone(const Vector3& position, float radius) 
+DigZone::DigZone(const Vector3& position, float radius, int resolution) 
     : m_position(position), m_radius(radius) {
+    // A bit of margin around the mound so the carved edge doesn't hit the border
+    m_field = std::make_unique<Heightfield>(m_position, m_radius * 2.4f, resolution);
+    buildMound(1.0f);
+    m_initialVolume = m_field->volume();
     createVisual();
 }
 
-bool DigZone::isInZone(const Vector3& point) const {
-    // Use the actual pile shape: cylinder (h=1.5) + dome
-    const float r = m_radius * m_scale;            // effective base radius
-    const float hCyl = 1.5f * m_scale;             // cylinder height
-    const float rDome = (m_radius * 0.8f) * m_scale; // dome radius
+void DigZone::buildMound(float scale) {
+    // Same shape as the old meshes: cylinder (h=1.5) with a dome on top
+    const float r = m_radius * scale;
+    const float hCyl = 1.5f * scale;
+    const float rDome = (m_radius * 0.8f) * scale;
     const Vector3 center = m_position;
 
-    const float dx = point.x - center.x;
-    const float dz = point.z - center.z;
-    const float distXZ = std::sqrt(dx * dx + dz * dz);
-
-    // Inside cylinder volume 
-    const bool inCylinder = (point.y >= center.y) && (point.y <= center.y + hCyl) && (distXZ <= r + 0.05f);
+    m_field->fill([&](float x, float z) {
+        const float dx = x - center.x;
+        const float dz = z - center.z;
+        const float d2 = dx * dx + dz * dz;
+        if (d2 <= rDome * rDome) return center.y + hCyl + std::sqrt(rDome * rDome - d2);
+        if (d2 <= r * r) return center.y + hCyl;
+        return center.y;
+    });
+}
 
-    // Inside hemisphere dome
-    const float yRel = point.y - (center.y + hCyl);
-    const bool aboveCyl = point.y >= center.y + hCyl;
-    const bool inDome = aboveCyl && (distXZ * distXZ + yRel * yRel <= (rDome + 0.02f) * (rDome + 0.02f));
+bool DigZone::isInZone(const Vector3& point) const {
+    if (!m_field->contains(point.x, point.z)) return false;
+    if (point.y < m_position.y) return false; // under the ground
 
-    return inCylinder || inDome;
+    // Under the current soil surface (small tolerance like the old shape test), and there is soil
+    const float surface = m_field->heightAt(point.x, point.z);
+    return surface - m_position.y > 0.01f && point.y <= surface + 0.05f;
 }
 
 void DigZone::createVisual() {
     m_visual = Group::create();
     
-    // Create a mound/pile 
-    auto geometry = CylinderGeometry::create(m_radius, m_radius, 1.5f, 16);
     auto material = MeshPhongMaterial::create();
     material->color = Color(0.6f, 0.4f, 0.2f); // Brown sand/dirt color
-    
-    auto cylinder = Mesh::create(geometry, material);
-    cylinder->position.y = 0.75f; // Half height above ground
-    m_visual->add(cylinder);
-    
-    // Add a dome on top to make it look like a pile (at least not as boring lolz)
-    auto domeGeometry = SphereGeometry::create(m_radius * 0.8f, 16, 8, 0, threepp::math::PI * 2, 0, threepp::math::PI / 2);
-    auto dome = Mesh::create(domeGeometry, material);
-    dome->position.y = 1.5f;
-    m_visual->add(dome);
-    
+
+    m_mesh = std::make_unique<HeightfieldMesh>(*m_field, material);
+    m_visual->add(m_mesh->root());
     m_visual->position.copy(m_position);
 }
 
@@ -57,17 +55,17 @@ bool DigZone::dig(float fraction) {
     const float old = m_scale;
     m_scale = std::max(0.05f, m_scale * (1.0f - fraction));
     if (std::abs(m_scale - old) < 1e-4f) return false;
-    if (m_visual) {
-        m_visual->scale.set(m_scale, m_scale, m_scale);
-        m_visual->updateMatrixWorld(true);
-    }
+    buildMound(m_scale);
+    m_mesh->sync();
     return true;
 }
 
+float DigZone::excavate(const Vector3& from, const Vector3& to, float radius, float capacity) {
+    return m_field->excavate(from, to, radius, capacity);
+}
+
 void DigZone::reset() {
     m_scale = 1.0f;
-    if (m_visual) {
-        m_visual->scale.set(1.0f, 1.0f, 1.0f);
-        m_visual->updateMatrixWorld(true);
-    }
+    buildMound(1.0f);
+    m_mesh->sync();
 }
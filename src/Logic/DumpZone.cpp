@@ -5,6 +5,9 @@ using namespace threepp;
 
 DumpZone::DumpZone(const Vector3& position, float radius) 
     : m_position(position), m_radius(radius) {
+    // Pile sits on top of the platform (0.2 high) and can't spill past its edge
+    const Vector3 platformTop(m_position.x, m_position.y + 0.2f, m_position.z);
+    m_field = std::make_unique<Heightfield>(platformTop, m_radius * 2.0f, Settings::dumpFieldResolution_);
     createVisual();
 }
 
@@ -22,8 +25,22 @@ bool DumpZone::isInZone(const Vector3& point) const {
 }
 
 void DumpZone::recordDump() {
+    recordDump(m_position, Settings::bucketCapacity_);
+}
+
+void DumpZone::recordDump(const Vector3& position, float volume) {
     m_dumpCount++;
-    updatePileHeight();
+
+    // Keep the drop point on the platform, a bit in from the rim so the cone has room
+    Vector3 drop(position.x - m_position.x, 0.f, position.z - m_position.z);
+    const float inner = m_radius * 0.7f;
+    const float dist = std::sqrt(drop.x * drop.x + drop.z * drop.z);
+    if (dist > inner) {
+        drop.x *= inner / dist;
+        drop.z *= inner / dist;
+    }
+    m_field->deposit(Vector3(m_position.x + drop.x, 0.f, m_position.z + drop.z), volume);
+    m_pileMesh->sync(); // only the tiles under the new cone
 }
 
 void DumpZone::createVisual() {
@@ -38,35 +55,19 @@ void DumpZone::createVisual() {
     platform->position.y = 0.1f;
     m_visual->add(platform);
     
-    // Create the growing pile (starts empty)
-    auto pileGeom = CylinderGeometry::create(m_radius * 0.7f, m_radius * 0.7f, 0.01f, 16);
+    // Create the growing pile (starts empty, bare floor is hidden inside the platform)
     auto pileMat = MeshPhongMaterial::create();
     pileMat->color = Color(0.6f, 0.4f, 0.2f); // Brown material
     
-    m_pileMesh = Mesh::create(pileGeom, pileMat);
-    m_pileMesh->position.y = 0.21f;
-    m_visual->add(m_pileMesh);
+    m_pileMesh = std::make_unique<HeightfieldMesh>(*m_field, pileMat);
+    m_pileMesh->root()->position.y = 0.2f; // vertices are relative to the platform top
+    m_visual->add(m_pileMesh->root());
     
     m_visual->position.copy(m_position);
 }
 
-void DumpZone::updatePileHeight() {
-    if (!m_pileMesh) return;
-    
-    // Grow pile height with each dump ADJUST HERE CUS IT LOOKS DUMB RN
-    float height = 0.01f + m_dumpCount * 0.3f;
-    
-    // Recreate geometry with new height
-    auto newGeom = CylinderGeometry::create(m_radius * 0.7f, m_radius * 0.7f, height, 16);
-    m_pileMesh->setGeometry(newGeom);
-    m_pileMesh->position.y = 0.2f + height / 2.0f;
-}
-
 void DumpZone::reset() {
     m_dumpCount = 0;
-    if (m_pileMesh) {
-        auto newGeom = CylinderGeometry::create(m_radius * 0.7f, m_radius * 0.7f, 0.01f, 16);
-        m_pileMesh->setGeometry(newGeom);
-        m_pileMesh->position.y = 0.21f;
-    }
+    m_field->clear();
+    m_pileMesh->sync();
 }
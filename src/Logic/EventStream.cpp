@@ -0,0 +1,21 @@
+#include "EventStream.hpp"
+
+EventStream::Subscription& EventStream::subscribe() {
+    subscribers_.push_back(std::make_unique<Subscription>());
+    return *subscribers_.back();
+}
+
+void EventStream::publish(GameEventType type, const threepp::Vector3& position, int coinId) {
+    GameEvent event;
+    event.type = type;
+    event.coinId = coinId;
+    event.position = position;
+    event.timestamp = now_;
+
+    for (auto& subscriber : subscribers_) {
+        // A stalled consumer only loses its own events, the sim never waits
+        if (!subscriber->queue_.tryPush(event)) {
+            subscriber->dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
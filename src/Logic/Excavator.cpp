@@ -1,10 +1,12 @@
 #include "Excavator.hpp"
 #include "ParticleSystem.hpp"
 #include "CollisionWorld.hpp"
+#include "AssetRegistry.hpp"
 #include "Settings.hpp"
+#include "StartupProfiler.hpp"
+#include "FrameProfiler.hpp"
 
 #include <threepp/threepp.hpp>
-#include <threepp/loaders/OBJLoader.hpp>
 #include <threepp/math/Box3.hpp>
 #include <cmath>
 #include <iostream>
@@ -44,8 +46,14 @@ void alignEndAtPivotAxis(Object3D* obj, int axis, bool useMaxEnd = false) {
 Excavator::Excavator(const Paths& paths, Scene& scene)
     : scene_(scene) {
 
-    loadModels_(paths);
-    buildHierarchy_();
+    {
+        StartupProfiler::Scope phase("load");
+        loadModels_(paths);
+    }
+    {
+        StartupProfiler::Scope phase("hierarchy");
+        buildHierarchy_();
+    }
 
     scene_.add(root_);
 }
@@ -87,6 +95,7 @@ void Excavator::reset() {
     if (bucketPivot_) bucketPivot_->rotation.y = 0.0f;
 
     bucketLoaded_ = false;
+    bucketVolume_ = 0.0f;
     
     // Reset bucket color to gray
     if (bucketMesh_) {
@@ -104,25 +113,26 @@ void Excavator::reset() {
 }
 
 void Excavator::loadModels_(const Paths& paths) {
-    OBJLoader loader;
-
     std::cout << "Loading excavator models...\n";
 
+    // Left and right use the same track files, the registry parses each once and shares the geometry
+    auto load = [](const std::string& path) { return AssetRegistry::load(path).group; };
+
     // Load track animations
-    leftTrackMeshes_[0] = loader.load(paths.leftTrack0);
-    leftTrackMeshes_[1] = loader.load(paths.leftTrack1);
-    leftTrackMeshes_[2] = loader.load(paths.leftTrack2);
+    leftTrackMeshes_[0] = load(paths.leftTrack0);
+    leftTrackMeshes_[1] = load(paths.leftTrack1);
+    leftTrackMeshes_[2] = load(paths.leftTrack2);
 
-    rightTrackMeshes_[0] = loader.load(paths.rightTrack0);
-    rightTrackMeshes_[1] = loader.load(paths.rightTrack1);
-    rightTrackMeshes_[2] = loader.load(paths.rightTrack2);
+    rightTrackMeshes_[0] = load(paths.rightTrack0);
+    rightTrackMeshes_[1] = load(paths.rightTrack1);
+    rightTrackMeshes_[2] = load(paths.rightTrack2);
 
     // Load main parts
-    baseMesh_ = loader.load(paths.base);
-    bodyMesh_ = loader.load(paths.body);
-    arm1Mesh_ = loader.load(paths.arm1);
-    arm2Mesh_ = loader.load(paths.arm2);
-    bucketMesh_ = loader.load(paths.bucket);
+    baseMesh_ = load(paths.base);
+    bodyMesh_ = load(paths.body);
+    arm1Mesh_ = load(paths.arm1);
+    arm2Mesh_ = load(paths.arm2);
+    bucketMesh_ = load(paths.bucket);
 
     std::cout << "All models loaded.\n";
 }
@@ -349,12 +359,15 @@ void Excavator::update(float dt) {
     root_->updateMatrixWorld(true);
     
     // Resolve collisions for each mesh part
-    CollisionWorld::resolveExcavatorMeshCollisions(root_.get(),
-                                                     baseMesh_.get(),
-                                                     bodyMesh_.get(),
-                                                     arm1Mesh_.get(),
-                                                     arm2Mesh_.get(),
-                                                     bucketMesh_.get());
+    {
+        PROFILE_ZONE("collision");
+        CollisionWorld::resolveExcavatorMeshCollisions(root_.get(),
+                                                         baseMesh_.get(),
+                                                         bodyMesh_.get(),
+                                                         arm1Mesh_.get(),
+                                                         arm2Mesh_.get(),
+                                                         bucketMesh_.get());
+    }
 
     // Spawn dust particles when moving above threshold
     if (particleSystem_ && std::abs(linearSpeed) > speedThresholdForParticles_) {
@@ -603,8 +616,23 @@ void Excavator::loadBucket() {
     }
 }
 
-void Excavator::unloadBucket() {
+float Excavator::addToBucket(float volume) {
+    const float fits = std::clamp(volume, 0.0f, std::max(0.0f, getBucketCapacity() - bucketVolume_));
+    bucketVolume_ += fits;
+    return fits;
+}
+
+float Excavator::bucketFillFactor(float bucketAngle) {
+    // Curling the bucket (towards bucketMax_) tips the heap back into it
+    const float range = bucketMax_ - bucketMin_;
+    const float curl = range > 0.0f ? std::clamp((bucketAngle - bucketMin_) / range, 0.0f, 1.0f) : 1.0f;
+    return bucketMinFill_ + (1.0f - bucketMinFill_) * curl;
+}
+
+float Excavator::unloadBucket() {
     bucketLoaded_ = false;
+    const float dumped = bucketVolume_;
+    bucketVolume_ = 0.0f;
     
     // Reset bucket color to original (gray/metal)
     if (bucketMesh_) {
@@ -616,4 +644,5 @@ void Excavator::unloadBucket() {
             }
         });
     }
+    return dumped;
 }
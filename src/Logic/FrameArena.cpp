@@ -0,0 +1,67 @@
+#include "FrameArena.hpp"
+#include "Settings.hpp"
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+    // Uninitialised on purpose, scratch memory is always written before it's read
+    std::unique_ptr<std::byte[]> newBlock(size_t size) {
+        return std::unique_ptr<std::byte[]>(new std::byte[size]);
+    }
+}
+
+FrameArena::FrameArena(size_t capacity) {
+    capacity = std::max<size_t>(capacity, 64);
+    blocks_.reserve(8);
+    blocks_.push_back({newBlock(capacity), capacity});
+}
+
+FrameArena::~FrameArena() = default;
+
+FrameArena& FrameArena::frame() {
+    static FrameArena arena(static_cast<size_t>(Settings::frameArenaBytes_));
+    return arena;
+}
+
+size_t FrameArena::capacity() const {
+    size_t total = 0;
+    for (const auto& block : blocks_) total += block.size;
+    return total;
+}
+
+void FrameArena::reset() {
+    lastFrameBytes_ = frameHighWater_;
+    if (blocks_.size() > 1) {
+        // The frame fit in all the blocks together, so one block that size fits it next time
+        const size_t total = capacity();
+        blocks_.clear();
+        blocks_.push_back({newBlock(total), total});
+    }
+    current_ = 0;
+    offset_ = 0;
+    usedBefore_ = 0;
+    frameHighWater_ = 0;
+}
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment) {
+    for (;;) {
+        Block& block = blocks_[current_];
+        const auto base = reinterpret_cast<uintptr_t>(block.data.get());
+        const size_t start = ((base + offset_ + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1)) - base;
+        if (start + bytes <= block.size) {
+            offset_ = start + bytes;
+            frameHighWater_ = std::max(frameHighWater_, used());
+            highWater_ = std::max(highWater_, frameHighWater_);
+            return block.data.get() + start;
+        }
+
+        // Doesn't fit: on to the next block (still there after a rewind) or a new one
+        usedBefore_ += offset_;
+        offset_ = 0;
+        if (++current_ == blocks_.size()) {
+            const size_t size = std::max(blocks_.back().size, bytes + alignment);
+            blocks_.push_back({newBlock(size), size});
+            ++overflowBlocks_;
+        }
+    }
+}
@@ -0,0 +1,173 @@
+#include "FrameProfiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <string>
+
+namespace {
+    std::mutex s_namesMutex;
+    std::array<std::string, FrameProfiler::MaxZones> s_names;
+    size_t s_zoneCount = 0;
+
+    // One slot more than the history, the frame being recorded is never one of the completed ones
+    constexpr size_t Slots = FrameProfiler::HistoryFrames + 1;
+    std::array<FrameProfiler::Frame, Slots> s_frames;
+    size_t s_head = 0;  // frame being recorded
+    size_t s_count = 0; // completed frames in s_frames
+    FrameProfiler::Clock::time_point s_frameStart;
+    AllocationTracker::Counts s_frameAllocStart{};
+    bool s_inFrame = false;
+    double s_zoneCostNs = -1.0;
+
+    float msBetween(FrameProfiler::Clock::time_point a, FrameProfiler::Clock::time_point b) {
+        return std::chrono::duration<float, std::milli>(b - a).count();
+    }
+
+    void clearFrame(FrameProfiler::Frame& f) {
+        f.frameMs = 0.f;
+        f.zoneMs.fill(0.f);
+        f.zoneCalls.fill(0);
+        f.allocations = 0;
+        f.allocatedBytes = 0;
+        f.zoneAllocations.fill(0);
+        f.zoneAllocatedBytes.fill(0);
+        f.eventCount = 0; // events past the count are stale, never read
+    }
+}
+
+FrameProfiler::ZoneId FrameProfiler::registerZone(const char* name) {
+    std::lock_guard<std::mutex> lock(s_namesMutex);
+    for (size_t i = 0; i < s_zoneCount; ++i) {
+        if (s_names[i] == name) return static_cast<ZoneId>(i);
+    }
+    if (s_zoneCount == MaxZones) return static_cast<ZoneId>(MaxZones - 1); // out of slots, shares the last one
+    s_names[s_zoneCount] = name;
+    return static_cast<ZoneId>(s_zoneCount++);
+}
+
+const char* FrameProfiler::zoneName(ZoneId id) {
+    std::lock_guard<std::mutex> lock(s_namesMutex);
+    return id < s_zoneCount ? s_names[id].c_str() : "";
+}
+
+size_t FrameProfiler::zoneCount() {
+    std::lock_guard<std::mutex> lock(s_namesMutex);
+    return s_zoneCount;
+}
+
+void FrameProfiler::beginFrame() {
+    t_frameThread = true;
+    if (s_zoneCostNs < 0.0) calibrate_();
+    clearFrame(s_frames[s_head]);
+    s_depth = 0;
+    s_inFrame = true;
+    s_frameAllocStart = AllocationTracker::thread();
+    s_frameStart = Clock::now();
+}
+
+void FrameProfiler::endFrame() {
+    if (!s_inFrame) return;
+    s_inFrame = false;
+    if (!s_enabled) return; // paused: the slot is reused next frame
+    Frame& f = s_frames[s_head];
+    f.frameMs = msBetween(s_frameStart, Clock::now());
+    const auto allocEnd = AllocationTracker::thread();
+    f.allocations = static_cast<uint32_t>(allocEnd.allocations - s_frameAllocStart.allocations);
+    f.allocatedBytes = allocEnd.bytes - s_frameAllocStart.bytes;
+    s_head = (s_head + 1) % Slots;
+    s_count = std::min(s_count + 1, HistoryFrames);
+}
+
+void FrameProfiler::setEnabled(bool enabled) {
+    s_enabled = enabled;
+}
+
+bool FrameProfiler::enabled() {
+    return s_enabled;
+}
+
+size_t FrameProfiler::frameCount() {
+    return s_count;
+}
+
+const FrameProfiler::Frame& FrameProfiler::frame(size_t age) {
+    age = std::min(age, s_count > 0 ? s_count - 1 : 0);
+    return s_frames[(s_head + Slots - 1 - age) % Slots];
+}
+
+FrameProfiler::ZoneStats FrameProfiler::stats(ZoneId id) {
+    ZoneStats st;
+    if (id >= MaxZones) return st;
+    std::array<float, HistoryFrames> samples;
+    size_t n = 0;
+    double sum = 0.0;
+    double allocations = 0.0;
+    for (size_t age = 0; age < s_count; ++age) {
+        const Frame& f = frame(age);
+        if (f.zoneCalls[id] == 0) continue;
+        if (n == 0) st.lastMs = f.zoneMs[id];
+        samples[n++] = f.zoneMs[id];
+        sum += f.zoneMs[id];
+        allocations += f.zoneAllocations[id];
+    }
+    if (n == 0) return st;
+
+    st.frames = n;
+    st.avgMs = static_cast<float>(sum / static_cast<double>(n));
+    st.avgAllocations = static_cast<float>(allocations / static_cast<double>(n));
+    st.minMs = *std::min_element(samples.begin(), samples.begin() + n);
+    // Nearest rank: with fewer than 100 frames this is the worst one
+    const size_t rank = static_cast<size_t>(std::ceil(0.99 * static_cast<double>(n))) - 1;
+    std::nth_element(samples.begin(), samples.begin() + rank, samples.begin() + n);
+    st.p99Ms = samples[rank];
+    return st;
+}
+
+double FrameProfiler::zoneCostNs() {
+    if (s_zoneCostNs < 0.0 && !s_inFrame) calibrate_(); // not mid-frame, it would wipe the frame's zones
+    return std::max(0.0, s_zoneCostNs);
+}
+
+void FrameProfiler::reset() {
+    for (auto& f : s_frames) clearFrame(f);
+    s_head = 0;
+    s_count = 0;
+    s_depth = 0;
+}
+
+void FrameProfiler::record_(ZoneId id, uint8_t depth, Clock::time_point start, Clock::time_point end,
+                            const AllocationTracker::Counts& allocs) {
+    s_depth = depth;
+    if (!s_inFrame) return;
+    Frame& f = s_frames[s_head];
+    const float ms = msBetween(start, end);
+    f.zoneMs[id] += ms;
+    ++f.zoneCalls[id];
+    f.zoneAllocations[id] += static_cast<uint32_t>(allocs.allocations);
+    f.zoneAllocatedBytes[id] += allocs.bytes;
+    if (f.eventCount < MaxEventsPerFrame) f.events[f.eventCount++] = {id, depth, msBetween(s_frameStart, start), ms};
+}
+
+void FrameProfiler::calibrate_() {
+    // Time a batch of empty zones into the slot about to be recorded, then clear it again.
+    // Recording is forced on so it measures the real path
+    constexpr int Samples = 2000;
+    const bool wasFrameThread = t_frameThread;
+    const bool wasEnabled = s_enabled;
+    const bool wasInFrame = s_inFrame;
+    t_frameThread = true;
+    s_enabled = true;
+    s_inFrame = true;
+    s_frameStart = Clock::now();
+    const auto start = Clock::now();
+    for (int i = 0; i < Samples; ++i) {
+        Zone zone(0);
+    }
+    const auto end = Clock::now();
+    s_zoneCostNs = std::chrono::duration<double, std::nano>(end - start).count() / Samples;
+    clearFrame(s_frames[s_head]);
+    t_frameThread = wasFrameThread;
+    s_enabled = wasEnabled;
+    s_inFrame = wasInFrame;
+    s_depth = 0;
+}
@@ -0,0 +1,232 @@
+#include "Heightfield.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace threepp;
+
+Heightfield::Heightfield(const Vector3& center, float size, int resolution, int tileCells)
+    : center_(center),
+      size_(size),
+      resolution_(std::max(2, resolution)),
+      spacing_(size / (std::max(2, resolution) - 1)),
+      tileCells_(std::max(1, tileCells)) {
+    tilesPerSide_ = (resolution_ - 1 + tileCells_ - 1) / tileCells_;
+    heights_.assign(static_cast<size_t>(resolution_) * resolution_, center_.y);
+    tileDirty_.assign(static_cast<size_t>(tilesPerSide_) * tilesPerSide_, 0);
+    dirtyTiles_.reserve(tileDirty_.size());
+}
+
+float Heightfield::sampleClamped(int i, int j) const {
+    i = std::clamp(i, 0, resolution_ - 1);
+    j = std::clamp(j, 0, resolution_ - 1);
+    return sample(i, j);
+}
+
+int Heightfield::toI_(float x) const {
+    return static_cast<int>(std::lround((x - (center_.x - size_ * 0.5f)) / spacing_));
+}
+
+int Heightfield::toJ_(float z) const {
+    return static_cast<int>(std::lround((z - (center_.z - size_ * 0.5f)) / spacing_));
+}
+
+bool Heightfield::contains(float x, float z) const {
+    const float half = size_ * 0.5f;
+    return std::abs(x - center_.x) <= half && std::abs(z - center_.z) <= half;
+}
+
+float Heightfield::heightAt(float x, float z) const {
+    if (!contains(x, z)) return center_.y;
+
+    const float fx = (x - (center_.x - size_ * 0.5f)) / spacing_;
+    const float fz = (z - (center_.z - size_ * 0.5f)) / spacing_;
+    const int i = std::min(static_cast<int>(fx), resolution_ - 2);
+    const int j = std::min(static_cast<int>(fz), resolution_ - 2);
+    const float tx = fx - i;
+    const float tz = fz - j;
+
+    const float h0 = sample(i, j) * (1.f - tx) + sample(i + 1, j) * tx;
+    const float h1 = sample(i, j + 1) * (1.f - tx) + sample(i + 1, j + 1) * tx;
+    return h0 * (1.f - tz) + h1 * tz;
+}
+
+void Heightfield::fill(const std::function<float(float, float)>& heightFn) {
+    for (int j = 0; j < resolution_; ++j) {
+        for (int i = 0; i < resolution_; ++i) {
+            at_(i, j) = std::max(center_.y, heightFn(sampleX(i), sampleZ(j)));
+        }
+    }
+    markDirty(0, 0, resolution_ - 1, resolution_ - 1);
+}
+
+float Heightfield::excavate(const Vector3& from, const Vector3& to, float radius, float maxVolume) {
+    if (radius <= 0.f || maxVolume <= 0.f) return 0.f;
+
+    const int i0 = std::max(0, toI_(std::min(from.x, to.x) - radius));
+    const int i1 = std::min(resolution_ - 1, toI_(std::max(from.x, to.x) + radius));
+    const int j0 = std::max(0, toJ_(std::min(from.z, to.z) - radius));
+    const int j1 = std::min(resolution_ - 1, toJ_(std::max(from.z, to.z) + radius));
+    if (i0 > i1 || j0 > j1) return 0.f;
+
+    const Vector3 seg = to - from;
+    const float segLenSqXZ = seg.x * seg.x + seg.z * seg.z;
+    const float r2 = radius * radius;
+
+    // Pass 1: how deep the swept sphere cuts into each column (soil above it ends up in the bucket)
+    scratchIndex_.clear();
+    scratchAmount_.clear();
+    float wanted = 0.f;
+    for (int j = j0; j <= j1; ++j) {
+        const float z = sampleZ(j);
+        for (int i = i0; i <= i1; ++i) {
+            const float x = sampleX(i);
+            // Closest point of the sweep on XZ, exact for level strokes which is what digging mostly is
+            float t = 0.f;
+            if (segLenSqXZ > 1e-8f) {
+                t = std::clamp(((x - from.x) * seg.x + (z - from.z) * seg.z) / segLenSqXZ, 0.f, 1.f);
+            }
+            const float cx = from.x + seg.x * t;
+            const float cy = from.y + seg.y * t;
+            const float cz = from.z + seg.z * t;
+            const float d2 = (x - cx) * (x - cx) + (z - cz) * (z - cz);
+            if (d2 >= r2) continue;
+
+            const float bottom = std::max(center_.y, cy - std::sqrt(r2 - d2));
+            const float cut = sample(i, j) - bottom;
+            if (cut <= 0.f) continue;
+            scratchIndex_.push_back(j * resolution_ + i);
+            scratchAmount_.push_back(cut);
+            wanted += cut;
+        }
+    }
+    if (scratchIndex_.empty()) return 0.f;
+
+    // Pass 2: a nearly full bucket only takes its share from every column
+    const float cellArea = spacing_ * spacing_;
+    const float scale = std::min(1.f, maxVolume / (wanted * cellArea));
+    float removed = 0.f;
+    for (size_t k = 0; k < scratchIndex_.size(); ++k) {
+        const float cut = scratchAmount_[k] * scale;
+        heights_[scratchIndex_[k]] -= cut;
+        removed += cut;
+    }
+
+    markDirty(i0, j0, i1, j1);
+    return removed * cellArea;
+}
+
+float Heightfield::deposit(const Vector3& at, float volume, float reposeAngle) {
+    if (volume <= 0.f || !contains(at.x, at.z)) return 0.f;
+
+    const float slope = std::tan(std::clamp(reposeAngle, 0.05f, 1.5f));
+    const float cellArea = spacing_ * spacing_;
+
+    // Soil a cone with its apex at height `apex` adds on top of the current surface,
+    // only the window the cone can reach is visited
+    int i0 = 0, i1 = -1, j0 = 0, j1 = -1;
+    auto window = [&](float apex) {
+        const float reach = (apex - center_.y) / slope;
+        i0 = std::max(0, toI_(at.x - reach));
+        i1 = std::min(resolution_ - 1, toI_(at.x + reach));
+        j0 = std::max(0, toJ_(at.z - reach));
+        j1 = std::min(resolution_ - 1, toJ_(at.z + reach));
+    };
+    auto added = [&](float apex) {
+        window(apex);
+        double sum = 0.0;
+        for (int j = j0; j <= j1; ++j) {
+            const float dz = sampleZ(j) - at.z;
+            for (int i = i0; i <= i1; ++i) {
+                const float dx = sampleX(i) - at.x;
+                const float fill = apex - slope * std::sqrt(dx * dx + dz * dz) - sample(i, j);
+                if (fill > 0.f) sum += fill;
+            }
+        }
+        return static_cast<float>(sum * cellArea);
+    };
+
+    // Bracket the apex: start from a cone of this volume on flat ground, grow until it holds enough
+    // (it has to be higher when it lands on an existing heap or against the patch border)
+    float lo = heightAt(at.x, at.z);
+    float hi = lo + std::cbrt(3.f * volume * slope * slope / 3.14159265f) + spacing_;
+    for (int grow = 0; grow < 32 && added(hi) < volume; ++grow) {
+        lo = hi;
+        hi += (hi - center_.y);
+    }
+    for (int iter = 0; iter < 40; ++iter) {
+        const float mid = 0.5f * (lo + hi);
+        if (added(mid) < volume) lo = mid; else hi = mid;
+    }
+
+    // Apply, scaled so the volume comes out exact despite the bisection tolerance
+    const float placed = added(hi);
+    if (placed <= 0.f) return 0.f;
+    const float scale = volume / placed;
+    for (int j = j0; j <= j1; ++j) {
+        const float dz = sampleZ(j) - at.z;
+        for (int i = i0; i <= i1; ++i) {
+            const float dx = sampleX(i) - at.x;
+            const float fill = hi - slope * std::sqrt(dx * dx + dz * dz) - sample(i, j);
+            if (fill > 0.f) at_(i, j) += fill * scale;
+        }
+    }
+
+    markDirty(i0, j0, i1, j1);
+    return volume;
+}
+
+void Heightfield::clear() {
+    std::fill(heights_.begin(), heights_.end(), center_.y);
+    markDirty(0, 0, resolution_ - 1, resolution_ - 1);
+}
+
+float Heightfield::volume() const {
+    double sum = 0.0;
+    for (float h : heights_) sum += h - center_.y;
+    return static_cast<float>(sum * spacing_ * spacing_);
+}
+
+void Heightfield::footprint(std::vector<Vector2>& out, float minHeight) const {
+    out.clear();
+    const float threshold = center_.y + minHeight;
+    for (int j = 0; j < resolution_; ++j) {
+        int first = -1;
+        int last = -1;
+        for (int i = 0; i < resolution_; ++i) {
+            if (sample(i, j) > threshold) {
+                if (first < 0) first = i;
+                last = i;
+            }
+        }
+        if (first < 0) continue;
+        out.emplace_back(sampleX(first), sampleZ(j));
+        if (last != first) out.emplace_back(sampleX(last), sampleZ(j));
+    }
+}
+
+void Heightfield::markDirty(int i0, int j0, int i1, int j1) {
+    // Normals use the neighbours, so the vertices one sample out are affected as well
+    const int vi0 = std::max(0, i0 - 1);
+    const int vj0 = std::max(0, j0 - 1);
+    const int vi1 = std::min(resolution_ - 1, i1 + 1);
+    const int vj1 = std::min(resolution_ - 1, j1 + 1);
+
+    // Tile t owns vertices [t * tileCells_, (t + 1) * tileCells_] (edges are shared)
+    auto firstTile = [&](int v) { return std::max(0, (v + tileCells_ - 1) / tileCells_ - 1); };
+    auto lastTile = [&](int v) { return std::min(tilesPerSide_ - 1, v / tileCells_); };
+
+    for (int tz = firstTile(vj0); tz <= lastTile(vj1); ++tz) {
+        for (int tx = firstTile(vi0); tx <= lastTile(vi1); ++tx) {
+            const int index = tz * tilesPerSide_ + tx;
+            if (!tileDirty_[index]) {
+                tileDirty_[index] = 1;
+                dirtyTiles_.push_back(index);
+            }
+        }
+    }
+}
+
+void Heightfield::clearDirty() {
+    for (int index : dirtyTiles_) tileDirty_[index] = 0;
+    dirtyTiles_.clear();
+}
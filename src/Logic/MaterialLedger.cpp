@@ -0,0 +1,33 @@
+#include "MaterialLedger.hpp"
+#include <algorithm>
+#include <cmath>
+
+void MaterialLedger::advance(float dt) {
+    if (dt <= 0.f) return;
+    elapsed_ += dt;
+    recentRate_ *= std::exp(-dt / std::max(Settings::productivityWindow_, 0.001f));
+}
+
+void MaterialLedger::recordDug(float volume) {
+    if (volume > 0.f) dug_ += volume;
+}
+
+float MaterialLedger::recordDumped(float volume) {
+    const float booked = std::clamp(volume, 0.f, getInBucket());
+    dumped_ += booked;
+    // Each dump is an impulse into the moving average: it adds volume/window to the rate
+    recentRate_ += booked / std::max(Settings::productivityWindow_, 0.001f);
+    return booked;
+}
+
+float MaterialLedger::getProductivity() const {
+    if (elapsed_ <= 0.f) return 0.f;
+    return dumped_ / elapsed_ * 3600.f;
+}
+
+void MaterialLedger::reset() {
+    dug_ = 0.f;
+    dumped_ = 0.f;
+    elapsed_ = 0.f;
+    recentRate_ = 0.f;
+}
@@ -0,0 +1,538 @@
+#include "MeshCache.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+#include <threepp/threepp.hpp>
+#include <threepp/loaders/OBJLoader.hpp>
+#include "CollisionWorld.hpp"
+#include "Settings.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace threepp;
+
+namespace {
+    constexpr char Magic[4] = {'E', 'X', 'M', 'C'};
+
+    MeshCache::Stats s_stats;
+    std::mutex s_statsMutex;
+
+    // Read-only view of a whole file, unmapped when it goes out of scope
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::filesystem::path& path) {
+#ifdef _WIN32
+            file_ = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file_ == INVALID_HANDLE_VALUE) return;
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0) return;
+            mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!mapping_) return;
+            data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+            if (data_) size_ = static_cast<size_t>(size.QuadPart);
+#else
+            fd_ = ::open(path.c_str(), O_RDONLY);
+            if (fd_ < 0) return;
+            struct stat st{};
+            if (::fstat(fd_, &st) != 0 || st.st_size == 0) return;
+            void* p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd_, 0);
+            if (p == MAP_FAILED) return;
+            data_ = static_cast<const uint8_t*>(p);
+            size_ = static_cast<size_t>(st.st_size);
+#endif
+        }
+
+        ~MappedFile() {
+#ifdef _WIN32
+            if (data_) UnmapViewOfFile(data_);
+            if (mapping_) CloseHandle(mapping_);
+            if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+#else
+            if (data_) ::munmap(const_cast<uint8_t*>(data_), size_);
+            if (fd_ >= 0) ::close(fd_);
+#endif
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const uint8_t* data() const { return data_; }
+        size_t size() const { return size_; }
+
+    private:
+        const uint8_t* data_{nullptr};
+        size_t size_{0};
+#ifdef _WIN32
+        HANDLE file_{INVALID_HANDLE_VALUE};
+        HANDLE mapping_{nullptr};
+#else
+        int fd_{-1};
+#endif
+    };
+
+    // Bounds-checked cursor over the mapped bytes
+    struct Reader {
+        const uint8_t* p;
+        const uint8_t* end;
+
+        bool bytes(void* out, size_t n) {
+            if (static_cast<size_t>(end - p) < n) return false;
+            std::memcpy(out, p, n);
+            p += n;
+            return true;
+        }
+        template<class T>
+        bool get(T& out) { return bytes(&out, sizeof(T)); }
+        // count Ts straight into out. Every array in the file starts on a 4 byte boundary (names
+        // are padded) and the mapping is page aligned, so the bytes can be read as T in place
+        template<class T>
+        bool array(std::vector<T>& out, size_t count) {
+            if (static_cast<size_t>(end - p) / sizeof(T) < count) return false;
+            const auto* first = reinterpret_cast<const T*>(p);
+            out.assign(first, first + count);
+            p += count * sizeof(T);
+            return true;
+        }
+        bool skip(size_t n) {
+            if (static_cast<size_t>(end - p) < n) return false;
+            p += n;
+            return true;
+        }
+    };
+
+    template<class T>
+    void put(std::ofstream& out, const T& value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    void put(std::ofstream& out, const Vector3& v) {
+        const float xyz[3] = {v.x, v.y, v.z};
+        put(out, xyz);
+    }
+    bool get(Reader& in, Vector3& v) {
+        float xyz[3];
+        if (!in.get(xyz)) return false;
+        v = Vector3(xyz[0], xyz[1], xyz[2]);
+        return true;
+    }
+
+    size_t padTo4(size_t n) { return (4 - n % 4) % 4; }
+
+    uint64_t fnv1a(const uint8_t* data, size_t size, uint64_t h = 1469598103934665603ull) {
+        for (size_t i = 0; i < size; ++i) {
+            h ^= data[i];
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    double msSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+uint64_t MeshCache::hashFile(const std::filesystem::path& path) {
+    MappedFile file(path);
+    if (!file.data()) return 0;
+    return fnv1a(file.data(), file.size());
+}
+
+uint64_t MeshCache::sourceKey(const std::filesystem::path& objPath, bool loadMtl) {
+    uint64_t key = hashFile(objPath);
+    if (key == 0 || !loadMtl) return key;
+    // Colours come from the MTL, editing it has to invalidate the cache too
+    auto mtlPath = objPath;
+    mtlPath.replace_extension(".mtl");
+    const uint64_t mtl = hashFile(mtlPath);
+    const uint8_t tag = 1;
+    key = fnv1a(reinterpret_cast<const uint8_t*>(&mtl), sizeof(mtl), key);
+    return fnv1a(&tag, 1, key);
+}
+
+std::filesystem::path MeshCache::cachePathFor(const std::filesystem::path& objPath, bool loadMtl) {
+    // Stem for readability plus a short hash of the full path, so same-named OBJs in different
+    // folders don't share (and keep overwriting) one file
+    std::error_code ec;
+    auto source = std::filesystem::weakly_canonical(objPath, ec);
+    if (ec) source = std::filesystem::absolute(objPath, ec);
+    const auto pathString = source.generic_string();
+    const uint64_t pathHash = fnv1a(reinterpret_cast<const uint8_t*>(pathString.data()), pathString.size());
+    char suffix[10];
+    std::snprintf(suffix, sizeof(suffix), "-%08x", static_cast<uint32_t>(pathHash ^ (pathHash >> 32)));
+    return std::filesystem::path(Settings::meshCacheDir_) /
+           (objPath.stem().string() + suffix + (loadMtl ? ".mtl.meshbin" : ".meshbin"));
+}
+
+MeshCache::Part MeshCache::weld(const std::string& name, const std::array<float, 3>& color,
+                                const std::vector<float>& positions, const std::vector<float>& normals,
+                                const std::vector<uint32_t>& index) {
+    Part part;
+    part.name = name;
+    part.color = color;
+
+    const size_t count = positions.size() / 3;
+    const bool hasNormals = normals.size() == positions.size();
+
+    // Bit patterns of the six floats (position, normal), so only exact duplicates are shared
+    struct Key {
+        std::array<uint32_t, 6> bits;
+        bool operator==(const Key& o) const { return bits == o.bits; }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& k) const {
+            return static_cast<size_t>(fnv1a(reinterpret_cast<const uint8_t*>(k.bits.data()), sizeof(k.bits)));
+        }
+    };
+    std::unordered_map<Key, uint32_t, KeyHash> seen;
+    seen.reserve(count);
+
+    std::vector<uint32_t> remap(count);
+    part.positions.reserve(count * 3);
+    part.normals.reserve(count * 3);
+    for (size_t i = 0; i < count; ++i) {
+        float v[6] = {positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2], 0.f, 0.f, 0.f};
+        if (hasNormals) std::copy_n(&normals[i * 3], 3, v + 3);
+        Key key;
+        std::memcpy(key.bits.data(), v, sizeof(v));
+        const auto [it, added] = seen.emplace(key, static_cast<uint32_t>(part.vertexCount()));
+        if (added) {
+            part.positions.insert(part.positions.end(), v, v + 3);
+            part.normals.insert(part.normals.end(), v + 3, v + 6);
+        }
+        remap[i] = it->second;
+    }
+
+    if (index.empty()) {
+        part.indices = std::move(remap);
+    } else {
+        part.indices.reserve(index.size());
+        for (const auto i : index) part.indices.push_back(remap[i]);
+    }
+    return part;
+}
+
+void MeshCache::computeBounds(MeshData& data) {
+    const float inf = std::numeric_limits<float>::infinity();
+    data.boundsMin = Vector3(inf, inf, inf);
+    data.boundsMax = Vector3(-inf, -inf, -inf);
+    std::vector<Vector2> pts;
+
+    for (auto& part : data.parts) {
+        part.boundsMin = Vector3(inf, inf, inf);
+        part.boundsMax = Vector3(-inf, -inf, -inf);
+        for (size_t i = 0; i < part.positions.size(); i += 3) {
+            const float* v = &part.positions[i];
+            part.boundsMin = Vector3(std::min(part.boundsMin.x, v[0]), std::min(part.boundsMin.y, v[1]), std::min(part.boundsMin.z, v[2]));
+            part.boundsMax = Vector3(std::max(part.boundsMax.x, v[0]), std::max(part.boundsMax.y, v[1]), std::max(part.boundsMax.z, v[2]));
+            pts.emplace_back(v[0], v[2]);
+        }
+        if (part.positions.empty()) continue;
+        data.boundsMin = Vector3(std::min(data.boundsMin.x, part.boundsMin.x), std::min(data.boundsMin.y, part.boundsMin.y), std::min(data.boundsMin.z, part.boundsMin.z));
+        data.boundsMax = Vector3(std::max(data.boundsMax.x, part.boundsMax.x), std::max(data.boundsMax.y, part.boundsMax.y), std::max(data.boundsMax.z, part.boundsMax.z));
+    }
+    data.hull = CollisionWorld::footprintHull(std::move(pts));
+}
+
+bool MeshCache::write(const std::filesystem::path& path, const MeshData& data, uint64_t key) {
+    std::error_code ec;
+    if (path.has_parent_path()) std::filesystem::create_directories(path.parent_path(), ec);
+
+    // Written next to it and renamed, a crash mid-write never leaves a half file under the real name
+    auto tmp = path;
+    tmp += ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+
+        out.write(Magic, sizeof(Magic));
+        put(out, Version);
+        put(out, key);
+        put(out, static_cast<uint32_t>(data.parts.size()));
+        put(out, static_cast<uint32_t>(data.hull.size()));
+        put(out, data.boundsMin);
+        put(out, data.boundsMax);
+        for (const auto& p : data.hull) {
+            put(out, p.x);
+            put(out, p.y);
+        }
+
+        const char zeros[4] = {};
+        for (const auto& part : data.parts) {
+            put(out, static_cast<uint32_t>(part.name.size()));
+            put(out, static_cast<uint32_t>(part.vertexCount()));
+            put(out, static_cast<uint32_t>(part.indices.size()));
+            put(out, part.color);
+            put(out, part.boundsMin);
+            put(out, part.boundsMax);
+            out.write(part.name.data(), static_cast<std::streamsize>(part.name.size()));
+            out.write(zeros, static_cast<std::streamsize>(padTo4(part.name.size())));
+            out.write(reinterpret_cast<const char*>(part.positions.data()), static_cast<std::streamsize>(part.positions.size() * sizeof(float)));
+            out.write(reinterpret_cast<const char*>(part.normals.data()), static_cast<std::streamsize>(part.normals.size() * sizeof(float)));
+            out.write(reinterpret_cast<const char*>(part.indices.data()), static_cast<std::streamsize>(part.indices.size() * sizeof(uint32_t)));
+        }
+        if (!out) return false;
+    }
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+std::optional<MeshCache::MeshData> MeshCache::read(const std::filesystem::path& path, uint64_t key) {
+    MappedFile file(path);
+    if (!file.data()) return std::nullopt;
+    Reader in{file.data(), file.data() + file.size()};
+
+    char magic[4];
+    uint32_t version, partCount, hullCount;
+    uint64_t fileKey;
+    MeshData data;
+    if (!in.bytes(magic, sizeof(magic)) || std::memcmp(magic, Magic, sizeof(Magic)) != 0) return std::nullopt;
+    if (!in.get(version) || version != Version) return std::nullopt;
+    if (!in.get(fileKey) || fileKey != key) return std::nullopt;
+    if (!in.get(partCount) || !in.get(hullCount)) return std::nullopt;
+    if (!get(in, data.boundsMin) || !get(in, data.boundsMax)) return std::nullopt;
+    if (static_cast<size_t>(in.end - in.p) < hullCount * 2 * sizeof(float)) return std::nullopt;
+    data.hull.reserve(hullCount);
+    for (uint32_t i = 0; i < hullCount; ++i) {
+        float xz[2];
+        in.get(xz);
+        data.hull.emplace_back(xz[0], xz[1]);
+    }
+
+    data.parts.resize(partCount);
+    for (auto& part : data.parts) {
+        uint32_t nameLength, vertexCount, indexCount;
+        if (!in.get(nameLength) || !in.get(vertexCount) || !in.get(indexCount)) return std::nullopt;
+        if (!in.get(part.color) || !get(in, part.boundsMin) || !get(in, part.boundsMax)) return std::nullopt;
+        const size_t vertexBytes = static_cast<size_t>(vertexCount) * 6 * sizeof(float); // positions + normals
+        const size_t indexBytes = static_cast<size_t>(indexCount) * sizeof(uint32_t);
+        // Sizes are checked against what's left before anything is allocated
+        if (static_cast<size_t>(in.end - in.p) < nameLength + padTo4(nameLength) + vertexBytes + indexBytes) return std::nullopt;
+
+        part.name.assign(reinterpret_cast<const char*>(in.p), nameLength);
+        in.skip(nameLength + padTo4(nameLength));
+        in.array(part.positions, static_cast<size_t>(vertexCount) * 3);
+        in.array(part.normals, static_cast<size_t>(vertexCount) * 3);
+        in.array(part.indices, indexCount);
+        for (const auto i : part.indices) {
+            if (i >= vertexCount) return std::nullopt;
+        }
+    }
+    if (in.p != in.end) return std::nullopt;
+    return data;
+}
+
+std::optional<MeshCache::MeshData> MeshCache::parseObj(const std::filesystem::path& path, bool loadMtl) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return std::nullopt;
+    const std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    std::vector<float> positions, normals;          // as listed in the file
+    std::unordered_map<std::string, std::array<float, 3>> colors; // MTL diffuse by material name
+
+    // Triangle soup of the part being read, welded when the next one starts
+    MeshData data;
+    std::string name;
+    std::array<float, 3> color{1.f, 1.f, 1.f};
+    std::vector<float> soupPositions, soupNormals;
+    auto flush = [&] {
+        if (!soupPositions.empty()) data.parts.push_back(weld(name, color, soupPositions, soupNormals));
+        soupPositions.clear();
+        soupNormals.clear();
+    };
+
+    // Index as written (1-based, negative counts back from the end), -1 if it's out of range
+    auto resolve = [](long i, size_t count) -> long {
+        const long n = static_cast<long>(count);
+        const long r = i < 0 ? n + i : i - 1;
+        return (r >= 0 && r < n) ? r : -1;
+    };
+
+    std::vector<std::pair<long, long>> face; // position, normal (-1 if none)
+    const char* p = text.c_str();
+    while (*p) {
+        const char* line = p;
+        while (*p && *p != '\n') ++p;
+        const char* lineEnd = p;
+        if (*p) ++p;
+        while (line < lineEnd && (*line == ' ' || *line == '\t')) ++line;
+        if (line == lineEnd || *line == '#') continue;
+        const std::string_view l(line, static_cast<size_t>(lineEnd - line));
+        auto rest = [&](size_t skip) {
+            std::string r(l.substr(std::min(skip, l.size())));
+            while (!r.empty() && (r.back() == '\r' || r.back() == ' ' || r.back() == '\t')) r.pop_back();
+            const size_t first = r.find_first_not_of(" \t");
+            return first == std::string::npos ? std::string() : r.substr(first);
+        };
+
+        if (l.rfind("v ", 0) == 0 || l.rfind("vn ", 0) == 0) {
+            auto& out = l[1] == 'n' ? normals : positions;
+            char* q = const_cast<char*>(line) + (l[1] == 'n' ? 2 : 1);
+            for (int k = 0; k < 3; ++k) out.push_back(std::strtof(q, &q));
+        } else if (l.rfind("f ", 0) == 0) {
+            face.clear();
+            const char* q = line + 1;
+            while (q < lineEnd) {
+                while (q < lineEnd && (*q == ' ' || *q == '\t' || *q == '\r')) ++q;
+                if (q >= lineEnd) break;
+                char* e;
+                const long v = std::strtol(q, &e, 10);
+                if (e == q) break;
+                q = e;
+                long n = 0;
+                if (q < lineEnd && *q == '/') {
+                    ++q;
+                    if (q < lineEnd && *q != '/') std::strtol(q, &e, 10), q = e; // texture coordinate, unused
+                    if (q < lineEnd && *q == '/') {
+                        ++q;
+                        n = std::strtol(q, &e, 10);
+                        q = e;
+                    }
+                }
+                face.emplace_back(resolve(v, positions.size() / 3), n != 0 ? resolve(n, normals.size() / 3) : -1);
+            }
+            // Fan out polygons, faces without normals get the flat one
+            for (size_t k = 2; k < face.size(); ++k) {
+                const std::pair<long, long> tri[3] = {face[0], face[k - 1], face[k]};
+                if (tri[0].first < 0 || tri[1].first < 0 || tri[2].first < 0) continue;
+                const float* a = &positions[tri[0].first * 3];
+                const float* b = &positions[tri[1].first * 3];
+                const float* c = &positions[tri[2].first * 3];
+                float flat[3] = {(b[1] - a[1]) * (c[2] - a[2]) - (b[2] - a[2]) * (c[1] - a[1]),
+                                 (b[2] - a[2]) * (c[0] - a[0]) - (b[0] - a[0]) * (c[2] - a[2]),
+                                 (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0])};
+                const float len = std::sqrt(flat[0] * flat[0] + flat[1] * flat[1] + flat[2] * flat[2]);
+                if (len > 0.f) for (float& f : flat) f /= len;
+                for (const auto& [vi, ni] : tri) {
+                    soupPositions.insert(soupPositions.end(), &positions[vi * 3], &positions[vi * 3] + 3);
+                    if (ni >= 0) soupNormals.insert(soupNormals.end(), &normals[ni * 3], &normals[ni * 3] + 3);
+                    else soupNormals.insert(soupNormals.end(), flat, flat + 3);
+                }
+            }
+        } else if (l.rfind("g ", 0) == 0 || l.rfind("o ", 0) == 0) {
+            flush();
+            name = rest(2);
+        } else if (l.rfind("usemtl ", 0) == 0) {
+            flush();
+            const auto it = colors.find(rest(7));
+            color = it != colors.end() ? it->second : std::array<float, 3>{1.f, 1.f, 1.f};
+        } else if (loadMtl && l.rfind("mtllib ", 0) == 0) {
+            std::ifstream mtl(path.parent_path() / rest(7));
+            std::string mtlLine, current;
+            while (std::getline(mtl, mtlLine)) {
+                std::istringstream in(mtlLine);
+                std::string tag;
+                in >> tag;
+                if (tag == "newmtl") {
+                    in >> current;
+                } else if (tag == "Kd") {
+                    auto& kd = colors[current];
+                    in >> kd[0] >> kd[1] >> kd[2];
+                }
+            }
+        }
+    }
+    flush();
+    if (data.parts.empty()) return std::nullopt;
+    computeBounds(data);
+    return data;
+}
+
+std::shared_ptr<Group> MeshCache::toGroup(MeshData data) {
+    auto group = Group::create();
+    for (auto& part : data.parts) {
+        // The arrays already have threepp's layout, the attributes take them over without a copy
+        auto geometry = BufferGeometry::create();
+        geometry->setAttribute("position", FloatBufferAttribute::create(std::move(part.positions), 3));
+        geometry->setAttribute("normal", FloatBufferAttribute::create(std::move(part.normals), 3));
+        geometry->setIndex(IntBufferAttribute::create(std::move(part.indices), 1));
+        geometry->boundingBox = Box3(part.boundsMin, part.boundsMax); // no pass over the vertices for it
+
+        auto material = MeshPhongMaterial::create();
+        material->color = Color(part.color[0], part.color[1], part.color[2]);
+
+        auto mesh = Mesh::create(geometry, material);
+        mesh->name = part.name;
+        group->add(mesh);
+    }
+    return group;
+}
+
+std::optional<MeshCache::MeshData> MeshCache::loadData(const std::string& objPath, bool loadMtl) {
+    const auto start = std::chrono::steady_clock::now();
+    const uint64_t key = sourceKey(objPath, loadMtl);
+    if (key == 0) {
+        std::cout << "MeshCache: couldn't read " << objPath << "\n";
+        return std::nullopt;
+    }
+
+    const auto cachePath = cachePathFor(objPath, loadMtl);
+    auto data = read(cachePath, key);
+    const bool hit = data.has_value();
+    if (!hit) {
+        data = parseObj(objPath, loadMtl);
+        if (data && !write(cachePath, *data, key)) {
+            std::cout << "MeshCache: couldn't write " << cachePath.string() << "\n";
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(s_statsMutex);
+    (hit ? s_stats.cacheMs : s_stats.parseMs) += msSince(start);
+    ++(hit ? s_stats.hits : s_stats.misses);
+    return data;
+}
+
+MeshCache::Model MeshCache::toModel(MeshData data) {
+    Model model;
+    model.boundsMin = data.boundsMin;
+    model.boundsMax = data.boundsMax;
+    model.hull = std::move(data.hull);
+    model.group = toGroup(std::move(data));
+    return model;
+}
+
+MeshCache::Model MeshCache::load(const std::string& objPath, bool loadMtl) {
+    if (!Settings::meshCache_) {
+        const auto start = std::chrono::steady_clock::now();
+        Model model;
+        OBJLoader loader;
+        model.group = loader.load(objPath, loadMtl);
+        std::lock_guard<std::mutex> lock(s_statsMutex);
+        s_stats.parseMs += msSince(start);
+        ++s_stats.misses;
+        return model;
+    }
+
+    auto data = loadData(objPath, loadMtl);
+    if (!data) return {};
+    return toModel(std::move(*data));
+}
+
+MeshCache::Stats MeshCache::getStats() {
+    std::lock_guard<std::mutex> lock(s_statsMutex);
+    return s_stats;
+}
+
+void MeshCache::resetStats() {
+    std::lock_guard<std::mutex> lock(s_statsMutex);
+    s_stats = {};
+}
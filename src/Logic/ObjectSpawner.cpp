@@ -4,10 +4,11 @@
 #include <numbers>
 #include <iostream>
 #include <threepp/loaders/TextureLoader.hpp>
-#include <threepp/loaders/OBJLoader.hpp>
 #include <filesystem>
 #include <string>
+#include <algorithm>
 #include "CollisionWorld.hpp"
+#include "PoissonDiskSampler.hpp"
 #include "Settings.hpp"
 
 using namespace threepp;
@@ -39,13 +40,40 @@ ObjectSpawner::ObjectSpawner(Scene& scene, const SpawnConfig& config)
 void ObjectSpawner::generateEnvironment() {
     // Reset colliders when regenerating
     CollisionWorld::clear();
+    clearProps_();
+    rng_.seed(config_.randomSeed); // same seed, same layout every time
     spawnGroundPlane_();
-    spawnPerimeterRocks_();
+
+    const PropTemplate rock = PropTemplate::loadRock();
+    const PropTemplate crate = PropTemplate::crate();
+    const PropTemplate rail = PropTemplate::loadRail();
+
+    // Everything inside the perimeter comes out of one Poisson-disk sampler: each class keeps its own
+    // spacing and avoids the keep-out areas and every solid prop an earlier class put down.
+    // Big things first so the small ones fill in around them.
+    PoissonDiskSampler sampler(config_.arenaRadius * 0.8f, config_.randomSeed); // inside the perimeter rocks
+    for (const auto& k : config_.keepOut) sampler.addObstacle(k.x, k.z, k.radius);
+    if (config_.perimeterWall) placePerimeterRocks_(rock, sampler);
+    scatterProps_(PropClass::Boulder, config_.largeObjectCount, rock, 0.08f, 0.12f, config_.largeSpacing, true, sampler);
+    if (!rail.empty()) {
+        scatterProps_(PropClass::Rail, config_.railCount, rail, 1.f, 1.f, config_.railSpacing, true, sampler);
+    }
+    scatterProps_(PropClass::Crate, config_.mediumObjectCount, crate, 0.7f, 1.1f, config_.mediumSpacing, true, sampler);
+    scatterProps_(PropClass::Debris, config_.smallObjectCount, rock, 0.01f, 0.025f, config_.smallSpacing, false, sampler); // drive over it
+
+    buildInstances_(rock, {PropClass::PerimeterRock, PropClass::Boulder, PropClass::Debris});
+    buildInstances_(crate, {PropClass::Crate});
+    buildInstances_(rail, {PropClass::Rail});
+
+    std::cout << "Props: " << stats_.instances << " instances in " << stats_.drawCalls
+              << " draw calls, " << stats_.colliders << " colliders\n";
 }
 
 void ObjectSpawner::spawnGroundPlane_() {
+    if (ground_) scene_.remove(*ground_);
+
     // Circle as a ground plane so you dont see random corners when peeking over hte rocks
-    auto groundGeometry = CircleGeometry::create(config_.arenaRadius * 1.5f, 64);
+    auto groundGeometry = CircleGeometry::create(groundRadius(), 64);
     auto groundMaterial = MeshStandardMaterial::create();
     groundMaterial->roughness = 0.9f;
 
@@ -63,54 +91,86 @@ void ObjectSpawner::spawnGroundPlane_() {
         groundMaterial->color = Color(0.4f, 0.35f, 0.3f); // Fallback brown
     }
 
-    auto ground = Mesh::create(groundGeometry, groundMaterial);
-    ground->rotation.x = -math::PI / 2.0f; // Flat on XZ plane
-    ground->receiveShadow = true;
-    scene_.add(ground);
+    ground_ = Mesh::create(groundGeometry, groundMaterial);
+    ground_->rotation.x = -math::PI / 2.0f; // Flat on XZ plane
+    ground_->receiveShadow = true;
+    scene_.add(ground_);
 }
 
-void ObjectSpawner::spawnPerimeterRocks_() {
-    std::cout << "Loading perimeter rock from models/Rock2.obj (with .mtl)...\n";
-    OBJLoader loader;
-    auto rockGroup = loader.load(resolveAssetPath("models/Rock2.obj"), true);
-    if (!rockGroup) {
-        std::cout << "Failed to load Rock2.obj. Skipping perimeter rocks.\n";
-        return;
-    }
-
-    // The exported MTL sets Kd (diffuse) to black and has no texture.
-    // Override with a rock-like PBR material so meshes aren't black.
-    auto rockMat = MeshStandardMaterial::create();
-    rockMat->color = Color(0.6f, 0.6f, 0.6f);
-    rockMat->roughness = 0.95f;
-    rockMat->metalness = 0.0f;
-    rockGroup->traverseType<Mesh>([&](Mesh& m) {
-        m.setMaterial(rockMat);
-        m.castShadow = true;
-        m.receiveShadow = true;
-    });
+void ObjectSpawner::clearProps_() {
+    for (auto& mesh : propMeshes_) scene_.remove(*mesh);
+    propMeshes_.clear();
+    props_.clear();
+    stats_ = {};
+}
 
+void ObjectSpawner::placePerimeterRocks_(const PropTemplate& rock, PoissonDiskSampler& sampler) {
     const int rockCount = 20; // a few more for coverage
     const float perimeterRadius = config_.arenaRadius * 1.0f; // bring closer to plane edge
     const float rockScale = 0.5f; // much larger scale
 
+    // Random rotation (i mean this doesnt rly matter anymore since i changed it to be circular rocks but whatever ig)
+    std::uniform_real_distribution<float> dist(0.0f, 2.0f * math::PI);
     for (int i = 0; i < rockCount; ++i) {
         float angle = (i / static_cast<float>(rockCount)) * 2.0f * math::PI; //Use math::PI instead of Settings::PI as it was causing errors
-        float x = std::cos(angle) * perimeterRadius;
-        float z = std::sin(angle) * perimeterRadius;
-
-        auto rock = rockGroup->clone<Object3D>(true);
-        rock->position.set(x, 0, z);
-        rock->scale.setScalar(rockScale);
-        
-        // Random rotation (i mean this doesnt rly matter anymore since i changed it to be circular rocks but whatever ig)
-        std::uniform_real_distribution<float> dist(0.0f, 2.0f * math::PI);
-        rock->rotation.y = dist(rng_);
-
-        scene_.add(rock);
-        // Register a mesh-based collider that matches the rock footprint
-        CollisionWorld::addRockMeshColliderFromObject(*rock);
+        Prop prop{PropClass::PerimeterRock, std::cos(angle) * perimeterRadius, std::sin(angle) * perimeterRadius,
+                  dist(rng_), rockScale, rock.extent * rockScale, true};
+        props_.push_back(prop);
+        sampler.addObstacle(prop.x, prop.z, prop.radius);
+    }
+}
+
+void ObjectSpawner::scatterProps_(PropClass type, int count, const PropTemplate& tmpl, float minScale, float maxScale,
+                                  float spacing, bool collides, PoissonDiskSampler& sampler) {
+    if (count <= 0) return;
+    const float maxRadius = tmpl.extent * maxScale;
+    // Solid props can't overlap their own kind either, whatever the spacing says
+    const float minDistance = collides ? std::max(spacing, 2.f * maxRadius) : spacing;
+    // Only as many as needed, spread over the arena (the sampler throws them as darts before filling in)
+    const auto points = sampler.generate(minDistance, maxRadius, static_cast<size_t>(count));
+    const size_t placed = points.size();
+    if (placed < static_cast<size_t>(count)) {
+        std::cout << "Only room for " << placed << " of " << count << " props at " << minDistance << "m spacing\n";
     }
 
-    std::cout << "Perimeter rocks placed using Rock1: " << rockCount << "\n";
+    std::uniform_real_distribution<float> angleDist(0.0f, 2.0f * math::PI);
+    std::uniform_real_distribution<float> scaleDist(minScale, maxScale);
+    for (size_t i = 0; i < placed; ++i) {
+        const float scale = scaleDist(rng_);
+        Prop prop{type, points[i].x, points[i].y, angleDist(rng_), scale, tmpl.extent * scale, collides};
+        props_.push_back(prop);
+        if (collides) sampler.addObstacle(prop.x, prop.z, prop.radius);
+    }
+}
+
+void ObjectSpawner::buildInstances_(const PropTemplate& tmpl, const std::vector<PropClass>& types) {
+    std::vector<const Prop*> instances;
+    for (const auto& prop : props_) {
+        if (std::find(types.begin(), types.end(), prop.type) != types.end()) instances.push_back(&prop);
+    }
+    if (instances.empty()) return;
+
+    // One InstancedMesh per sub-mesh, all sized exactly to the number of props
+    const auto parts = tmpl.createInstances(instances.size());
+    Matrix4 m;
+    for (size_t n = 0; n < instances.size(); ++n) {
+        const Prop& prop = *instances[n];
+        const Matrix4 placement = tmpl.placement(prop.x, prop.z, prop.yaw, prop.scale);
+        for (size_t i = 0; i < parts.size(); ++i) {
+            parts[i]->setMatrixAt(n, m.multiplyMatrices(placement, tmpl.partMatrices[i]));
+        }
+
+        if (prop.collides) {
+            CollisionWorld::addMeshColliderFromTemplate(tmpl.hull, prop.x, prop.z, prop.yaw, prop.scale);
+            ++stats_.colliders;
+        }
+    }
+
+    for (auto& mesh : parts) {
+        mesh->instanceMatrix()->needsUpdate();
+        scene_.add(mesh);
+        propMeshes_.push_back(mesh);
+    }
+    stats_.instances += instances.size();
+    stats_.drawCalls += parts.size();
 }
@@ -0,0 +1,158 @@
+#include "PoissonDiskSampler.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr float TwoPi = 6.28318530718f;
+}
+
+PoissonDiskSampler::PoissonDiskSampler(float regionRadius, unsigned int seed, int attempts)
+    : regionRadius_(regionRadius), attempts_(std::max(1, attempts)), rng_(seed) {}
+
+void PoissonDiskSampler::addObstacle(float x, float z, float radius) {
+    obstacles_.push_back({x, z, radius});
+}
+
+void PoissonDiskSampler::buildObstacleGrid_(float pointRadius) {
+    obstacleCells_ = std::max(1, static_cast<int>(std::ceil(2.f * regionRadius_ / obstacleCell_)));
+    obstacleGrid_.assign(static_cast<size_t>(obstacleCells_) * obstacleCells_, {});
+
+    auto toCell = [&](float v) {
+        return static_cast<int>(std::floor((v + regionRadius_) / obstacleCell_));
+    };
+    for (int i = 0; i < static_cast<int>(obstacles_.size()); ++i) {
+        const auto& o = obstacles_[i];
+        const float reach = o.radius + pointRadius;
+        const int x0 = std::max(0, toCell(o.x - reach));
+        const int x1 = std::min(obstacleCells_ - 1, toCell(o.x + reach));
+        const int z0 = std::max(0, toCell(o.z - reach));
+        const int z1 = std::min(obstacleCells_ - 1, toCell(o.z + reach));
+        for (int cz = z0; cz <= z1; ++cz) {
+            for (int cx = x0; cx <= x1; ++cx) {
+                obstacleGrid_[static_cast<size_t>(cz) * obstacleCells_ + cx].push_back(i);
+            }
+        }
+    }
+}
+
+bool PoissonDiskSampler::isBlocked_(float x, float z, float pointRadius) const {
+    if (obstacles_.empty()) return false;
+    const int cx = std::clamp(static_cast<int>(std::floor((x + regionRadius_) / obstacleCell_)), 0, obstacleCells_ - 1);
+    const int cz = std::clamp(static_cast<int>(std::floor((z + regionRadius_) / obstacleCell_)), 0, obstacleCells_ - 1);
+    for (int i : obstacleGrid_[static_cast<size_t>(cz) * obstacleCells_ + cx]) {
+        const auto& o = obstacles_[i];
+        const float dx = x - o.x;
+        const float dz = z - o.z;
+        const float minDist = o.radius + pointRadius;
+        if (dx * dx + dz * dz < minDist * minDist) return true;
+    }
+    return false;
+}
+
+std::vector<threepp::Vector2> PoissonDiskSampler::generate(float minDistance, float pointRadius, size_t maxPoints) {
+    std::vector<threepp::Vector2> points;
+    const float limit = regionRadius_ - pointRadius; // point centers stay inside this
+    if (minDistance <= 0.f || limit < 0.f || maxPoints == 0) return points;
+
+    obstacleCell_ = std::max(2.f, minDistance);
+    buildObstacleGrid_(pointRadius);
+
+    // Background grid: a cell's diagonal is minDistance, so it can hold one point at most.
+    // Padded by two empty cells on every side so neighbour lookups need no bounds checks.
+    const float cell = minDistance / std::sqrt(2.f);
+    const int cells = std::max(1, static_cast<int>(std::ceil(2.f * limit / cell)));
+    const int stride = cells + 4;
+    std::vector<int> grid(static_cast<size_t>(stride) * stride, -1);
+    auto toCell = [&](float v) {
+        return std::clamp(static_cast<int>((v + limit) / cell), 0, cells - 1) + 2;
+    };
+
+    const float minDistSq = minDistance * minDistance;
+    auto fits = [&](float x, float z) {
+        if (x * x + z * z > limit * limit) return false;
+        const int cx = toCell(x);
+        const int cz = toCell(z);
+        // Anything closer than minDistance is at most two cells away (and never in the 5x5 corners)
+        for (int dz = -2; dz <= 2; ++dz) {
+            const int* row = &grid[static_cast<size_t>(cz + dz) * stride + cx];
+            for (int dx = -2; dx <= 2; ++dx) {
+                if ((dx == -2 || dx == 2) && (dz == -2 || dz == 2)) continue;
+                const int idx = row[dx];
+                if (idx < 0) continue;
+                const float ex = points[idx].x - x;
+                const float ez = points[idx].y - z;
+                if (ex * ex + ez * ez < minDistSq) return false;
+            }
+        }
+        return !isBlocked_(x, z, pointRadius);
+    };
+
+    std::vector<int> active;
+    auto insert = [&](float x, float z) {
+        grid[static_cast<size_t>(toCell(z)) * stride + toCell(x)] = static_cast<int>(points.size());
+        active.push_back(static_cast<int>(points.size()));
+        points.emplace_back(x, z);
+    };
+
+    // Raw engine bits instead of std distributions: faster, and the same points on every standard library
+    auto unit = [&] { return static_cast<float>(rng_() >> 8) * (1.f / 16777216.f); };
+    auto full = [&] { return points.size() >= maxPoints; };
+
+    // With a budget: uniform darts over the whole disc first, until `attempts_` in a row miss.
+    // The fill below then only tops up around them if the region is too crowded for darts
+    if (maxPoints != SIZE_MAX) {
+        int misses = 0;
+        while (!full() && misses < attempts_) {
+            const float dist = limit * std::sqrt(unit());
+            const float angle = unit() * TwoPi;
+            const float x = std::cos(angle) * dist;
+            const float z = std::sin(angle) * dist;
+            if (fits(x, z)) {
+                insert(x, z);
+                misses = 0;
+            } else {
+                ++misses;
+            }
+        }
+    }
+
+    while (!full()) {
+        while (!active.empty() && !full()) {
+            const size_t slot = rng_() % active.size();
+            const auto origin = points[active[slot]];
+            bool placed = false;
+            for (int k = 0; k < attempts_ && !placed; ++k) {
+                // Uniform over the area of the ring [r, 2r]
+                const float dist = minDistance * std::sqrt(1.f + 3.f * unit());
+                const float angle = unit() * TwoPi;
+                const float x = origin.x + std::cos(angle) * dist;
+                const float z = origin.y + std::sin(angle) * dist;
+                if (fits(x, z)) {
+                    insert(x, z);
+                    placed = true;
+                }
+            }
+            if (!placed) {
+                // Nothing fits around this one anymore, retire it
+                active[slot] = active.back();
+                active.pop_back();
+            }
+        }
+        if (full()) break;
+
+        // (Re)start from a random free spot, obstacles can cut the region into pockets
+        bool seeded = false;
+        for (int k = 0; k < attempts_ && !seeded; ++k) {
+            const float dist = limit * std::sqrt(unit());
+            const float angle = unit() * TwoPi;
+            const float x = std::cos(angle) * dist;
+            const float z = std::sin(angle) * dist;
+            if (fits(x, z)) {
+                insert(x, z);
+                seeded = true;
+            }
+        }
+        if (!seeded) break;
+    }
+    return points;
+}
@@ -0,0 +1,152 @@
+#include "PropTemplate.hpp"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include "AssetRegistry.hpp"
+#include "CollisionWorld.hpp"
+
+using namespace threepp;
+
+namespace {
+    std::string resolveAssetPath(const std::string& rel) {
+        using std::filesystem::exists;
+        using std::filesystem::path;
+        const path candidates[] = {
+            path(rel),
+            path("../") / rel,
+            path("../../") / rel,
+            path("../../../") / rel
+        };
+        for (const auto& p : candidates) {
+            if (exists(p)) return p.string();
+        }
+        return rel; // fallback; loader will report error
+    }
+}
+
+PropTemplate PropTemplate::loadRock() {
+    PropTemplate tmpl;
+
+    // The exported MTL sets Kd (diffuse) to black and has no texture.
+    // Override with a rock-like PBR material so meshes aren't black.
+    auto rockMat = AssetRegistry::material("rock", [] {
+        auto material = MeshStandardMaterial::create();
+        material->color = Color(0.6f, 0.6f, 0.6f);
+        material->roughness = 0.95f;
+        material->metalness = 0.0f;
+        return material;
+    });
+
+    std::cout << "Loading rock template from models/Rock2.obj (with .mtl)...\n";
+    const auto rock = AssetRegistry::load(resolveAssetPath("models/Rock2.obj"), true);
+    const auto& rockGroup = rock.group;
+    if (rockGroup) {
+        rockGroup->updateMatrixWorld(true);
+        rockGroup->traverseType<Mesh>([&](Mesh& m) {
+            if (!m.geometry()) return;
+            tmpl.geometries.push_back(m.geometry());
+            tmpl.materials.push_back(rockMat);
+            tmpl.partMatrices.push_back(*m.matrixWorld);
+        });
+    }
+    if (tmpl.geometries.empty()) {
+        // Roughly the size of Rock2 so scales and colliders still make sense
+        std::cout << "Failed to load Rock2.obj. Using low-poly spheres for rocks.\n";
+        tmpl.geometries.push_back(AssetRegistry::geometry("rockFallback", [] { return SphereGeometry::create(11.f, 7, 5); }));
+        tmpl.materials.push_back(rockMat);
+        tmpl.partMatrices.emplace_back();
+    }
+
+    // The model is centered, so half of it is under the ground like before.
+    // Its parts aren't moved, the cached hull is already the footprint
+    if (!rock.hull.empty()) tmpl.setHull(rock.hull);
+    else tmpl.computeFootprint();
+    if (tmpl.extent <= 0.f) tmpl.extent = 11.f;
+    return tmpl;
+}
+
+PropTemplate PropTemplate::crate() {
+    PropTemplate tmpl;
+    tmpl.geometries.push_back(AssetRegistry::geometry("crate", [] { return BoxGeometry::create(1.f, 1.f, 1.f); }));
+    tmpl.materials.push_back(AssetRegistry::material("crate", [] {
+        auto material = MeshStandardMaterial::create();
+        material->color = Color(0.55f, 0.4f, 0.25f);
+        material->roughness = 0.8f;
+        return material;
+    }));
+    tmpl.partMatrices.emplace_back();
+    tmpl.hull = {{-0.5f, -0.5f}, {0.5f, -0.5f}, {0.5f, 0.5f}, {-0.5f, 0.5f}};
+    tmpl.extent = std::sqrt(0.5f);
+    tmpl.lift = 0.5f; // box is centered, put its bottom on the ground
+    return tmpl;
+}
+
+PropTemplate PropTemplate::loadRail() {
+    PropTemplate tmpl;
+    auto railPath = resolveAssetPath("models/rAIL.obj");
+    std::cout << "Loading rail from " << railPath << " (with .mtl)..." << std::endl;
+
+    auto railGroup = AssetRegistry::load(railPath, true).group;
+    if (!railGroup) {
+        std::cout << "Failed to load rail model" << std::endl;
+        return tmpl;
+    }
+
+    // Rotate rail to stand upright (idk but everything seems to be the wrong way round),
+    // baked into the template so instances only need a yaw
+    railGroup->scale.setScalar(0.04f);
+    railGroup->rotation.x = -math::PI / 2.0f;
+    railGroup->updateMatrixWorld(true);
+    railGroup->traverseType<Mesh>([&](Mesh& m) {
+        if (!m.geometry()) return;
+        tmpl.geometries.push_back(m.geometry());
+        tmpl.materials.push_back(m.material());
+        tmpl.partMatrices.push_back(*m.matrixWorld);
+    });
+    tmpl.computeFootprint();
+    return tmpl;
+}
+
+void PropTemplate::computeFootprint() {
+    std::vector<Vector2> pts;
+    Vector3 v;
+    for (size_t i = 0; i < geometries.size(); ++i) {
+        const auto* pos = geometries[i]->getAttribute<float>("position");
+        if (!pos) continue;
+        for (int k = 0, c = pos->count(); k < c; ++k) {
+            v.set(pos->getX(k), pos->getY(k), pos->getZ(k));
+            v.applyMatrix4(partMatrices[i]);
+            pts.emplace_back(v.x, v.z);
+        }
+    }
+    setHull(CollisionWorld::footprintHull(std::move(pts)));
+}
+
+void PropTemplate::setHull(std::vector<Vector2> footprint) {
+    hull = std::move(footprint);
+    // Radius around the template origin that holds the whole footprint
+    extent = 0.f;
+    for (const auto& p : hull) extent = std::max(extent, std::sqrt(p.x * p.x + p.y * p.y));
+}
+
+Matrix4 PropTemplate::placement(float x, float z, float yaw, float scale) const {
+    Quaternion q;
+    q.setFromAxisAngle(Vector3(0, 1, 0), yaw);
+    Matrix4 m;
+    m.compose(Vector3(x, lift * scale, z), q, Vector3(scale, scale, scale));
+    return m;
+}
+
+std::vector<std::shared_ptr<InstancedMesh>> PropTemplate::createInstances(size_t count) const {
+    std::vector<std::shared_ptr<InstancedMesh>> parts;
+    for (size_t i = 0; i < geometries.size(); ++i) {
+        auto mesh = InstancedMesh::create(geometries[i], materials[i], count);
+        mesh->frustumCulled = false; // bounds would only cover the template at the origin
+        mesh->castShadow = true;
+        mesh->receiveShadow = true;
+        parts.push_back(mesh);
+    }
+    return parts;
+}
@@ -0,0 +1,406 @@
+#include "SoilVolume.hpp"
+#include "Heightfield.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace threepp;
+
+namespace {
+    constexpr float kEps = 1e-5f;
+    constexpr int kMask = SoilVolume::BrickSize - 1;
+    constexpr int kShift = 3; // log2(BrickSize)
+
+    inline int localIndex(int lx, int ly, int lz) {
+        return lx + SoilVolume::BrickSize * (ly + SoilVolume::BrickSize * lz);
+    }
+
+    inline int neighborIndex(int dx, int dy, int dz) {
+        return (dx + 1) + 3 * (dy + 1) + 9 * (dz + 1);
+    }
+
+    // Horizontal directions used for support and spilling
+    constexpr int kDirs[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+}
+
+SoilVolume::SoilVolume(const Vector3& origin, float voxelSize, int threads)
+    : origin_(origin), voxelSize_(voxelSize > 0.f ? voxelSize : 0.25f),
+      threadCount_(std::max(1, threads > 0 ? threads : static_cast<int>(std::thread::hardware_concurrency()))) {}
+
+void SoilVolume::startWorkers_() {
+    // The calling thread works too
+    for (int i = 1; i < threadCount_; ++i) {
+        workers_.emplace_back([this] { workerLoop_(); });
+    }
+}
+
+SoilVolume::~SoilVolume() {
+    {
+        std::lock_guard<std::mutex> lock(poolMutex_);
+        stop_ = true;
+    }
+    poolCv_.notify_all();
+    for (auto& worker : workers_) worker.join();
+}
+
+SoilVolume::BrickKey SoilVolume::key_(int bx, int by, int bz) {
+    // 21 bits per axis, biased so negative brick coords work
+    constexpr int kBias = 1 << 20;
+    constexpr uint64_t kBits = (1u << 21) - 1;
+    return (static_cast<uint64_t>(bx + kBias) & kBits) |
+           ((static_cast<uint64_t>(by + kBias) & kBits) << 21) |
+           ((static_cast<uint64_t>(bz + kBias) & kBits) << 42);
+}
+
+SoilVolume::Brick* SoilVolume::find_(int bx, int by, int bz) const {
+    const auto it = lookup_.find(key_(bx, by, bz));
+    return it == lookup_.end() ? nullptr : it->second;
+}
+
+SoilVolume::Brick& SoilVolume::getOrCreate_(int bx, int by, int bz) {
+    if (Brick* existing = find_(bx, by, bz)) return *existing;
+    auto brick = std::make_unique<Brick>();
+    brick->bx = bx;
+    brick->by = by;
+    brick->bz = bz;
+    Brick* raw = brick.get();
+    bricks_.push_back(std::move(brick));
+    lookup_.emplace(key_(bx, by, bz), raw);
+    return *raw;
+}
+
+void SoilVolume::activate_(Brick& brick) {
+    if (brick.active) return;
+    brick.active = true;
+    active_.push_back(&brick);
+}
+
+float SoilVolume::voxel(int x, int y, int z) const {
+    if (y < 0) return 0.f;
+    const Brick* brick = find_(x >> kShift, y >> kShift, z >> kShift);
+    return brick ? brick->fill[localIndex(x & kMask, y & kMask, z & kMask)] : 0.f;
+}
+
+void SoilVolume::setVoxel(int x, int y, int z, float fill) {
+    if (y < 0) return; // under the floor
+    Brick& brick = getOrCreate_(x >> kShift, y >> kShift, z >> kShift);
+    brick.fill[localIndex(x & kMask, y & kMask, z & kMask)] = std::clamp(fill, 0.f, 1.f);
+    activate_(brick);
+    revision_++;
+}
+
+Vector3 SoilVolume::voxelCenter(int x, int y, int z) const {
+    return {origin_.x + (x + 0.5f) * voxelSize_,
+            origin_.y + (y + 0.5f) * voxelSize_,
+            origin_.z + (z + 0.5f) * voxelSize_};
+}
+
+void SoilVolume::fillFromHeightfield(const Heightfield& field) {
+    const float half = field.getSize() * 0.5f;
+    const Vector3& center = field.getCenter();
+    const int x0 = static_cast<int>(std::floor((center.x - half - origin_.x) / voxelSize_));
+    const int x1 = static_cast<int>(std::ceil((center.x + half - origin_.x) / voxelSize_));
+    const int z0 = static_cast<int>(std::floor((center.z - half - origin_.z) / voxelSize_));
+    const int z1 = static_cast<int>(std::ceil((center.z + half - origin_.z) / voxelSize_));
+
+    for (int z = z0; z < z1; ++z) {
+        for (int x = x0; x < x1; ++x) {
+            const float wx = origin_.x + (x + 0.5f) * voxelSize_;
+            const float wz = origin_.z + (z + 0.5f) * voxelSize_;
+            if (!field.contains(wx, wz)) continue;
+
+            // Soil column in voxels: whole voxels plus a partial one on top
+            float column = (field.heightAt(wx, wz) - origin_.y) / voxelSize_;
+            for (int y = 0; column > kEps; ++y, column -= 1.f) {
+                Brick& brick = getOrCreate_(x >> kShift, y >> kShift, z >> kShift);
+                float& fill = brick.fill[localIndex(x & kMask, y & kMask, z & kMask)];
+                fill = std::min(1.f, fill + std::min(column, 1.f));
+                activate_(brick);
+            }
+        }
+    }
+    revision_++;
+}
+
+void SoilVolume::clear() {
+    bricks_.clear();
+    lookup_.clear();
+    active_.clear();
+    revision_++;
+}
+
+bool SoilVolume::blocked_(int x, int y, int z) const {
+    if (!hasBoundary_) return false;
+    const float dx = x + 0.5f - boundaryCenter_.x;
+    const float dy = y + 0.5f - boundaryCenter_.y;
+    const float dz = z + 0.5f - boundaryCenter_.z;
+    return dx * dx + dy * dy + dz * dz < boundaryRadius_ * boundaryRadius_;
+}
+
+void SoilVolume::setBoundary(const Vector3& center, float radius) {
+    const Vector3 c((center.x - origin_.x) / voxelSize_, (center.y - origin_.y) / voxelSize_,
+                    (center.z - origin_.z) / voxelSize_);
+    const float r = radius / voxelSize_;
+    if (hasBoundary_ && c.x == boundaryCenter_.x && c.y == boundaryCenter_.y && c.z == boundaryCenter_.z &&
+        r == boundaryRadius_) {
+        return; // bucket didn't move
+    }
+    // Soil resting on the bucket where it was may have lost its support
+    if (hasBoundary_) activateAround_(boundaryCenter_, boundaryRadius_);
+    hasBoundary_ = true;
+    boundaryCenter_ = c;
+    boundaryRadius_ = r;
+
+    // Soil the bucket moved into is shoved up on top of it (same column), the solver lets it spill from there
+    const int x0 = static_cast<int>(std::floor(c.x - r)), x1 = static_cast<int>(std::floor(c.x + r));
+    const int y0 = std::max(0, static_cast<int>(std::floor(c.y - r))), y1 = static_cast<int>(std::floor(c.y + r));
+    const int z0 = static_cast<int>(std::floor(c.z - r)), z1 = static_cast<int>(std::floor(c.z + r));
+    bool displaced = false;
+    for (int z = z0; z <= z1; ++z) {
+        for (int x = x0; x <= x1; ++x) {
+            float carried = 0.f;
+            int top = -1; // highest voxel of this column inside the sphere
+            for (int y = y0; y <= y1; ++y) {
+                if (!blocked_(x, y, z)) continue;
+                top = y;
+                Brick* brick = find_(x >> kShift, y >> kShift, z >> kShift);
+                if (!brick) continue;
+                float& fill = brick->fill[localIndex(x & kMask, y & kMask, z & kMask)];
+                carried += fill;
+                fill = 0.f;
+            }
+            if (carried <= 0.f) continue;
+            displaced = true;
+
+            // Stack it on top of the sphere, the solver lets it spill off from there
+            for (int y = top + 1; carried > 0.f; ++y) {
+                Brick& brick = getOrCreate_(x >> kShift, y >> kShift, z >> kShift);
+                float& fill = brick.fill[localIndex(x & kMask, y & kMask, z & kMask)];
+                const float add = std::min(carried, 1.f - fill);
+                fill += add;
+                carried -= add;
+                activate_(brick);
+            }
+        }
+    }
+
+    // Everything the bucket touches gets simulated this tick
+    activateAround_(c, r);
+    if (displaced) revision_++;
+}
+
+void SoilVolume::clearBoundary() {
+    if (hasBoundary_) activateAround_(boundaryCenter_, boundaryRadius_);
+    hasBoundary_ = false;
+}
+
+void SoilVolume::activateAround_(const Vector3& c, float r) {
+    // One voxel of margin: soil right next to (or on top of) the sphere depends on it too
+    const int x0 = static_cast<int>(std::floor(c.x - r)) - 1, x1 = static_cast<int>(std::floor(c.x + r)) + 1;
+    const int y0 = std::max(0, static_cast<int>(std::floor(c.y - r)) - 1), y1 = static_cast<int>(std::floor(c.y + r)) + 1;
+    const int z0 = static_cast<int>(std::floor(c.z - r)) - 1, z1 = static_cast<int>(std::floor(c.z + r)) + 1;
+    for (int bz = z0 >> kShift; bz <= z1 >> kShift; ++bz) {
+        for (int by = y0 >> kShift; by <= y1 >> kShift; ++by) {
+            for (int bx = x0 >> kShift; bx <= x1 >> kShift; ++bx) {
+                if (Brick* brick = find_(bx, by, bz)) activate_(*brick);
+            }
+        }
+    }
+}
+
+namespace {
+    // Voxel in a brick or one of its neighbours (local coords -1..BrickSize), null on the floor / unallocated
+    template<class Brick>
+    inline float* voxelAt(Brick& b, int lx, int ly, int lz, Brick*& owner) {
+        constexpr int n = SoilVolume::BrickSize;
+        const int ox = lx < 0 ? -1 : (lx >= n ? 1 : 0);
+        const int oy = ly < 0 ? -1 : (ly >= n ? 1 : 0);
+        const int oz = lz < 0 ? -1 : (lz >= n ? 1 : 0);
+        owner = b.neighbors[neighborIndex(ox, oy, oz)];
+        if (!owner) return nullptr;
+        return &owner->fill[localIndex(lx - ox * n, ly - oy * n, lz - oz * n)];
+    }
+}
+
+void SoilVolume::markHeld_(Brick& b) {
+    // Held in place by enough full neighbours (cohesion). Decided on the state before anything moves
+    // this tick, otherwise a whole undercut slab would unzip in one sweep instead of crumbling from the edges.
+    Brick* owner = nullptr;
+    b.held.fill(0);
+    for (int i = 0; i < BrickVoxels; ++i) {
+        if (b.fill[i] <= kEps) continue;
+        const int lx = i % BrickSize, ly = (i / BrickSize) % BrickSize, lz = i / (BrickSize * BrickSize);
+        int support = 0;
+        for (const auto& d : kDirs) {
+            const float* side = voxelAt(b, lx + d[0], ly, lz + d[1], owner);
+            if (side && *side > 0.9f) support++;
+        }
+        if (support >= Settings::soilCohesion_) b.held[i >> 6] |= uint64_t{1} << (i & 63);
+    }
+}
+
+void SoilVolume::updateBrick_(Brick& b) {
+    auto at = [&b](int lx, int ly, int lz, Brick*& owner) { return voxelAt(b, lx, ly, lz, owner); };
+    auto transfer = [&b](float& from, float& to, float amount, Brick* owner) {
+        from -= amount;
+        to += amount;
+        b.moved += amount;
+        if (owner != &b) owner->woken.store(1, std::memory_order_relaxed);
+    };
+
+    const int gx0 = b.bx * BrickSize, gy0 = b.by * BrickSize, gz0 = b.bz * BrickSize;
+    Brick* owner = nullptr;
+
+    // Bottom layer first: soil falls into space vacated this tick, one voxel per tick
+    for (int ly = 0; ly < BrickSize; ++ly) {
+        for (int lz = 0; lz < BrickSize; ++lz) {
+            for (int lx = 0; lx < BrickSize; ++lx) {
+                const int i = localIndex(lx, ly, lz);
+                float& f = b.fill[i];
+                if (f <= kEps || (b.held[i >> 6] >> (i & 63)) & 1) continue;
+                const int gx = gx0 + lx, gy = gy0 + ly, gz = gz0 + lz;
+
+                // Straight down
+                if (float* below = at(lx, ly - 1, lz, owner); below && !blocked_(gx, gy - 1, gz)) {
+                    const float amount = std::min(f, 1.f - *below);
+                    if (amount > kEps) transfer(f, *below, amount, owner);
+                }
+                if (f <= kEps) continue;
+
+                // Off the edge: diagonally down towards lower neighbours (45 degree repose)
+                const float share = f * Settings::soilSpillRate_ * 0.25f;
+                for (const auto& d : kDirs) {
+                    const float* side = at(lx + d[0], ly, lz + d[1], owner);
+                    if (!side || *side >= f || blocked_(gx + d[0], gy, gz + d[1])) continue;
+                    float* diagonal = at(lx + d[0], ly - 1, lz + d[1], owner);
+                    if (!diagonal || blocked_(gx + d[0], gy - 1, gz + d[1])) continue;
+                    const float amount = std::min(share, 1.f - *diagonal);
+                    if (amount > kEps) transfer(f, *diagonal, amount, owner);
+                }
+            }
+        }
+    }
+}
+
+size_t SoilVolume::step() {
+    if (active_.empty()) return 0;
+
+    // Soil can only move down or sideways: make sure those neighbours exist before going parallel
+    for (size_t i = 0, n = active_.size(); i < n; ++i) {
+        Brick& brick = *active_[i];
+        for (int dz = -1; dz <= 1; ++dz) {
+            for (int dy = -1; dy <= 0; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    if (brick.by + dy >= 0) getOrCreate_(brick.bx + dx, brick.by + dy, brick.bz + dz);
+                }
+            }
+        }
+    }
+    for (auto& pass : passes_) pass.clear();
+    for (Brick* brick : active_) {
+        for (int dz = -1; dz <= 1; ++dz) {
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    brick->neighbors[neighborIndex(dx, dy, dz)] = find_(brick->bx + dx, brick->by + dy, brick->bz + dz);
+                }
+            }
+        }
+        brick->moved = 0.f;
+        passes_[(brick->bx & 1) | ((brick->by & 1) << 1) | ((brick->bz & 1) << 2)].push_back(brick);
+    }
+
+    // Cohesion first (read only), then the moves.
+    // Bricks in one pass are two apart on every axis, so their +-1 voxel reach never overlaps
+    parallelFor_(active_.size(), [this](size_t i) { markHeld_(*active_[i]); });
+    for (auto& pass : passes_) {
+        parallelFor_(pass.size(), [&pass, this](size_t i) { updateBrick_(*pass[i]); });
+    }
+
+    // Next tick: bricks that moved (plus the ones above/beside them that may have lost support)
+    // and bricks that received soil. Everything else sleeps.
+    const size_t updated = active_.size();
+    bool anyMoved = false;
+    for (Brick* brick : active_) {
+        brick->active = false;
+        if (brick->moved <= kEps) continue;
+        anyMoved = true;
+        for (int dz = -1; dz <= 1; ++dz) {
+            for (int dy = 0; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    if (Brick* n = brick->neighbors[neighborIndex(dx, dy, dz)]) n->woken.store(1, std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+    previousActive_.clear();
+    previousActive_.swap(active_);
+    for (Brick* brick : previousActive_) {
+        for (Brick* n : brick->neighbors) {
+            if (n && n->woken.exchange(0, std::memory_order_relaxed)) activate_(*n);
+        }
+    }
+    if (anyMoved) revision_++;
+    return updated;
+}
+
+float SoilVolume::totalSoil() const {
+    double sum = 0.0;
+    for (const auto& brick : bricks_) {
+        for (const float fill : brick->fill) sum += fill;
+    }
+    return static_cast<float>(sum * voxelSize_ * voxelSize_ * voxelSize_);
+}
+
+void SoilVolume::parallelFor_(size_t count, const std::function<void(size_t)>& job) {
+    if (count == 0) return;
+    if (workers_.empty() && threadCount_ > 1 && count > 1) startWorkers_();
+    if (workers_.empty() || count == 1) {
+        for (size_t i = 0; i < count; ++i) job(i);
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> lock(poolMutex_);
+        // A late worker from the previous batch must be out before the counters are reset
+        doneCv_.wait(lock, [this] { return busy_ == 0; });
+        doneJobs_ = 0;
+        job_ = &job;
+        jobCount_ = count;
+        nextJob_ = 0;
+        generation_++;
+    }
+    poolCv_.notify_all();
+    runJobs_();
+
+    std::unique_lock<std::mutex> lock(poolMutex_);
+    doneCv_.wait(lock, [this, count] { return doneJobs_ == count && busy_ == 0; });
+}
+
+void SoilVolume::runJobs_() {
+    const size_t count = jobCount_;
+    const auto* job = job_.load();
+    for (size_t i = nextJob_++; i < count; i = nextJob_++) {
+        (*job)(i);
+        if (++doneJobs_ == count) {
+            std::lock_guard<std::mutex> lock(poolMutex_);
+            doneCv_.notify_all();
+        }
+    }
+}
+
+void SoilVolume::workerLoop_() {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(poolMutex_);
+            poolCv_.wait(lock, [this, seen] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+            busy_++;
+        }
+        runJobs_();
+        {
+            std::lock_guard<std::mutex> lock(poolMutex_);
+            busy_--;
+        }
+        doneCv_.notify_all();
+    }
+}
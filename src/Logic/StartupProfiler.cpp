@@ -0,0 +1,196 @@
+#include "StartupProfiler.hpp"
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+bool StartupProfiler::s_running{false};
+std::chrono::steady_clock::time_point StartupProfiler::s_programStart;
+double StartupProfiler::s_cpuStart{0.0};
+double StartupProfiler::s_totalWallMs{0.0};
+double StartupProfiler::s_totalCpuMs{0.0};
+std::string StartupProfiler::s_timestamp;
+std::vector<StartupProfiler::Phase> StartupProfiler::s_phases;
+std::vector<StartupProfiler::Open> StartupProfiler::s_open;
+
+namespace {
+    double msSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::string fixed3(double ms) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.3f", ms);
+        return buf;
+    }
+
+    // Phase names are ours, but keep the JSON valid whatever they are
+    std::string jsonEscape(const std::string& s) {
+        std::string out;
+        for (char c : s) {
+            if (c == '"' || c == '\\') out += '\\';
+            if (static_cast<unsigned char>(c) >= 0x20) out += c;
+        }
+        return out;
+    }
+
+    std::string csvField(const std::string& s) {
+        if (s.find_first_of(",\"\n") == std::string::npos) return s;
+        std::string out = "\"";
+        for (char c : s) out += c == '"' ? std::string("\"\"") : std::string(1, c);
+        return out + "\"";
+    }
+
+    // UTC, ISO 8601
+    std::string utcNow() {
+        const std::time_t now = std::time(nullptr);
+        std::tm tm{};
+#ifdef _WIN32
+        gmtime_s(&tm, &now);
+#else
+        gmtime_r(&now, &tm);
+#endif
+        char buf[32];
+        std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
+        return buf;
+    }
+}
+
+StartupProfiler::Scope::Scope(const std::string& name) {
+    if (!s_running) return;
+    std::string full = name;
+    if (!s_open.empty()) full = s_phases[s_open.back().index].name + "/" + name;
+    open_(full);
+    index_ = s_phases.size() - 1;
+}
+
+StartupProfiler::Scope::~Scope() {
+    // Already closed if phase() or finish() ran while it was open
+    if (s_running && !s_open.empty() && s_open.back().index == index_) close_();
+}
+
+void StartupProfiler::begin(std::chrono::steady_clock::time_point programStart) {
+    s_phases.clear();
+    s_open.clear();
+    s_programStart = programStart;
+    s_cpuStart = threadCpuMs();
+    s_totalWallMs = s_totalCpuMs = 0.0;
+    s_timestamp = utcNow();
+    s_running = true;
+}
+
+void StartupProfiler::phase(const std::string& name) {
+    if (!s_running) return;
+    while (!s_open.empty()) close_();
+    open_(name);
+}
+
+void StartupProfiler::finish() {
+    if (!s_running) return;
+    while (!s_open.empty()) close_();
+    s_totalWallMs = msSince(s_programStart);
+    s_totalCpuMs = threadCpuMs() - s_cpuStart;
+    s_running = false;
+}
+
+bool StartupProfiler::running() {
+    return s_running;
+}
+
+std::vector<StartupProfiler::Phase> StartupProfiler::phases() {
+    return s_phases;
+}
+
+double StartupProfiler::totalWallMs() {
+    return s_totalWallMs;
+}
+
+double StartupProfiler::totalCpuMs() {
+    return s_totalCpuMs;
+}
+
+void StartupProfiler::open_(const std::string& name) {
+    Phase p;
+    p.name = name;
+    p.depth = static_cast<int>(s_open.size());
+    p.startMs = msSince(s_programStart);
+    s_phases.push_back(std::move(p));
+    s_open.push_back({s_phases.size() - 1, threadCpuMs()});
+}
+
+void StartupProfiler::close_() {
+    const Open open = s_open.back();
+    s_open.pop_back();
+    Phase& p = s_phases[open.index];
+    p.wallMs = msSince(s_programStart) - p.startMs;
+    p.cpuMs = threadCpuMs() - open.cpuStart;
+}
+
+std::string StartupProfiler::toJson(const std::string& build) {
+    std::ostringstream out;
+    out << "{\n";
+    out << "  \"build\": \"" << jsonEscape(build) << "\",\n";
+    out << "  \"timestamp\": \"" << s_timestamp << "\",\n";
+    out << "  \"total_wall_ms\": " << fixed3(s_totalWallMs) << ",\n";
+    out << "  \"total_cpu_ms\": " << fixed3(s_totalCpuMs) << ",\n";
+    out << "  \"phases\": [";
+    for (size_t i = 0; i < s_phases.size(); ++i) {
+        const auto& p = s_phases[i];
+        out << (i ? ",\n" : "\n") << "    {\"name\": \"" << jsonEscape(p.name) << "\", \"depth\": " << p.depth
+            << ", \"start_ms\": " << fixed3(p.startMs) << ", \"wall_ms\": " << fixed3(p.wallMs)
+            << ", \"cpu_ms\": " << fixed3(p.cpuMs) << "}";
+    }
+    out << (s_phases.empty() ? "]\n" : "\n  ]\n") << "}\n";
+    return out.str();
+}
+
+std::string StartupProfiler::toCsvRows(const std::string& build, bool withHeader) {
+    std::ostringstream out;
+    if (withHeader) out << "build,timestamp,phase,depth,wall_ms,cpu_ms\n";
+    const std::string prefix = csvField(build) + "," + s_timestamp + ",";
+    for (const auto& p : s_phases) {
+        out << prefix << csvField(p.name) << "," << p.depth << "," << fixed3(p.wallMs) << "," << fixed3(p.cpuMs) << "\n";
+    }
+    out << prefix << "total,-1," << fixed3(s_totalWallMs) << "," << fixed3(s_totalCpuMs) << "\n";
+    return out.str();
+}
+
+bool StartupProfiler::writeJson(const std::filesystem::path& path, const std::string& build) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) return false;
+    out << toJson(build);
+    return static_cast<bool>(out);
+}
+
+bool StartupProfiler::appendCsv(const std::filesystem::path& path, const std::string& build) {
+    std::error_code ec;
+    const bool fresh = !std::filesystem::exists(path, ec) || std::filesystem::file_size(path, ec) == 0;
+    std::ofstream out(path, std::ios::app);
+    if (!out) return false;
+    out << toCsvRows(build, fresh);
+    return static_cast<bool>(out);
+}
+
+double StartupProfiler::threadCpuMs() {
+#ifdef _WIN32
+    FILETIME created, exited, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &created, &exited, &kernel, &user)) return 0.0;
+    auto toMs = [](const FILETIME& t) {
+        ULARGE_INTEGER v;
+        v.LowPart = t.dwLowDateTime;
+        v.HighPart = t.dwHighDateTime;
+        return static_cast<double>(v.QuadPart) / 10000.0; // 100 ns ticks
+    };
+    return toMs(kernel) + toMs(user);
+#else
+    timespec ts{};
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) return 0.0;
+    return static_cast<double>(ts.tv_sec) * 1000.0 + static_cast<double>(ts.tv_nsec) / 1.0e6;
+#endif
+}
@@ -0,0 +1,155 @@
+#include "TrafficHeatmap.hpp"
+#include <threepp/geometries/PlaneGeometry.hpp>
+#include <threepp/materials/MeshBasicMaterial.hpp>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+using namespace threepp;
+
+TrafficHeatmap::Writer::Writer(const TrafficHeatmap& owner)
+    : owner_(owner),
+      cells_(static_cast<size_t>(owner.resolution_) * owner.resolution_) {}
+
+void TrafficHeatmap::Writer::record(const Vector3& pos) {
+    const int index = owner_.cellIndex_(pos.x, pos.z);
+    if (index < 0) return;
+    auto& cell = cells_[index];
+    // No read-modify-write needed, this writer is the only one touching its grid
+    const uint32_t count = cell.load(std::memory_order_relaxed);
+    if (count != UINT32_MAX) cell.store(count + 1, std::memory_order_relaxed);
+}
+
+TrafficHeatmap::TrafficHeatmap(float halfExtent, int resolution)
+    : halfExtent_(halfExtent),
+      resolution_(std::max(1, resolution)),
+      cellSize_(2.f * halfExtent / std::max(1, resolution)) {}
+
+TrafficHeatmap::Writer& TrafficHeatmap::createWriter() {
+    std::lock_guard<std::mutex> lock(writersMutex_);
+    writers_.push_back(std::unique_ptr<Writer>(new Writer(*this)));
+    return *writers_.back();
+}
+
+size_t TrafficHeatmap::getWriterCount() const {
+    std::lock_guard<std::mutex> lock(writersMutex_);
+    return writers_.size();
+}
+
+int TrafficHeatmap::cellIndex_(float x, float z) const {
+    const int gx = static_cast<int>(std::floor((x + halfExtent_) / cellSize_));
+    const int gz = static_cast<int>(std::floor((halfExtent_ - z) / cellSize_));
+    if (gx < 0 || gz < 0 || gx >= resolution_ || gz >= resolution_) return -1;
+    return gz * resolution_ + gx;
+}
+
+std::vector<uint64_t> TrafficHeatmap::merged() const {
+    std::vector<uint64_t> sum(static_cast<size_t>(resolution_) * resolution_, 0);
+    std::lock_guard<std::mutex> lock(writersMutex_);
+    for (const auto& writer : writers_) {
+        for (size_t i = 0; i < sum.size(); ++i) {
+            sum[i] += writer->cells_[i].load(std::memory_order_relaxed);
+        }
+    }
+    return sum;
+}
+
+uint64_t TrafficHeatmap::countAt(float x, float z) const {
+    const int index = cellIndex_(x, z);
+    if (index < 0) return 0;
+    uint64_t count = 0;
+    std::lock_guard<std::mutex> lock(writersMutex_);
+    for (const auto& writer : writers_) {
+        count += writer->cells_[index].load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+uint64_t TrafficHeatmap::totalSamples() const {
+    uint64_t total = 0;
+    for (uint64_t c : merged()) total += c;
+    return total;
+}
+
+void TrafficHeatmap::clear() {
+    std::lock_guard<std::mutex> lock(writersMutex_);
+    for (auto& writer : writers_) {
+        for (auto& cell : writer->cells_) cell.store(0, std::memory_order_relaxed);
+    }
+}
+
+std::shared_ptr<Mesh> TrafficHeatmap::overlay() {
+    if (overlayMesh_) return overlayMesh_;
+
+    overlayTexture_ = DataTexture::create(
+        std::vector<unsigned char>(static_cast<size_t>(resolution_) * resolution_ * 4, 0), resolution_, resolution_);
+    overlayTexture_->magFilter = Filter::Nearest; // keep the cells readable
+    overlayTexture_->minFilter = Filter::Nearest;
+    overlayTexture_->generateMipmaps = false;
+
+    auto material = MeshBasicMaterial::create();
+    material->map = overlayTexture_;
+    material->transparent = true;
+    material->depthWrite = false;
+
+    overlayMesh_ = Mesh::create(PlaneGeometry::create(2.f * halfExtent_, 2.f * halfExtent_), material);
+    overlayMesh_->rotation.x = -Settings::PI_ / 2.f; // lie flat, row 0 ends up at +Z
+    overlayMesh_->position.y = 0.03f;               // above the track decals
+    overlayMesh_->visible = false;
+    refreshOverlay();
+    return overlayMesh_;
+}
+
+void TrafficHeatmap::refreshOverlay() {
+    if (!overlayTexture_) return;
+
+    const auto counts = merged();
+    const uint64_t maxCount = *std::max_element(counts.begin(), counts.end());
+    // Log scale so a single pass still shows up next to the spot the excavator idles on
+    const float norm = maxCount > 0 ? 1.f / std::log1p(static_cast<float>(maxCount)) : 0.f;
+
+    auto& rgba = overlayTexture_->image().data<unsigned char>();
+    for (size_t i = 0; i < counts.size(); ++i) {
+        const float t = std::log1p(static_cast<float>(counts[i])) * norm;
+        // blue -> yellow -> red
+        const float r = std::clamp(t * 2.f, 0.f, 1.f);
+        const float g = t < 0.5f ? t * 2.f : 2.f - t * 2.f;
+        const float b = std::clamp(1.f - t * 2.f, 0.f, 1.f);
+        rgba[i * 4 + 0] = static_cast<unsigned char>(r * 255.f);
+        rgba[i * 4 + 1] = static_cast<unsigned char>(g * 255.f);
+        rgba[i * 4 + 2] = static_cast<unsigned char>(b * 255.f);
+        rgba[i * 4 + 3] = counts[i] > 0 ? static_cast<unsigned char>(90.f + 130.f * t) : 0;
+    }
+    overlayTexture_->needsUpdate();
+}
+
+bool TrafficHeatmap::exportCsv(const std::filesystem::path& path) const {
+    std::ofstream out(path);
+    if (!out) return false;
+
+    const auto counts = merged();
+    out << "x,z,count\n";
+    for (int gz = 0; gz < resolution_; ++gz) {
+        const float z = halfExtent_ - (gz + 0.5f) * cellSize_;
+        for (int gx = 0; gx < resolution_; ++gx) {
+            const float x = -halfExtent_ + (gx + 0.5f) * cellSize_;
+            out << x << ',' << z << ',' << counts[static_cast<size_t>(gz) * resolution_ + gx] << '\n';
+        }
+    }
+    return static_cast<bool>(out);
+}
+
+bool TrafficHeatmap::exportBinary(const std::filesystem::path& path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+
+    const auto counts = merged();
+    const uint32_t version = 1;
+    const int32_t resolution = resolution_;
+    out.write("HEAT", 4);
+    out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    out.write(reinterpret_cast<const char*>(&resolution), sizeof(resolution));
+    out.write(reinterpret_cast<const char*>(&halfExtent_), sizeof(halfExtent_));
+    out.write(reinterpret_cast<const char*>(counts.data()), static_cast<std::streamsize>(counts.size() * sizeof(uint64_t)));
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,281 @@
+#include "WorldStreamer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include "PoissonDiskSampler.hpp"
+
+using namespace threepp;
+
+WorldStreamer::WorldStreamer(Object3D& parent, const Config& config)
+    : parent_(parent), config_(config) {
+    templates_.push_back(PropTemplate::loadRock());
+    templates_.push_back(PropTemplate::crate());
+    // Big to small, same classes as the arena
+    kinds_ = {
+        {0, config_.bouldersPerChunk, 0.08f, 0.12f, 6.f, true},
+        {1, config_.cratesPerChunk, 0.7f, 1.1f, 3.f, true},
+        {0, config_.debrisPerChunk, 0.01f, 0.025f, 1.f, false}, // sparser than the arena, it's a lot of ground
+    };
+
+    // Every chunk's ground is the same tile moved into place
+    tileGeometry_ = PlaneGeometry::create(config_.chunkSize, config_.chunkSize);
+    tileMaterial_ = config_.groundMaterial;
+    if (!tileMaterial_) {
+        auto material = MeshStandardMaterial::create();
+        material->color = Color(0.4f, 0.35f, 0.3f);
+        material->roughness = 0.9f;
+        tileMaterial_ = material;
+    }
+
+    worker_ = std::thread([this] { workerLoop_(); });
+}
+
+WorldStreamer::~WorldStreamer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    workCv_.notify_all();
+    worker_.join();
+    for (auto& [key, chunk] : chunks_) unload_(chunk);
+}
+
+int WorldStreamer::chunkOf(float v) const {
+    return static_cast<int>(std::floor(v / config_.chunkSize));
+}
+
+bool WorldStreamer::isResident(int cx, int cz) const {
+    const auto it = chunks_.find(key_(cx, cz));
+    return it != chunks_.end() && it->second.resident;
+}
+
+size_t WorldStreamer::getMaxResidentChunks() const {
+    const int keep = config_.loadRadius + 1;
+    size_t count = 0;
+    for (int dz = -keep; dz <= keep; ++dz) {
+        for (int dx = -keep; dx <= keep; ++dx) {
+            if (dx * dx + dz * dz <= keep * keep) ++count;
+        }
+    }
+    return count;
+}
+
+void WorldStreamer::update(const Vector3& focus, int maxIntegrations) {
+    const int fx = chunkOf(focus.x);
+    const int fz = chunkOf(focus.z);
+    const int load = config_.loadRadius;
+    const int keep = load + 1;
+    auto distSq = [&](int cx, int cz) { return (cx - fx) * (cx - fx) + (cz - fz) * (cz - fz); };
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Drop what's behind, including chunks the worker hasn't got to yet
+        for (auto it = chunks_.begin(); it != chunks_.end();) {
+            if (distSq(it->second.cx, it->second.cz) > keep * keep) {
+                unload_(it->second);
+                wanted_.erase(it->first);
+                it = chunks_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        requests_.erase(std::remove_if(requests_.begin(), requests_.end(), [&](const Request& r) {
+            return wanted_.find(key_(r.cx, r.cz)) == wanted_.end();
+        }), requests_.end());
+
+        // Ask for what's missing around the focus
+        for (int dz = -load; dz <= load; ++dz) {
+            for (int dx = -load; dx <= load; ++dx) {
+                if (dx * dx + dz * dz > load * load) continue;
+                const int cx = fx + dx;
+                const int cz = fz + dz;
+                const uint64_t generation = nextGeneration_++;
+                if (!chunks_.emplace(key_(cx, cz), Chunk{.cx = cx, .cz = cz, .generation = generation}).second) {
+                    continue;
+                }
+                wanted_[key_(cx, cz)] = generation;
+                requests_.push_back({cx, cz, generation});
+                ++stats_.pending;
+            }
+        }
+        // Closest first, the excavator may have moved since they were queued
+        std::stable_sort(requests_.begin(), requests_.end(), [&](const auto& a, const auto& b) {
+            return distSq(a.cx, a.cz) < distSq(b.cx, b.cz);
+        });
+    }
+    workCv_.notify_one();
+
+    integrateReady_(static_cast<size_t>(std::max(0, maxIntegrations)));
+}
+
+void WorldStreamer::finishLoading() {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idleCv_.wait(lock, [this] { return requests_.empty() && !busy_; });
+    }
+    integrateReady_(SIZE_MAX);
+}
+
+void WorldStreamer::integrateReady_(size_t maxCount) {
+    std::vector<ChunkData> done;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const size_t count = std::min(maxCount, ready_.size());
+        done.assign(std::make_move_iterator(ready_.begin()), std::make_move_iterator(ready_.begin() + count));
+        ready_.erase(ready_.begin(), ready_.begin() + count);
+        stats_.generated = generated_;
+    }
+    for (auto& data : done) integrate_(data);
+}
+
+WorldStreamer::ChunkData WorldStreamer::generate_(const Request& request) const {
+    const int cx = request.cx;
+    const int cz = request.cz;
+    ChunkData data{.cx = cx, .cz = cz, .generation = request.generation};
+    data.placements.resize(templates_.size());
+    data.matrices.resize(templates_.size());
+
+    const float half = config_.chunkSize * 0.5f;
+    const float ox = (cx + 0.5f) * config_.chunkSize;
+    const float oz = (cz + 0.5f) * config_.chunkSize;
+    const float reach = half * std::sqrt(2.f); // center to corner
+    if (std::sqrt(ox * ox + oz * oz) - reach > config_.siteRadius) return data; // off site, bare ground
+
+    // Only the seed and the coordinates decide what's in a chunk, it comes back the same every time
+    const unsigned int seed = config_.seed ^ (static_cast<unsigned int>(cx) * 73856093u)
+                                           ^ (static_cast<unsigned int>(cz) * 19349663u);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> angleDist(0.0f, 2.0f * math::PI);
+
+    // Sampled in chunk-local coordinates over the disc through the chunk corners
+    PoissonDiskSampler sampler(reach, seed);
+    for (const auto& k : config_.keepOut) sampler.addObstacle(k.x - ox, k.z - oz, k.radius);
+
+    for (const auto& kind : kinds_) {
+        if (kind.count <= 0) continue;
+        const PropTemplate& tmpl = templates_[kind.tmpl];
+        const float maxRadius = tmpl.extent * kind.maxScale;
+        const float minDistance = kind.collides ? std::max(kind.spacing, 2.f * maxRadius) : kind.spacing;
+        // Neighbours are generated on their own: staying this far inside the chunk keeps the spacing
+        // (and solid props apart) across the border without looking at them
+        const float inner = half - std::max(0.5f * minDistance, maxRadius);
+        if (inner <= 0.f) continue;
+
+        auto points = sampler.generate(minDistance, maxRadius);
+        points.erase(std::remove_if(points.begin(), points.end(), [&](const Vector2& p) {
+            const float wx = p.x + ox;
+            const float wz = p.y + oz;
+            return std::abs(p.x) > inner || std::abs(p.y) > inner ||
+                   std::sqrt(wx * wx + wz * wz) > config_.siteRadius - maxRadius;
+        }), points.end());
+        std::shuffle(points.begin(), points.end(), rng);
+        points.resize(std::min(points.size(), static_cast<size_t>(kind.count)));
+
+        std::uniform_real_distribution<float> scaleDist(kind.minScale, kind.maxScale);
+        auto& placements = data.placements[kind.tmpl];
+        auto& matrices = data.matrices[kind.tmpl];
+        Matrix4 m;
+        for (const auto& p : points) {
+            const Placement placement{p.x + ox, p.y + oz, angleDist(rng), scaleDist(rng), kind.collides};
+            placements.push_back(placement);
+            if (kind.collides) sampler.addObstacle(p.x, p.y, tmpl.extent * placement.scale);
+
+            const Matrix4 world = tmpl.placement(placement.x, placement.z, placement.yaw, placement.scale);
+            for (const auto& part : tmpl.partMatrices) matrices.push_back(m.multiplyMatrices(world, part));
+        }
+    }
+    return data;
+}
+
+void WorldStreamer::integrate_(ChunkData& data) {
+    const auto it = chunks_.find(key_(data.cx, data.cz));
+    // Dropped while the worker was on it (the worker already throws away what it sees was dropped)
+    if (it == chunks_.end() || it->second.generation != data.generation || it->second.resident) return;
+    Chunk& chunk = it->second;
+
+    auto tile = Mesh::create(tileGeometry_, tileMaterial_);
+    tile->rotation.x = -math::PI / 2.0f;
+    // A hair under the arena ground so they don't fight where they overlap
+    tile->position.set((data.cx + 0.5f) * config_.chunkSize, -0.01f, (data.cz + 0.5f) * config_.chunkSize);
+    tile->receiveShadow = true;
+    parent_.add(tile);
+    chunk.meshes.push_back(tile);
+
+    for (size_t t = 0; t < templates_.size(); ++t) {
+        const auto& placements = data.placements[t];
+        if (placements.empty()) continue;
+        const PropTemplate& tmpl = templates_[t];
+
+        const auto parts = tmpl.createInstances(placements.size());
+        const auto& matrices = data.matrices[t];
+        for (size_t n = 0; n < placements.size(); ++n) {
+            for (size_t i = 0; i < parts.size(); ++i) parts[i]->setMatrixAt(n, matrices[n * parts.size() + i]);
+        }
+        for (auto& mesh : parts) {
+            mesh->instanceMatrix()->needsUpdate();
+            parent_.add(mesh);
+            chunk.meshes.push_back(mesh);
+        }
+
+        for (const auto& p : placements) {
+            if (!p.collides) continue;
+            chunk.colliders.push_back(CollisionWorld::addMeshColliderFromTemplate(tmpl.hull, p.x, p.z, p.yaw, p.scale));
+        }
+        chunk.instances += placements.size();
+    }
+
+    chunk.resident = true;
+    --stats_.pending;
+    ++stats_.resident;
+    ++stats_.loaded;
+    stats_.instances += chunk.instances;
+    stats_.drawCalls += chunk.meshes.size();
+    stats_.colliders += chunk.colliders.size();
+}
+
+void WorldStreamer::unload_(Chunk& chunk) {
+    if (!chunk.resident) {
+        --stats_.pending;
+        return;
+    }
+    for (auto& mesh : chunk.meshes) parent_.remove(*mesh);
+    for (auto handle : chunk.colliders) CollisionWorld::removeMeshCollider(handle);
+
+    --stats_.resident;
+    ++stats_.unloaded;
+    stats_.instances -= chunk.instances;
+    stats_.drawCalls -= chunk.meshes.size();
+    stats_.colliders -= chunk.colliders.size();
+    chunk.meshes.clear();
+    chunk.colliders.clear();
+    chunk.instances = 0;
+    chunk.resident = false;
+}
+
+void WorldStreamer::workerLoop_() {
+    while (true) {
+        Request job{};
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            busy_ = false;
+            idleCv_.notify_all();
+            workCv_.wait(lock, [this] { return stop_ || !requests_.empty(); });
+            if (stop_) return;
+            job = requests_.front();
+            requests_.pop_front();
+            // Dropped (or dropped and asked for again) since it was queued: that copy isn't wanted anymore
+            const auto it = wanted_.find(key_(job.cx, job.cz));
+            if (it == wanted_.end() || it->second != job.generation) continue;
+            busy_ = true;
+        }
+
+        ChunkData data = generate_(job);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++generated_;
+        // Dropped while it was being made: don't queue it for the main thread to throw away
+        const auto it = wanted_.find(key_(data.cx, data.cz));
+        if (it == wanted_.end() || it->second != data.generation) continue;
+        ready_.push_back(std::move(data));
+    }
+}
@@ -0,0 +1,120 @@
+#include "ZoneManager.hpp"
+#include <cmath>
+
+using namespace threepp;
+
+namespace {
+    // Below this fraction of its initial volume a pile counts as dug out
+    constexpr float kDepletedFraction = 0.02f;
+}
+
+ZoneManager::ZoneManager(Object3D& parent, float cellSize)
+    : parent_(parent), cellSize_(cellSize > 0.f ? cellSize : 1.f) {}
+
+ZoneManager::~ZoneManager() {
+    for (auto& entry : digZones_) {
+        parent_.remove(*entry.zone->getVisual());
+        CollisionWorld::removeMeshCollider(entry.collider);
+    }
+    for (auto& zone : dumpZones_) {
+        parent_.remove(*zone->getVisual());
+    }
+}
+
+int ZoneManager::cell_(float v) const {
+    return static_cast<int>(std::floor(v / cellSize_));
+}
+
+void ZoneManager::insert_(const Vector3& position, float radius, int entry) {
+    const int x0 = cell_(position.x - radius);
+    const int x1 = cell_(position.x + radius);
+    const int z0 = cell_(position.z - radius);
+    const int z1 = cell_(position.z + radius);
+    for (int cz = z0; cz <= z1; ++cz) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            cells_[key_(cx, cz)].push_back(entry);
+        }
+    }
+}
+
+ZoneManager::ZoneId ZoneManager::addDigZone(const Vector3& position, float radius, int resolution) {
+    DigEntry entry;
+    entry.zone = std::make_unique<DigZone>(position, radius, resolution);
+    entry.zone->footprint(footprint_);
+    entry.collider = CollisionWorld::addMeshColliderFromPoints(footprint_);
+    parent_.add(entry.zone->getVisual());
+
+    const auto id = static_cast<ZoneId>(digZones_.size());
+    digZones_.push_back(std::move(entry));
+    insert_(position, radius, id);
+    return id;
+}
+
+ZoneManager::ZoneId ZoneManager::addDumpZone(const Vector3& position, float radius) {
+    auto zone = std::make_unique<DumpZone>(position, radius);
+    parent_.add(zone->getVisual());
+
+    const auto id = static_cast<ZoneId>(dumpZones_.size());
+    dumpZones_.push_back(std::move(zone));
+    insert_(position, radius, ~id);
+    return id;
+}
+
+ZoneManager::ZoneId ZoneManager::findDigZone(const Vector3& point) const {
+    const auto it = cells_.find(key_(cell_(point.x), cell_(point.z)));
+    if (it == cells_.end()) return -1;
+    for (const int entry : it->second) {
+        if (entry < 0) continue;
+        const auto& dig = digZones_[entry];
+        if (!dig.depleted && dig.zone->isInZone(point)) return entry;
+    }
+    return -1;
+}
+
+ZoneManager::ZoneId ZoneManager::findDumpZone(const Vector3& point) const {
+    const auto it = cells_.find(key_(cell_(point.x), cell_(point.z)));
+    if (it == cells_.end()) return -1;
+    for (const int entry : it->second) {
+        if (entry >= 0) continue;
+        if (dumpZones_[~entry]->isInZone(point)) return ~entry;
+    }
+    return -1;
+}
+
+float ZoneManager::excavate(ZoneId id, const Vector3& from, const Vector3& to, float radius, float capacity) {
+    auto& entry = digZones_[id];
+    if (entry.depleted) return 0.f;
+    const float removed = entry.zone->excavate(from, to, radius, capacity);
+    if (removed > 0.f) entry.changed = true;
+    return removed;
+}
+
+void ZoneManager::syncCollider_(DigEntry& entry) {
+    auto& zone = *entry.zone;
+    entry.depleted = zone.getVolume() < zone.getInitialVolume() * kDepletedFraction;
+    zone.getVisual()->visible = !entry.depleted;
+    CollisionWorld::setMeshColliderEnabled(entry.collider, !entry.depleted);
+    if (!entry.depleted) {
+        zone.footprint(footprint_);
+        CollisionWorld::updateMeshCollider(entry.collider, footprint_);
+    }
+    entry.changed = false;
+}
+
+void ZoneManager::update() {
+    for (auto& entry : digZones_) {
+        if (!entry.changed) continue;
+        syncCollider_(entry);
+        entry.zone->update(); // only the carved tiles
+    }
+}
+
+void ZoneManager::reset() {
+    for (auto& entry : digZones_) {
+        entry.zone->reset();
+        syncCollider_(entry);
+    }
+    for (auto& zone : dumpZones_) {
+        zone->reset();
+    }
+}
@@ -0,0 +1,117 @@
+#include "DebugDraw.hpp"
+#include <algorithm>
+
+using namespace threepp;
+
+DebugDraw::DebugDraw(Object3D& parent, size_t initialSegments)
+    : parent_(parent) {
+    material_ = LineBasicMaterial::create();
+    material_->vertexColors = true; // one material, each line brings its own colour
+    allocate_(static_, std::max<size_t>(initialSegments, 16));
+    allocate_(dynamic_, std::max<size_t>(initialSegments, 16));
+}
+
+DebugDraw::~DebugDraw() {
+    for (auto* buffer : {&static_, &dynamic_}) {
+        parent_.remove(*buffer->lines);
+        buffer->geometry->dispose();
+    }
+}
+
+void DebugDraw::allocate_(Buffer& buffer, size_t capacity) {
+    std::vector<float> positions(capacity * 6, 0.f);
+    std::vector<float> colors(capacity * 6, 0.f);
+    if (buffer.geometry) {
+        // Growing: keep the lines written so far
+        const auto& oldPositions = buffer.geometry->getAttribute<float>("position")->array();
+        const auto& oldColors = buffer.geometry->getAttribute<float>("color")->array();
+        std::copy_n(oldPositions.begin(), buffer.count * 6, positions.begin());
+        std::copy_n(oldColors.begin(), buffer.count * 6, colors.begin());
+    }
+
+    auto geometry = BufferGeometry::create();
+    geometry->setAttribute("position", FloatBufferAttribute::create(std::move(positions), 3));
+    geometry->setAttribute("color", FloatBufferAttribute::create(std::move(colors), 3));
+    geometry->setDrawRange(0, static_cast<int>(buffer.count * 2));
+
+    if (!buffer.lines) {
+        buffer.lines = LineSegments::create(geometry, material_);
+        buffer.lines->frustumCulled = false; // spans the whole site
+        buffer.lines->visible = visible_;
+        parent_.add(buffer.lines);
+    } else {
+        buffer.lines->setGeometry(geometry);
+        buffer.geometry->dispose(); // frees the old GPU buffers
+    }
+    buffer.geometry = geometry;
+    buffer.capacity = capacity;
+}
+
+void DebugDraw::write_(Buffer& buffer, const Vector3& a, const Vector3& b, const Color& color) {
+    if (buffer.count == buffer.capacity) allocate_(buffer, buffer.capacity * 2);
+    auto* positions = buffer.geometry->getAttribute<float>("position");
+    auto* colors = buffer.geometry->getAttribute<float>("color");
+    const int v = static_cast<int>(buffer.count * 2);
+    positions->setXYZ(v, a.x, a.y, a.z);
+    positions->setXYZ(v + 1, b.x, b.y, b.z);
+    colors->setXYZ(v, color.r, color.g, color.b);
+    colors->setXYZ(v + 1, color.r, color.g, color.b);
+    buffer.count++;
+}
+
+void DebugDraw::upload_(Buffer& buffer) {
+    buffer.geometry->setDrawRange(0, static_cast<int>(buffer.count * 2));
+    if (buffer.count == 0) return;
+    // Only the segments written, not the whole capacity
+    for (const char* name : {"position", "color"}) {
+        auto* attribute = buffer.geometry->getAttribute<float>(name);
+        attribute->updateRange.offset = 0;
+        attribute->updateRange.count = static_cast<int>(buffer.count * 6);
+        attribute->needsUpdate();
+    }
+}
+
+bool DebugDraw::beginStatic(uint64_t revision) {
+    if (hasStatic_ && revision == staticRevision_) return false;
+    static_.count = 0;
+    staticRevision_ = revision;
+    hasStatic_ = true;
+    staticOpen_ = true;
+    return true;
+}
+
+void DebugDraw::staticLine(const Vector3& a, const Vector3& b, const Color& color) {
+    write_(static_, a, b, color);
+}
+
+void DebugDraw::beginFrame() {
+    dynamic_.count = 0;
+}
+
+void DebugDraw::line(const Vector3& a, const Vector3& b, const Color& color) {
+    write_(dynamic_, a, b, color);
+}
+
+void DebugDraw::endFrame() {
+    if (staticOpen_) {
+        upload_(static_);
+        staticUploads_++;
+        staticOpen_ = false;
+    }
+    upload_(dynamic_);
+}
+
+void DebugDraw::setVisible(bool visible) {
+    visible_ = visible;
+    static_.lines->visible = visible;
+    dynamic_.lines->visible = visible;
+}
+
+void DebugDraw::clear() {
+    static_.count = 0;
+    dynamic_.count = 0;
+    hasStatic_ = false;
+    staticOpen_ = false;
+    static_.geometry->setDrawRange(0, 0);
+    dynamic_.geometry->setDrawRange(0, 0);
+}
@@ -0,0 +1,131 @@
+#include "GroundImprintAtlas.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace threepp;
+
+GroundImprintAtlas::GroundImprintAtlas(Object3D& ground, float halfExtent, float texelsPerMeter, int tileTexels)
+    : ground_(ground),
+      halfExtent_(halfExtent),
+      texelsPerMeter_(texelsPerMeter),
+      tileTexels_(std::max(1, tileTexels)) {
+    const float texelsAcross = 2.f * halfExtent_ * texelsPerMeter_;
+    tilesPerSide_ = std::max(1, static_cast<int>(std::ceil(texelsAcross / tileTexels_)));
+    texelsPerSide_ = tilesPerSide_ * tileTexels_;
+    tiles_.resize(static_cast<size_t>(tilesPerSide_) * tilesPerSide_); // empty until stamped
+    dirtyTiles_.reserve(tiles_.size());
+
+    // All tiles share one quad
+    const float tileMeters = tileTexels_ / texelsPerMeter_;
+    tileGeometry_ = PlaneGeometry::create(tileMeters, tileMeters);
+}
+
+GroundImprintAtlas::Tile& GroundImprintAtlas::tileAt_(int tx, int tz) {
+    Tile& tile = tiles_[static_cast<size_t>(tz) * tilesPerSide_ + tx];
+    if (tile.mesh) return tile;
+
+    // First touch: allocate the texture and hang the tile under the ground plane
+    const size_t texels = static_cast<size_t>(tileTexels_) * tileTexels_;
+    tile.alpha.assign(texels, 0);
+    tile.texture = DataTexture::create(std::vector<unsigned char>(texels * 4, 0), tileTexels_, tileTexels_);
+    tile.texture->magFilter = Filter::Linear;
+    tile.texture->minFilter = Filter::Linear;
+    tile.texture->generateMipmaps = false; // would have to be rebuilt on every upload
+
+    auto material = MeshBasicMaterial::create();
+    material->map = tile.texture;
+    material->transparent = true;
+    material->depthWrite = false;
+    tile.mesh = Mesh::create(tileGeometry_, material);
+
+    // Ground is rotated -90° around X, so world (x, z) is local (x, -z) and local +Z is up
+    const float tileMeters = tileTexels_ / texelsPerMeter_;
+    const float worldX = -halfExtent_ + (tx + 0.5f) * tileMeters;
+    const float worldZ = halfExtent_ - (tz + 0.5f) * tileMeters;
+    tile.mesh->position.set(worldX, -worldZ, 0.01f); // below the fresh decals at 0.02
+    ground_.add(tile.mesh);
+
+    allocatedTiles_++;
+    return tile;
+}
+
+void GroundImprintAtlas::stamp(const Vector3& center, float yaw, float width, float length, float strength) {
+    // Never go below one texel or thin tracks fall between texel centers
+    const float minSize = 1.f / texelsPerMeter_;
+    const float hw = std::max(width, minSize) * 0.5f;
+    const float hl = std::max(length, minSize) * 0.5f;
+    const float reach = std::sqrt(hw * hw + hl * hl);
+
+    // Texel rows run from +Z (row 0) towards -Z to match the plane's UVs
+    const int gx0 = std::max(0, static_cast<int>(std::floor((center.x - reach + halfExtent_) * texelsPerMeter_)));
+    const int gx1 = std::min(texelsPerSide_ - 1, static_cast<int>(std::floor((center.x + reach + halfExtent_) * texelsPerMeter_)));
+    const int gz0 = std::max(0, static_cast<int>(std::floor((halfExtent_ - (center.z + reach)) * texelsPerMeter_)));
+    const int gz1 = std::min(texelsPerSide_ - 1, static_cast<int>(std::floor((halfExtent_ - (center.z - reach)) * texelsPerMeter_)));
+    if (gx0 > gx1 || gz0 > gz1) return; // entirely outside the atlas
+
+    const float c = std::cos(yaw);
+    const float s = std::sin(yaw);
+    strength = std::clamp(strength, 0.f, 1.f);
+
+    for (int gz = gz0; gz <= gz1; ++gz) {
+        const float dz = (halfExtent_ - (gz + 0.5f) / texelsPerMeter_) - center.z;
+        for (int gx = gx0; gx <= gx1; ++gx) {
+            const float dx = ((gx + 0.5f) / texelsPerMeter_ - halfExtent_) - center.x;
+            // Into the imprint's local frame (inverse of the yaw rotation)
+            const float lx = dx * c - dz * s;
+            const float lz = dx * s + dz * c;
+            if (std::abs(lx) > hw || std::abs(lz) > hl) continue;
+
+            const int tx = gx / tileTexels_;
+            const int tz = gz / tileTexels_;
+            Tile& tile = tileAt_(tx, tz);
+            auto& a = tile.alpha[static_cast<size_t>(gz - tz * tileTexels_) * tileTexels_ + (gx - tx * tileTexels_)];
+            // Repeated passes keep darkening towards fully compacted
+            a = static_cast<unsigned char>(a + (255 - a) * strength);
+            if (!tile.dirty) {
+                tile.dirty = true;
+                dirtyTiles_.push_back(tz * tilesPerSide_ + tx);
+            }
+        }
+    }
+}
+
+void GroundImprintAtlas::flush() {
+    for (int index : dirtyTiles_) {
+        Tile& tile = tiles_[index];
+        auto& rgba = tile.texture->image().data<unsigned char>();
+        for (size_t i = 0, n = tile.alpha.size(); i < n; ++i) {
+            rgba[i * 4 + 0] = 0x33; // same dark soil as the decals
+            rgba[i * 4 + 1] = 0x2b;
+            rgba[i * 4 + 2] = 0x24;
+            rgba[i * 4 + 3] = tile.alpha[i];
+        }
+        tile.texture->needsUpdate(); // only this tile gets re-uploaded
+        tile.dirty = false;
+    }
+    dirtyTiles_.clear();
+}
+
+float GroundImprintAtlas::intensityAt(float x, float z) const {
+    const int gx = static_cast<int>(std::floor((x + halfExtent_) * texelsPerMeter_));
+    const int gz = static_cast<int>(std::floor((halfExtent_ - z) * texelsPerMeter_));
+    if (gx < 0 || gz < 0 || gx >= texelsPerSide_ || gz >= texelsPerSide_) return 0.f;
+
+    const int tx = gx / tileTexels_;
+    const int tz = gz / tileTexels_;
+    const Tile& tile = tiles_[static_cast<size_t>(tz) * tilesPerSide_ + tx];
+    if (tile.alpha.empty()) return 0.f;
+    return tile.alpha[static_cast<size_t>(gz - tz * tileTexels_) * tileTexels_ + (gx - tx * tileTexels_)] / 255.f;
+}
+
+void GroundImprintAtlas::clear() {
+    for (size_t i = 0; i < tiles_.size(); ++i) {
+        Tile& tile = tiles_[i];
+        if (!tile.mesh) continue;
+        std::fill(tile.alpha.begin(), tile.alpha.end(), 0);
+        if (!tile.dirty) {
+            tile.dirty = true;
+            dirtyTiles_.push_back(static_cast<int>(i));
+        }
+    }
+}
@@ -0,0 +1,100 @@
+#include "HeightfieldMesh.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace threepp;
+
+namespace {
+    // Soil thinner than this is treated as bare floor and tucked under the ground plane
+    constexpr float kBareSoil = 1e-3f;
+    constexpr float kBelowGround = -0.05f;
+}
+
+HeightfieldMesh::HeightfieldMesh(Heightfield& field, std::shared_ptr<Material> material)
+    : field_(field), root_(Group::create()) {
+    const int cells = field_.getTileCells();
+    const int tilesPerSide = field_.getTilesPerSide();
+    const int lastSample = field_.getResolution() - 1;
+
+    tiles_.reserve(static_cast<size_t>(tilesPerSide) * tilesPerSide);
+    for (int tz = 0; tz < tilesPerSide; ++tz) {
+        for (int tx = 0; tx < tilesPerSide; ++tx) {
+            Tile tile;
+            tile.i0 = tx * cells;
+            tile.j0 = tz * cells;
+            tile.cellsX = std::min(cells, lastSample - tile.i0);
+            tile.cellsZ = std::min(cells, lastSample - tile.j0);
+
+            // Allocate once, sync() only overwrites the contents
+            const int vx = tile.cellsX + 1;
+            const int vz = tile.cellsZ + 1;
+            tile.geometry = BufferGeometry::create();
+            tile.geometry->setAttribute("position", FloatBufferAttribute::create(std::vector<float>(vx * vz * 3, 0.f), 3));
+            tile.geometry->setAttribute("normal", FloatBufferAttribute::create(std::vector<float>(vx * vz * 3, 0.f), 3));
+
+            std::vector<unsigned int> indices;
+            indices.reserve(tile.cellsX * tile.cellsZ * 6);
+            for (int z = 0; z < tile.cellsZ; ++z) {
+                for (int x = 0; x < tile.cellsX; ++x) {
+                    const unsigned int a = z * vx + x;
+                    const unsigned int b = a + 1;
+                    const unsigned int c = a + vx;
+                    const unsigned int d = c + 1;
+                    indices.insert(indices.end(), {a, c, b, b, c, d}); // CCW seen from above
+                }
+            }
+            tile.geometry->setIndex(indices);
+
+            tile.mesh = Mesh::create(tile.geometry, material);
+            root_->add(tile.mesh);
+            writeTile_(tile);
+            tiles_.push_back(std::move(tile));
+        }
+    }
+    field_.clearDirty();
+}
+
+void HeightfieldMesh::writeTile_(Tile& tile) {
+    auto* positions = tile.geometry->getAttribute<float>("position");
+    auto* normals = tile.geometry->getAttribute<float>("normal");
+    const float spacing = field_.getSpacing();
+    const float floor = field_.getFloor();
+    const auto& center = field_.getCenter();
+    const int vx = tile.cellsX + 1;
+
+    float minY = 0.f;
+    float maxY = 0.f;
+    for (int z = 0; z <= tile.cellsZ; ++z) {
+        const int j = tile.j0 + z;
+        for (int x = 0; x < vx; ++x) {
+            const int i = tile.i0 + x;
+            const float h = field_.sample(i, j);
+            const float y = (h - floor > kBareSoil) ? h - center.y : kBelowGround;
+            positions->setXYZ(z * vx + x, field_.sampleX(i) - center.x, y, field_.sampleZ(j) - center.z);
+            minY = std::min(minY, y);
+            maxY = std::max(maxY, y);
+
+            // Central differences, only this vertex's neighbours are read
+            const float dx = (field_.sampleClamped(i + 1, j) - field_.sampleClamped(i - 1, j)) / (2.f * spacing);
+            const float dz = (field_.sampleClamped(i, j + 1) - field_.sampleClamped(i, j - 1)) / (2.f * spacing);
+            const float len = std::sqrt(dx * dx + 1.f + dz * dz);
+            normals->setXYZ(z * vx + x, -dx / len, 1.f / len, -dz / len);
+        }
+    }
+    positions->needsUpdate();
+    normals->needsUpdate();
+
+    // Keep frustum culling right without walking the buffer again
+    const Vector3 boxMin(field_.sampleX(tile.i0) - center.x, minY, field_.sampleZ(tile.j0) - center.z);
+    const Vector3 boxMax(boxMin.x + tile.cellsX * spacing, maxY, boxMin.z + tile.cellsZ * spacing);
+    tile.geometry->boundingBox = Box3(boxMin, boxMax);
+    tile.geometry->boundingSphere = Sphere{(boxMin + boxMax) * 0.5f, boxMin.distanceTo(boxMax) * 0.5f};
+}
+
+size_t HeightfieldMesh::sync() {
+    const auto& dirty = field_.getDirtyTiles();
+    for (int index : dirty) writeTile_(tiles_[index]);
+    const size_t uploaded = dirty.size();
+    field_.clearDirty();
+    return uploaded;
+}
@@ -1,11 +1,12 @@
 #include "ParticleSystem.hpp"
+#include "Settings.hpp"
 #include <algorithm>
 #include <random>
 
 using namespace threepp;
 
-ParticleSystem::ParticleSystem(Scene& scene)
-    : scene_(scene) {
+ParticleSystem::ParticleSystem(Scene& scene, unsigned int seed)
+    : scene_(scene), rng_(seed) {
     // shared geometries for all particles
     sphereGeometry_ = SphereGeometry::create(0.05f, 6, 6); // Small sphere, low poly
     pyramidGeometry_ = ConeGeometry::create(0.05f, 0.1f, 4); // 4-sided cone = pyramid
@@ -16,47 +17,109 @@ ParticleSystem::ParticleSystem(Scene& scene)
     particleMaterial_->transparent = true;
     particleMaterial_->opacity = 1.0f;
     particleMaterial_->depthWrite = false; // Avoid z-fighting with ground
+
+    // Point cloud for far away particles, one draw call no matter how many
+    spriteGeometry_ = BufferGeometry::create();
+    spriteGeometry_->setAttribute("position", FloatBufferAttribute::create(std::vector<float>(Settings::MaxParticleSprites * 3, 0.f), 3));
+    spriteGeometry_->setDrawRange(0, 0);
+    auto spriteMaterial = PointsMaterial::create();
+    spriteMaterial->color = Color(0.5f, 0.45f, 0.4f);
+    spriteMaterial->size = 0.08f;
+    spriteMaterial->sizeAttenuation = true;
+    spriteMaterial->transparent = true;
+    spriteMaterial->opacity = 0.6f;
+    spriteMaterial->depthWrite = false;
+    sprites_ = Points::create(spriteGeometry_, spriteMaterial);
+    sprites_->frustumCulled = false; // bounds change every frame, particles are culled by hand
+    scene_.add(sprites_);
+}
+
+void ParticleSystem::setCamera(const Camera* camera) {
+    camera_ = camera;
+    refreshFrustum_();
+}
+
+void ParticleSystem::refreshFrustum_() {
+    if (!camera_) return;
+    Matrix4 viewProjection;
+    viewProjection.multiplyMatrices(camera_->projectionMatrix, camera_->matrixWorldInverse);
+    frustum_.setFromProjectionMatrix(viewProjection);
 }
 
 void ParticleSystem::spawnParticle(const Vector3& position) {
+    if (camera_) {
+        // Offscreen emitters don't spawn at all (small sphere so edge emitters still count)
+        if (!frustum_.intersectsSphere(Sphere{position, 0.25f})) {
+            pendingCulled_++;
+            return;
+        }
+
+        // Far emitters spawn at a reduced rate, keep fractional credit so the rate is exact
+        const float dist = position.distanceTo(camera_->position);
+        float rate = 1.0f;
+        if (dist > Settings::particleLodNear_) {
+            float t = (dist - Settings::particleLodNear_) / std::max(0.001f, Settings::particleLodFar_ - Settings::particleLodNear_);
+            t = std::clamp(t, 0.0f, 1.0f);
+            rate = 1.0f + (Settings::particleLodMinRate_ - 1.0f) * t;
+        }
+        spawnCredit_ += rate;
+        if (spawnCredit_ < 1.0f) {
+            pendingDecimated_++;
+            return;
+        }
+        spawnCredit_ -= 1.0f;
+    }
+
     Particle p;
     p.lifetime = 0.0f;
     p.maxLifetime = 1.0f;
     
     // Add random offset to position so its not just a line
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_real_distribution<float> dis(-0.1f, 0.1f);
-    static std::uniform_int_distribution<int> shapeDis(0, 2);
+    std::uniform_real_distribution<float> dis(-0.1f, 0.1f);
+    std::uniform_int_distribution<int> shapeDis(0, 2);
     
     Vector3 randomPos = position;
-    randomPos.x += dis(gen);
-    randomPos.y += dis(gen) * 0.5f; // Less vertical randomness cus i dont want it being a cone
-    randomPos.z += dis(gen);
+    randomPos.x += dis(rng_);
+    randomPos.y += dis(rng_) * 0.5f; // Less vertical randomness cus i dont want it being a cone
+    randomPos.z += dis(rng_);
     
     // Randomly select geometry type
     std::shared_ptr<BufferGeometry> selectedGeometry;
-    int shapeType = shapeDis(gen);
+    int shapeType = shapeDis(rng_);
     switch (shapeType) {
         case 0: selectedGeometry = sphereGeometry_; break;
         case 1: selectedGeometry = pyramidGeometry_; break;
         case 2: selectedGeometry = boxGeometry_; break;
         default: selectedGeometry = sphereGeometry_;
     }
-    
-    // Create new material for this particle
-    auto mat = MeshBasicMaterial::create();
-    mat->color = Color(0.5f, 0.45f, 0.4f); // Dusty brown
-    mat->transparent = true;
-    mat->opacity = 0.8f;
-    mat->depthWrite = false;
-    
-    // Create mesh instance
-    p.mesh = Mesh::create(selectedGeometry, mat);
+
+    if (!pool_.empty()) {
+        // Reuse a dead particle, its mesh is still in the scene
+        p.mesh = std::move(pool_.back().mesh);
+        p.material = pool_.back().material;
+        pool_.pop_back();
+        p.mesh->setGeometry(selectedGeometry);
+    } else {
+        // Own material per particle so each one fades on its own
+        auto mat = MeshBasicMaterial::create();
+        mat->color = Color(0.5f, 0.45f, 0.4f); // Dusty brown
+        mat->transparent = true;
+        mat->depthWrite = false;
+        p.material = mat.get();
+
+        p.mesh = Mesh::create(selectedGeometry, mat);
+        scene_.add(p.mesh);
+    }
+    p.material->opacity = 0.8f;
+    p.mesh->visible = true;
     p.mesh->position.set(randomPos.x, randomPos.y + 0.05f, randomPos.z); // Slightly above ground
-    
-    scene_.add(p.mesh);
-    particles_.push_back(p);
+
+    particles_.push_back(std::move(p));
+}
+
+void ParticleSystem::release_(Particle& p) {
+    p.mesh->visible = false;
+    pool_.push_back(std::move(p));
 }
 
 void ParticleSystem::update(float deltaTime) {
@@ -68,34 +131,72 @@ void ParticleSystem::update(float deltaTime) {
         float opacity = 1.0f - normalizedLife;
         opacity = std::max(0.0f, opacity);
         
-        auto mat = std::dynamic_pointer_cast<MeshBasicMaterial>(p.mesh->material());
-        if (mat) {
-            mat->opacity = opacity * 0.8f; // Scale to max 0.8
-        }
+        p.material->opacity = opacity * 0.8f; // Scale to max 0.8
         
         // Slight upward drift cus i can
         p.mesh->position.y += deltaTime * 0.1f;
     }
     
-    // Remove dead particles (lifetime >= maxLifetime)
-    particles_.erase(
-        std::remove_if(particles_.begin(), particles_.end(),
-            [this](const Particle& p) {
-                if (p.lifetime >= p.maxLifetime) {
-                    scene_.remove(*p.mesh);
-                    return true;
-                }
-                return false;
-            }),
-        particles_.end()
-    );
+    // Dead particles (lifetime >= maxLifetime) go back to the pool, order of the live ones kept
+    size_t alive = 0;
+    for (auto& p : particles_) {
+        if (p.lifetime >= p.maxLifetime) {
+            release_(p);
+        } else {
+            if (&particles_[alive] != &p) particles_[alive] = std::move(p);
+            alive++;
+        }
+    }
+    particles_.resize(alive);
+
+    // --- LOD pass: decide how (or if) each particle is drawn ---
+    refreshFrustum_();
+    stats_ = Stats{};
+    stats_.simulated = particles_.size();
+    stats_.culledSpawns = pendingCulled_;
+    stats_.decimatedSpawns = pendingDecimated_;
+    pendingCulled_ = 0;
+    pendingDecimated_ = 0;
+
+    if (!camera_) {
+        stats_.rendered = particles_.size();
+    } else {
+        auto* spritePos = spriteGeometry_->getAttribute<float>("position");
+        const float spriteDistSq = Settings::particleSpriteDistance_ * Settings::particleSpriteDistance_;
+        size_t spriteCount = 0;
+        for (auto& p : particles_) {
+            const auto& pos = p.mesh->position;
+            if (!frustum_.containsPoint(pos)) {
+                p.mesh->visible = false;
+                continue;
+            }
+            if (pos.distanceToSquared(camera_->position) > spriteDistSq && spriteCount < static_cast<size_t>(Settings::MaxParticleSprites)) {
+                // Too far for the mesh to matter, draw it as a point instead
+                p.mesh->visible = false;
+                if (spritePos) spritePos->setXYZ(static_cast<int>(spriteCount), pos.x, pos.y, pos.z);
+                spriteCount++;
+            } else {
+                p.mesh->visible = true;
+            }
+            stats_.rendered++;
+        }
+        stats_.sprites = spriteCount;
+
+        // Only touch the GPU buffer when there is something new to show
+        if (spritePos && (spriteCount > 0 || lastSpriteCount_ > 0)) {
+            spriteGeometry_->setDrawRange(0, static_cast<int>(spriteCount));
+            spritePos->needsUpdate();
+        }
+        lastSpriteCount_ = spriteCount;
+    }
 }
 
 void ParticleSystem::clearParticles() {
     for (auto& p : particles_) {
-        if (p.mesh) {
-            scene_.remove(*p.mesh);
-        }
+        if (p.mesh) release_(p);
     }
     particles_.clear();
+    spriteGeometry_->setDrawRange(0, 0);
+    lastSpriteCount_ = 0;
+    spawnCredit_ = 0.f;
 }
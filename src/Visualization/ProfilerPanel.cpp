@@ -0,0 +1,154 @@
+#include "ProfilerPanel.hpp"
+#include "FrameProfiler.hpp"
+#include "AllocationTracker.hpp"
+#include "FrameArena.hpp"
+#include <imgui.h>
+#include <algorithm>
+#include <array>
+#include <cfloat>
+
+namespace {
+    // Zone colours, picked by id so a zone keeps its colour frame to frame
+    constexpr std::array<ImU32, 8> Palette = {
+        IM_COL32(230, 159, 0, 255),  IM_COL32(86, 180, 233, 255), IM_COL32(0, 158, 115, 255),
+        IM_COL32(240, 228, 66, 255), IM_COL32(0, 114, 178, 255),  IM_COL32(213, 94, 0, 255),
+        IM_COL32(204, 121, 167, 255), IM_COL32(160, 160, 160, 255),
+    };
+}
+
+void ProfilerPanel::draw() {
+    if (!visible) return;
+    ImGui::SetNextWindowPos({0, 320}, ImGuiCond_FirstUseEver, {0, 0});
+    ImGui::SetNextWindowSize({690, 420}, ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Frame profiler", &visible)) {
+        ImGui::End();
+        return;
+    }
+
+    bool paused = !FrameProfiler::enabled();
+    if (ImGui::Checkbox("Pause", &paused)) FrameProfiler::setEnabled(!paused);
+
+    const size_t frames = FrameProfiler::frameCount();
+    if (frames == 0) {
+        ImGui::Text("No frames recorded");
+        ImGui::End();
+        return;
+    }
+
+    // Frame time, oldest on the left
+    std::array<float, FrameProfiler::HistoryFrames> frameMs{};
+    double frameSum = 0.0;
+    size_t zonesPerFrame = 0;
+    for (size_t i = 0; i < frames; ++i) {
+        const auto& f = FrameProfiler::frame(frames - 1 - i);
+        frameMs[i] = f.frameMs;
+        frameSum += f.frameMs;
+        for (auto calls : f.zoneCalls) zonesPerFrame += calls;
+    }
+    const double avgFrameMs = frameSum / static_cast<double>(frames);
+    zonesPerFrame /= frames;
+    ImGui::SameLine();
+    // What the zones themselves cost, as a share of the frame
+    const double overheadMs = static_cast<double>(zonesPerFrame) * FrameProfiler::zoneCostNs() * 1e-6;
+    ImGui::Text("%zu frames, %.2f ms CPU/frame, %zu zones/frame at %.0f ns (%.3f%%)", frames, avgFrameMs,
+                zonesPerFrame, FrameProfiler::zoneCostNs(), avgFrameMs > 0.0 ? 100.0 * overheadMs / avgFrameMs : 0.0);
+    ImGui::PlotLines("##frameMs", frameMs.data(), static_cast<int>(frames), 0, "frame CPU (ms)", 0.f, FLT_MAX,
+                     ImVec2(ImGui::GetContentRegionAvail().x, 50.f));
+
+    // Heap allocations on the frame thread, the steady state should be zero
+    constexpr bool allocs = AllocationTracker::compiledIn;
+    if (allocs) {
+        const auto& last = FrameProfiler::frame(0);
+        double allocSum = 0.0;
+        for (size_t i = 0; i < frames; ++i) allocSum += FrameProfiler::frame(i).allocations;
+        ImGui::Text("Allocations: %u (%.1f KB) last frame, %.1f/frame avg", static_cast<unsigned>(last.allocations),
+                    static_cast<double>(last.allocatedBytes) / 1024.0, allocSum / static_cast<double>(frames));
+    }
+
+    // Scratch memory of the frame loop: what the biggest frame needed vs what the arena holds
+    const auto& arena = FrameArena::frame();
+    ImGui::Text("Frame arena: %.1f KB last frame, %.1f KB high water, %.1f KB capacity, %zu overflow blocks",
+                static_cast<double>(arena.lastFrameBytes()) / 1024.0, static_cast<double>(arena.highWater()) / 1024.0,
+                static_cast<double>(arena.capacity()) / 1024.0, arena.overflowBlocks());
+
+    // Rolling stats per zone (frames where a zone didn't run are left out of its numbers)
+    if (ImGui::BeginTable("zones", allocs ? 8 : 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Zone");
+        ImGui::TableSetupColumn("Calls");
+        ImGui::TableSetupColumn("Last ms");
+        ImGui::TableSetupColumn("Min ms");
+        ImGui::TableSetupColumn("Avg ms");
+        ImGui::TableSetupColumn("p99 ms");
+        if (allocs) {
+            ImGui::TableSetupColumn("Allocs");
+            ImGui::TableSetupColumn("Avg allocs");
+        }
+        ImGui::TableHeadersRow();
+        const auto& last = FrameProfiler::frame(0);
+        for (size_t id = 0; id < FrameProfiler::zoneCount(); ++id) {
+            const auto zone = static_cast<FrameProfiler::ZoneId>(id);
+            const auto st = FrameProfiler::stats(zone);
+            if (st.frames == 0) continue;
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(FrameProfiler::zoneName(zone));
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", static_cast<unsigned>(last.zoneCalls[id]));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", st.lastMs);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", st.minMs);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", st.avgMs);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", st.p99Ms);
+            if (allocs) {
+                ImGui::TableNextColumn();
+                ImGui::Text("%u (%.1f KB)", static_cast<unsigned>(last.zoneAllocations[id]),
+                            static_cast<double>(last.zoneAllocatedBytes[id]) / 1024.0);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", st.avgAllocations);
+            }
+        }
+        ImGui::EndTable();
+    }
+
+    // Timeline of one frame: x is time, nested zones one row further down
+    frameAge_ = std::clamp(frameAge_, 0, static_cast<int>(frames) - 1);
+    ImGui::SliderInt("Frame", &frameAge_, 0, static_cast<int>(frames) - 1, "%d frames ago");
+    const auto& f = FrameProfiler::frame(static_cast<size_t>(frameAge_));
+    const float rowHeight = ImGui::GetTextLineHeight() + 4.f;
+    int maxDepth = 0;
+    for (size_t i = 0; i < f.eventCount; ++i) maxDepth = std::max(maxDepth, static_cast<int>(f.events[i].depth));
+
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    const float width = std::max(1.f, ImGui::GetContentRegionAvail().x);
+    const float height = rowHeight * static_cast<float>(maxDepth + 1);
+    const float msToPx = f.frameMs > 0.f ? width / f.frameMs : 0.f;
+    ImDrawList* draw = ImGui::GetWindowDrawList();
+    draw->AddRectFilled(origin, ImVec2(origin.x + width, origin.y + height), IM_COL32(40, 40, 40, 255));
+
+    const ImVec2 mouse = ImGui::GetMousePos();
+    int hovered = -1;
+    for (size_t i = 0; i < f.eventCount; ++i) {
+        const auto& e = f.events[i];
+        const ImVec2 a(origin.x + e.startMs * msToPx, origin.y + rowHeight * e.depth);
+        const ImVec2 b(std::max(a.x + 1.f, a.x + e.durationMs * msToPx), a.y + rowHeight - 1.f);
+        draw->AddRectFilled(a, b, Palette[e.zone % Palette.size()]);
+        const char* name = FrameProfiler::zoneName(e.zone);
+        if (b.x - a.x > ImGui::CalcTextSize(name).x + 4.f) {
+            draw->PushClipRect(a, b, true);
+            draw->AddText(ImVec2(a.x + 2.f, a.y + 2.f), IM_COL32(0, 0, 0, 255), name);
+            draw->PopClipRect();
+        }
+        if (mouse.x >= a.x && mouse.x < b.x && mouse.y >= a.y && mouse.y < b.y) hovered = static_cast<int>(i);
+    }
+    ImGui::Dummy(ImVec2(width, height));
+    if (hovered >= 0) {
+        const auto& e = f.events[hovered];
+        ImGui::SetTooltip("%s: %.3f ms (at %.3f ms)", FrameProfiler::zoneName(e.zone), e.durationMs, e.startMs);
+    }
+    ImGui::Text("Frame: %.3f ms CPU, %u zone events", f.frameMs, static_cast<unsigned>(f.eventCount));
+
+    ImGui::End();
+}
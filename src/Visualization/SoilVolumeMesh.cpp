@@ -0,0 +1,36 @@
+#include "SoilVolumeMesh.hpp"
+#include <threepp/geometries/BoxGeometry.hpp>
+#include <threepp/math/Matrix4.hpp>
+
+SoilVolumeMesh::SoilVolumeMesh(const SoilVolume& volume, std::shared_ptr<threepp::Material> material, size_t capacity)
+    : volume_(volume), capacity_(capacity) {
+    const float size = volume_.getVoxelSize();
+    mesh_ = threepp::InstancedMesh::create(threepp::BoxGeometry::create(size, size, size), material, capacity_);
+    mesh_->frustumCulled = false; // bounds would only cover one cube at the origin
+
+    const threepp::Matrix4 hidden = threepp::Matrix4().makeScale(0.f, 0.f, 0.f);
+    for (size_t i = 0; i < capacity_; ++i) mesh_->setMatrixAt(i, hidden);
+    mesh_->instanceMatrix()->needsUpdate();
+}
+
+bool SoilVolumeMesh::sync() {
+    if (volume_.getRevision() == revision_) return false;
+    revision_ = volume_.getRevision();
+
+    size_t count = 0;
+    threepp::Matrix4 m;
+    volume_.forEachVoxel([&](int x, int y, int z, float fill) {
+        if (fill < 0.5f || count >= capacity_) return;
+        const auto p = volume_.voxelCenter(x, y, z);
+        mesh_->setMatrixAt(count++, m.makeTranslation(p.x, p.y, p.z));
+    });
+
+    // Collapse what was drawn last time and isn't anymore
+    if (count < drawn_) {
+        const threepp::Matrix4 hidden = threepp::Matrix4().makeScale(0.f, 0.f, 0.f);
+        for (size_t i = count; i < drawn_; ++i) mesh_->setMatrixAt(i, hidden);
+    }
+    drawn_ = count;
+    mesh_->instanceMatrix()->needsUpdate();
+    return true;
+}
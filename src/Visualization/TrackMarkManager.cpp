@@ -2,28 +2,91 @@
 #include "Settings.hpp"
 #include <threepp/math/MathUtils.hpp>
 #include <threepp/math/Vector3.hpp>
+#include <algorithm>
 #include <cmath>
 
-TrackMarkManager::TrackMarkManager(threepp::Scene& scene): scene_(scene) {}
+namespace {
+    // Spawn time given to unused slots so they start out fully faded
+    constexpr float kNeverSpawned = -1.0e6f;
 
-void TrackMarkManager::update(float dt, const threepp::Vector3& excavatorPos) {
-    // Update lifetimes & remove expired
-    for (auto it = marks_.begin(); it != marks_.end(); ) {
-        it->timeRemaining -= dt;
-        // Fade opacity based on remaining lifetime (just same shit as particles really)
-        if (auto stdMat = std::dynamic_pointer_cast<threepp::MeshStandardMaterial>(it->mesh->material())) {
-            float t = std::max(0.f, it->timeRemaining) / Settings::lifetime_;
-            float alpha = t * t; // smoother end fade
-            stdMat->transparent = true;
-            stdMat->opacity = alpha;
+    // Fade happens here instead of on the CPU: alpha = (remaining life)^2 like before
+    const char* kTrackMarkVertexShader = R"(
+        attribute float spawnTime;
+        uniform float uTime;
+        uniform float uLifetime;
+        varying float vAlpha;
+        void main() {
+            float t = clamp(1.0 - (uTime - spawnTime) / uLifetime, 0.0, 1.0);
+            vAlpha = t * t; // smoother end fade
+            gl_Position = projectionMatrix * modelViewMatrix * vec4(position, 1.0);
         }
-        if (it->timeRemaining <= 0.f) {
-            scene_.remove(*it->mesh);
-            it = marks_.erase(it);
-        } else {
-            ++it;
+    )";
+
+    const char* kTrackMarkFragmentShader = R"(
+        uniform vec3 uColor;
+        varying float vAlpha;
+        void main() {
+            if (vAlpha <= 0.001) discard;
+            gl_FragColor = vec4(uColor, vAlpha);
         }
+    )";
+}
+
+TrackMarkManager::TrackMarkManager(threepp::Scene& scene)
+    : scene_(scene), capacity_(Settings::MaxTrackMarks) {
+    // Preallocate every quad once: 4 verts per mark, static index buffer
+    geometry_ = threepp::BufferGeometry::create();
+    geometry_->setAttribute("position", threepp::FloatBufferAttribute::create(std::vector<float>(capacity_ * 4 * 3, 0.f), 3));
+    geometry_->setAttribute("spawnTime", threepp::FloatBufferAttribute::create(std::vector<float>(capacity_ * 4, kNeverSpawned), 1));
+
+    std::vector<unsigned int> indices;
+    indices.reserve(capacity_ * 6);
+    for (unsigned int q = 0; q < capacity_; ++q) {
+        const unsigned int v = q * 4;
+        indices.insert(indices.end(), {v, v + 2, v + 1, v + 1, v + 2, v + 3});
     }
+    geometry_->setIndex(indices);
+
+    material_ = threepp::ShaderMaterial::create();
+    material_->vertexShader = kTrackMarkVertexShader;
+    material_->fragmentShader = kTrackMarkFragmentShader;
+    material_->uniforms = {
+        {"uTime", threepp::Uniform(0.f)},
+        {"uLifetime", threepp::Uniform(Settings::lifetime_)},
+        {"uColor", threepp::Uniform(threepp::Color(0x333333))}
+    };
+    material_->transparent = true; // allow fading
+    material_->depthWrite = false;
+
+    mesh_ = threepp::Mesh::create(geometry_, material_);
+    mesh_->frustumCulled = false; // quads are scattered all over the arena
+    scene_.add(mesh_);
+}
+
+void TrackMarkManager::update(float dt, const threepp::Vector3& excavatorPos) {
+    // Only the clock moves per frame, the shader does the fading
+    time_ += dt;
+    material_->uniforms.at("uTime").value<float>() = time_;
+    material_->uniforms.at("uLifetime").value<float>() = std::max(0.001f, Settings::lifetime_);
+
+    // Upload whatever ground tiles got stamped last frame (no-op when nothing changed)
+    if (imprints_) imprints_->flush();
+
+    // One integer bump per heatmapSampleDistance_ driven, placed along this frame's path,
+    // so the counts follow the ground covered and not the frame rate
+    if (heatmap_ && hasSpawnedFirst_) {
+        const float dx = excavatorPos.x - lastFramePos_.x;
+        const float dz = excavatorPos.z - lastFramePos_.z;
+        const float step = std::max(0.01f, Settings::heatmapSampleDistance_);
+        const float travelled = std::sqrt(dx * dx + dz * dz);
+        float along = step - heatmapDistance_; // first sample point on this segment
+        for (; along <= travelled; along += step) {
+            const float t = along / travelled;
+            heatmap_->record(threepp::Vector3(lastFramePos_.x + dx * t, excavatorPos.y, lastFramePos_.z + dz * t));
+        }
+        heatmapDistance_ = travelled - (along - step);
+    }
+    lastFramePos_.copy(excavatorPos);
 
     // Handle spawning based on travelled distance on XZ plane
     if (!hasSpawnedFirst_) {
@@ -47,6 +110,7 @@ void TrackMarkManager::update(float dt, const threepp::Vector3& excavatorPos) {
         // Spawn at current position minus a small offset so theyre behind the tracks
         threepp::Vector3 spawnPos = excavatorPos - forwardDir * 0.2f;
         spawnMark(spawnPos, forwardDir);
+        uploadWrittenQuads_();
         Settings::distanceAccumulator_ = 0.f;
         lastSpawnPos_.copy(excavatorPos);
     }
@@ -71,27 +135,89 @@ void TrackMarkManager::spawnMark(const threepp::Vector3& pos, const threepp::Vec
     threepp::Vector3 leftPos = pos - rightDir * offsetDist;
     threepp::Vector3 rightPos = pos + rightDir * offsetDist;
 
-    auto createMarkMesh = [&](const threepp::Vector3& mpos) {
-        auto geom = threepp::PlaneGeometry::create(markWidth, markLength);
-        // Correct orientation: rotate -90° so plane lies in XZ and normal points up
-        geom->rotateX(-threepp::math::PI / 2.0f);
-        auto mat = threepp::MeshStandardMaterial::create();
-        mat->color.setHex(0x333333);
-        mat->roughness = 1.0f;
-        mat->metalness = 0.0f;
-        mat->transparent = true; // allow fading
-        mat->opacity = 1.0f;
-        auto mesh = threepp::Mesh::create(geom, mat);
-        // Derive excavator base yaw from movement direction.
-        // forwardDir = (-cos(baseYaw), sin(baseYaw)) in XZ from Excavator::update logic.
-        // Recover baseYaw: cos(baseYaw) = -forwardDir.x, sin(baseYaw) = forwardDir.z
-        float yaw = std::atan2(forwardDir.z, -forwardDir.x);
-        mesh->rotation.y = yaw;
-        mesh->position.set(mpos.x, 0.02f, mpos.z); // slight lift to avoid z-fighting
-        scene_.add(mesh);
-        marks_.push_back({mesh, Settings::lifetime_});
-    };
+    // Derive excavator base yaw from movement direction.
+    // forwardDir = (-cos(baseYaw), sin(baseYaw)) in XZ from Excavator::update logic.
+    // Recover baseYaw: cos(baseYaw) = -forwardDir.x, sin(baseYaw) = forwardDir.z
+    float yaw = std::atan2(forwardDir.z, -forwardDir.x);
+
+    writeQuad_(leftPos, yaw, markWidth, markLength);
+    writeQuad_(rightPos, yaw, markWidth, markLength);
+
+    if (imprints_) {
+        // Stamp the full imprint footprint, spacing along travel so consecutive stamps overlap
+        const float stampLength = std::max(markLength, Settings::spawnDistance_);
+        imprints_->stamp(leftPos, yaw, Settings::markWidth_, stampLength, Settings::imprintStrength_);
+        imprints_->stamp(rightPos, yaw, Settings::markWidth_, stampLength, Settings::imprintStrength_);
+    }
+}
+
+void TrackMarkManager::writeQuad_(const threepp::Vector3& center, float yaw, float width, float length) {
+    auto* positions = geometry_->getAttribute<float>("position");
+    auto* spawnTimes = geometry_->getAttribute<float>("spawnTime");
+
+    // Same footprint as the old rotated PlaneGeometry: width along local X, length along local Z,
+    // then rotated around Y by yaw. Slight lift to avoid z-fighting.
+    const float c = std::cos(yaw);
+    const float s = std::sin(yaw);
+    const float hw = width * 0.5f;
+    const float hl = length * 0.5f;
+    const float corners[4][2] = {{-hw, -hl}, {hw, -hl}, {-hw, hl}, {hw, hl}};
+
+    const int base = static_cast<int>(head_ * 4);
+    for (int i = 0; i < 4; ++i) {
+        const float lx = corners[i][0];
+        const float lz = corners[i][1];
+        positions->setXYZ(base + i, center.x + lx * c + lz * s, 0.02f, center.z - lx * s + lz * c);
+        spawnTimes->setX(base + i, time_);
+    }
+
+    if (dirtyCount_ == 0) dirtyStart_ = head_;
+    dirtyCount_ = std::min(dirtyCount_ + 1, capacity_);
+    head_ = (head_ + 1) % capacity_;
+}
+
+void TrackMarkManager::uploadWrittenQuads_() {
+    if (dirtyCount_ == 0) return;
+
+    // Only the quads written since the last upload go to the GPU. The update range is a single
+    // span, so a batch that wraps past the end of the ring falls back to a full upload.
+    const bool contiguous = dirtyStart_ + dirtyCount_ <= capacity_;
+    for (const char* name : {"position", "spawnTime"}) {
+        auto* attribute = geometry_->getAttribute<float>(name);
+        const int floatsPerQuad = 4 * attribute->itemSize();
+        if (contiguous) {
+            attribute->updateRange.offset = static_cast<int>(dirtyStart_) * floatsPerQuad;
+            attribute->updateRange.count = static_cast<int>(dirtyCount_) * floatsPerQuad;
+        } else {
+            attribute->updateRange.offset = 0;
+            attribute->updateRange.count = -1;
+        }
+        attribute->needsUpdate();
+    }
+    dirtyCount_ = 0;
+}
+
+size_t TrackMarkManager::getMarkCount() const {
+    const auto* spawnTimes = geometry_->getAttribute<float>("spawnTime");
+    size_t count = 0;
+    for (size_t q = 0; q < capacity_; ++q) {
+        if (time_ - spawnTimes->getX(static_cast<int>(q * 4)) < Settings::lifetime_) count++;
+    }
+    return count;
+}
+
+void TrackMarkManager::clear() {
+    auto* spawnTimes = geometry_->getAttribute<float>("spawnTime");
+    std::fill(spawnTimes->array().begin(), spawnTimes->array().end(), kNeverSpawned);
+    spawnTimes->updateRange.offset = 0;
+    spawnTimes->updateRange.count = -1; // whole buffer
+    spawnTimes->needsUpdate();
+    head_ = 0;
+    dirtyCount_ = 0;
+    hasSpawnedFirst_ = false;
+    Settings::distanceAccumulator_ = 0.f;
+}
 
-    createMarkMesh(leftPos);
-    createMarkMesh(rightPos);
+void TrackMarkManager::enablePersistentGround(threepp::Object3D& ground, float halfExtent) {
+    imprints_ = std::make_unique<GroundImprintAtlas>(ground, halfExtent);
 }
@@ -0,0 +1,196 @@
+#include <catch2/catch_test_macros.hpp>
+#include "AllocationTracker.hpp"
+#include "FrameArena.hpp"
+#include "FrameProfiler.hpp"
+#include "CollisionWorld.hpp"
+#include "CoinManager.hpp"
+#include "ParticleSystem.hpp"
+#include "TrackMarkManager.hpp"
+#include "ZoneManager.hpp"
+#include "Settings.hpp"
+#include <threepp/scenes/Scene.hpp>
+#include <threepp/objects/Group.hpp>
+#include <threepp/objects/Mesh.hpp>
+#include <threepp/geometries/BoxGeometry.hpp>
+#include <threepp/materials/MeshBasicMaterial.hpp>
+#include <cmath>
+#include <new>
+#include <thread>
+
+using namespace threepp;
+
+namespace {
+    // Called as functions, so the compiler can't drop the pair the way it may for new/delete expressions
+    void allocate(size_t bytes) {
+        void* p = ::operator new(bytes);
+        ::operator delete(p);
+    }
+}
+
+TEST_CASE("AllocationTracker: counts per thread while enabled", "[alloc]") {
+    AllocationTracker::setEnabled(false);
+    {
+        AllocationTracker::Scope off;
+        allocate(64);
+        REQUIRE(off.counts().allocations == 0);
+    }
+
+    AllocationTracker::setEnabled(true);
+    const auto totalBefore = AllocationTracker::total();
+    AllocationTracker::Scope scope;
+    allocate(64);
+    allocate(100);
+    const auto counted = scope.counts();
+    REQUIRE(counted.allocations == 2);
+    REQUIRE(counted.bytes == 164);
+
+    // Another thread's allocations are its own, only the total sees them
+    uint64_t workerAllocations = 0;
+    std::thread([&] {
+        AllocationTracker::Scope worker;
+        allocate(1000);
+        workerAllocations = worker.counts().allocations;
+    }).join();
+    const auto totalAfter = AllocationTracker::total();
+    AllocationTracker::setEnabled(false);
+
+    REQUIRE(workerAllocations == 1);
+    REQUIRE(totalAfter.allocations - totalBefore.allocations >= 3);
+    REQUIRE(totalAfter.bytes - totalBefore.bytes >= 1164);
+}
+
+TEST_CASE("FrameProfiler: allocations per frame and zone", "[alloc][profiler]") {
+    FrameProfiler::reset();
+    const auto outer = FrameProfiler::registerZone("alloc outer");
+    const auto inner = FrameProfiler::registerZone("alloc inner");
+    AllocationTracker::setEnabled(true);
+
+    FrameProfiler::beginFrame();
+    allocate(10);
+    {
+        FrameProfiler::Zone a(outer);
+        allocate(20);
+        {
+            FrameProfiler::Zone b(inner);
+            allocate(30);
+            allocate(40);
+        }
+    }
+    FrameProfiler::endFrame();
+    AllocationTracker::setEnabled(false);
+
+    const auto& f = FrameProfiler::frame(0);
+    REQUIRE(f.allocations == 4);
+    REQUIRE(f.allocatedBytes == 100);
+    // A zone includes what the zones inside it allocate
+    REQUIRE(f.zoneAllocations[inner] == 2);
+    REQUIRE(f.zoneAllocatedBytes[inner] == 70);
+    REQUIRE(f.zoneAllocations[outer] == 3);
+    REQUIRE(f.zoneAllocatedBytes[outer] == 90);
+    REQUIRE(FrameProfiler::stats(inner).avgAllocations == 2.0f);
+    FrameProfiler::reset();
+}
+
+// Steady-state check: once warmed up, a frame of the per-frame systems must not touch the heap.
+// Each system is counted on its own so a failure names the culprit
+TEST_CASE("Steady-state frames don't allocate", "[alloc]") {
+    CollisionWorld::clear();
+    Scene scene;
+
+    const auto hull = CollisionWorld::footprintHull({{-1.f, -1.f}, {1.f, -1.f}, {1.f, 1.f}, {-1.f, 1.f}});
+    for (int i = 0; i < 50; ++i) {
+        CollisionWorld::addMeshColliderFromTemplate(hull, static_cast<float>(i % 10) * 6.f - 30.f,
+                                                    static_cast<float>(i / 10) * 6.f - 15.f, 0.3f * i, 1.f);
+    }
+
+    ZoneManager zones(scene, 8.0f);
+    zones.addDigZone(Vector3(0.f, 0.f, 18.f), 3.f, 32);
+    zones.addDumpZone(Vector3(10.f, 0.f, 18.f), 3.f);
+
+    CoinManager coins(scene, 7);
+    coins.spawnCoins(15, 30.f);
+
+    TrackMarkManager marks(scene);
+    marks.setSpawnDistance(0.4f);
+    marks.setLifetime(1.f);
+    Settings::distanceAccumulator_ = 0.f;
+
+    ParticleSystem particles(scene, 7);
+
+    // Excavator stand-in for the per-part hull checks: base, body and boom boxes under one root
+    auto root = Group::create();
+    std::shared_ptr<Mesh> parts[3];
+    const float heights[3] = {0.3f, 1.1f, 1.8f};
+    for (int i = 0; i < 3; ++i) {
+        parts[i] = Mesh::create(BoxGeometry::create(1.8f, 0.6f, 2.f), MeshBasicMaterial::create());
+        parts[i]->position.y = heights[i];
+        root->add(parts[i]);
+    }
+
+    AllocationTracker::Counts collision{}, zoneChecks{}, coinChecks{}, trackMarks{}, dust{};
+    auto frame = [&](int i, bool measure) {
+        const float dt = 1.f / 60.f;
+        // One lap every 300 frames, so the measured frames only revisit places the warm-up drove over
+        const float angle = 6.2831853f * static_cast<float>(i) / 300.f;
+        Vector3 pos(12.f * std::cos(angle), 0.f, 12.f * std::sin(angle));
+        auto add = [measure](AllocationTracker::Counts& to, const AllocationTracker::Scope& scope) {
+            if (!measure) return;
+            const auto c = scope.counts();
+            to.allocations += c.allocations;
+            to.bytes += c.bytes;
+        };
+        {
+            AllocationTracker::Scope scope;
+            CollisionWorld::resolveExcavatorMove(pos.x, pos.z, 1.2f);
+            root->position.set(pos.x, 0.f, pos.z);
+            CollisionWorld::resolveExcavatorMeshCollisions(root.get(), parts[0].get(), parts[1].get(), parts[2].get(),
+                                                           nullptr, nullptr);
+            add(collision, scope);
+        }
+        {
+            AllocationTracker::Scope scope;
+            zones.findDigZone(pos);
+            zones.findDumpZone(pos);
+            zones.update();
+            add(zoneChecks, scope);
+        }
+        {
+            AllocationTracker::Scope scope;
+            coins.update(dt);
+            coins.checkCollection(pos, 3.f);
+            if (i % 300 == 299) coins.reset();
+            add(coinChecks, scope);
+        }
+        {
+            AllocationTracker::Scope scope;
+            marks.update(dt, pos);
+            add(trackMarks, scope);
+        }
+        {
+            AllocationTracker::Scope scope;
+            // Two emitters a frame with a one second lifetime: about 120 alive, old ones recycled
+            particles.spawnParticle(pos);
+            particles.spawnParticle(pos);
+            particles.update(dt);
+            add(dust, scope);
+        }
+        FrameArena::frame().reset();
+    };
+
+    // Warm-up: pools, rings and vectors reach their working size
+    AllocationTracker::setEnabled(true);
+    for (int i = 0; i < 300; ++i) frame(i, false);
+    for (int i = 300; i < 900; ++i) frame(i, true);
+    AllocationTracker::setEnabled(false);
+
+    CHECK(collision.allocations == 0);
+    CHECK(zoneChecks.allocations == 0);
+    CHECK(coinChecks.allocations == 0);
+    CHECK(trackMarks.allocations == 0);
+    CHECK(dust.allocations == 0);
+    REQUIRE(particles.getActiveCount() > 0);
+    REQUIRE(particles.getPooledCount() > 0);
+    // The part hulls lived in the frame arena
+    REQUIRE(FrameArena::frame().highWater() > 0);
+    CollisionWorld::clear();
+}
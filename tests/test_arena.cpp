@@ -0,0 +1,70 @@
+#include <catch2/catch_test_macros.hpp>
+#include "FrameArena.hpp"
+#include "AllocationTracker.hpp"
+#include <cstdint>
+#include <memory_resource>
+
+TEST_CASE("FrameArena: bump allocation, alignment and reset", "[arena]") {
+    FrameArena arena(4096);
+    REQUIRE(arena.capacity() == 4096);
+    REQUIRE(arena.used() == 0);
+
+    void* a = arena.allocate(3, 1);
+    void* b = arena.allocate(8, 8);
+    void* c = arena.allocate(64, 64);
+    REQUIRE(reinterpret_cast<uintptr_t>(b) % 8 == 0);
+    REQUIRE(reinterpret_cast<uintptr_t>(c) % 64 == 0);
+    REQUIRE(static_cast<std::byte*>(b) > static_cast<std::byte*>(a));
+    REQUIRE(arena.used() >= 75);
+
+    // Freeing is a no-op, the bytes come back at reset
+    const size_t used = arena.used();
+    arena.deallocate(b, 8, 8);
+    REQUIRE(arena.used() == used);
+
+    arena.reset();
+    REQUIRE(arena.used() == 0);
+    REQUIRE(arena.lastFrameBytes() == used);
+    REQUIRE(arena.highWater() == used);
+    REQUIRE(arena.allocate(3, 1) == a); // same memory again next frame
+}
+
+TEST_CASE("FrameArena: pmr containers and rewind", "[arena]") {
+    FrameArena arena(64 * 1024);
+    {
+        FrameArena::Rewind rewind(arena);
+        std::pmr::vector<int> values(&arena);
+        for (int i = 0; i < 1000; ++i) values.push_back(i);
+        REQUIRE(values[999] == 999);
+        REQUIRE(arena.used() >= 1000 * sizeof(int));
+    }
+    // The scope handed everything back, the high water still remembers it
+    REQUIRE(arena.used() == 0);
+    REQUIRE(arena.frameHighWater() >= 1000 * sizeof(int));
+}
+
+TEST_CASE("FrameArena: a frame that doesn't fit grows the arena once", "[arena]") {
+    FrameArena arena(256);
+    auto frame = [&] {
+        for (int i = 0; i < 10; ++i) (void)arena.allocate(100, 16);
+        arena.reset();
+    };
+
+    frame();
+    REQUIRE(arena.overflowBlocks() > 0);
+    REQUIRE(arena.capacity() >= 1000);
+    REQUIRE(arena.lastFrameBytes() >= 1000);
+    const size_t overflows = arena.overflowBlocks();
+    const size_t capacity = arena.capacity();
+
+    // From then on the same frame fits in one block and stays off the heap
+    AllocationTracker::setEnabled(true);
+    AllocationTracker::Scope heap;
+    for (int i = 0; i < 100; ++i) frame();
+    const auto counted = heap.counts();
+    AllocationTracker::setEnabled(false);
+
+    REQUIRE(counted.allocations == 0);
+    REQUIRE(arena.overflowBlocks() == overflows);
+    REQUIRE(arena.capacity() == capacity);
+}
@@ -0,0 +1,292 @@
+#include <catch2/catch_test_macros.hpp>
+#include "MeshCache.hpp"
+#include "AssetRegistry.hpp"
+#include "Settings.hpp"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+    fs::path testDir() {
+        auto dir = fs::temp_directory_path() / "excavator_meshcache_test";
+        fs::create_directories(dir);
+        return dir;
+    }
+
+    void writeText(const fs::path& path, const std::string& text) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << text;
+    }
+
+    // Unit quad in the XZ plane as triangle soup, the way OBJLoader hands it over
+    MeshCache::Part quadPart() {
+        const std::vector<float> positions = {
+            0, 0, 0,  1, 0, 0,  1, 0, 1,
+            0, 0, 0,  1, 0, 1,  0, 0, 1,
+        };
+        std::vector<float> normals;
+        for (int i = 0; i < 6; ++i) normals.insert(normals.end(), {0.f, 1.f, 0.f});
+        return MeshCache::weld("quad", {0.9f, 0.7f, 0.1f}, positions, normals);
+    }
+
+    // n x n grid of quads (two triangles each), unwelded
+    MeshCache::MeshData gridData(int n) {
+        std::vector<float> positions, normals;
+        for (int z = 0; z < n; ++z) {
+            for (int x = 0; x < n; ++x) {
+                const float fx = static_cast<float>(x), fz = static_cast<float>(z);
+                const float quad[] = {fx, 0, fz,  fx + 1, 0, fz,  fx + 1, 0, fz + 1,
+                                      fx, 0, fz,  fx + 1, 0, fz + 1,  fx, 0, fz + 1};
+                positions.insert(positions.end(), std::begin(quad), std::end(quad));
+                for (int i = 0; i < 6; ++i) normals.insert(normals.end(), {0.f, 1.f, 0.f});
+            }
+        }
+        MeshCache::MeshData data;
+        data.parts.push_back(MeshCache::weld("grid", {1.f, 1.f, 1.f}, positions, normals));
+        MeshCache::computeBounds(data);
+        return data;
+    }
+}
+
+TEST_CASE("MeshCache: welding shares identical vertices", "[assets]") {
+    const auto part = quadPart();
+    REQUIRE(part.vertexCount() == 4);
+    REQUIRE(part.indices.size() == 6);
+    REQUIRE(part.positions.size() == 4 * 3);
+    REQUIRE(part.normals.size() == 4 * 3);
+    // Triangles still point at the same corners
+    for (size_t i = 0; i < 6; ++i) REQUIRE(part.indices[i] < part.vertexCount());
+    REQUIRE(part.indices[0] == part.indices[3]);
+    REQUIRE(part.indices[2] == part.indices[4]);
+
+    // Same position with another normal is a different vertex (hard edge)
+    const auto edge = MeshCache::weld("edge", {1.f, 1.f, 1.f}, {0, 0, 0, 0, 0, 0}, {0, 1, 0, 1, 0, 0});
+    REQUIRE(edge.vertexCount() == 2);
+
+    // An indexed mesh keeps its triangles
+    const auto indexed = MeshCache::weld("indexed", {1.f, 1.f, 1.f}, {0, 0, 0, 1, 0, 0, 0, 0, 0}, {}, {0, 1, 2});
+    REQUIRE(indexed.vertexCount() == 2);
+    REQUIRE(indexed.indices == std::vector<uint32_t>{0, 1, 0});
+}
+
+TEST_CASE("MeshCache: bounds and hull", "[assets]") {
+    auto data = gridData(4);
+    REQUIRE(data.parts[0].vertexCount() == 25);
+    REQUIRE(data.boundsMin.x == 0.f);
+    REQUIRE(data.boundsMin.z == 0.f);
+    REQUIRE(data.boundsMax.x == 4.f);
+    REQUIRE(data.boundsMax.z == 4.f);
+    REQUIRE(data.parts[0].boundsMax.x == 4.f);
+    REQUIRE(data.hull.size() == 4); // collinear edge vertices dropped
+
+    // A flat sliver has no footprint
+    MeshCache::MeshData line;
+    line.parts.push_back(MeshCache::weld("line", {1.f, 1.f, 1.f}, {0, 0, 0, 1, 0, 0, 2, 1, 0}, {}));
+    MeshCache::computeBounds(line);
+    REQUIRE(line.hull.empty());
+}
+
+TEST_CASE("MeshCache: write and read back", "[assets]") {
+    const auto path = testDir() / "roundtrip.meshbin";
+    auto data = gridData(8);
+    data.parts.push_back(quadPart());
+    MeshCache::computeBounds(data);
+    REQUIRE(MeshCache::write(path, data, 42u));
+
+    const auto loaded = MeshCache::read(path, 42u);
+    REQUIRE(loaded);
+    REQUIRE(loaded->parts.size() == data.parts.size());
+    for (size_t i = 0; i < data.parts.size(); ++i) {
+        const auto& a = data.parts[i];
+        const auto& b = loaded->parts[i];
+        REQUIRE(b.name == a.name);
+        REQUIRE(b.color == a.color);
+        REQUIRE(b.positions == a.positions);
+        REQUIRE(b.normals == a.normals);
+        REQUIRE(b.indices == a.indices);
+        REQUIRE(b.boundsMax.x == a.boundsMax.x);
+    }
+    REQUIRE(loaded->hull.size() == data.hull.size());
+    for (size_t i = 0; i < data.hull.size(); ++i) {
+        REQUIRE(loaded->hull[i].x == data.hull[i].x);
+        REQUIRE(loaded->hull[i].y == data.hull[i].y);
+    }
+    REQUIRE(loaded->boundsMin.x == data.boundsMin.x);
+    REQUIRE(loaded->boundsMax.z == data.boundsMax.z);
+
+    fs::remove(path);
+}
+
+TEST_CASE("MeshCache: stale or damaged files are rejected", "[assets]") {
+    const auto dir = testDir();
+    const auto path = dir / "damaged.meshbin";
+    const auto data = gridData(3);
+    REQUIRE(MeshCache::write(path, data, 7u));
+
+    REQUIRE_FALSE(MeshCache::read(path, 8u)); // source changed since
+    REQUIRE_FALSE(MeshCache::read(dir / "missing.meshbin", 7u));
+
+    // Cut short
+    fs::resize_file(path, fs::file_size(path) - 5);
+    REQUIRE_FALSE(MeshCache::read(path, 7u));
+
+    // Not a cache file at all
+    writeText(path, "v 0 0 0\nv 1 0 0\nv 0 0 1\nf 1 2 3\n");
+    REQUIRE_FALSE(MeshCache::read(path, 7u));
+
+    fs::remove(path);
+}
+
+TEST_CASE("MeshCache: keys follow the source", "[assets]") {
+    const auto dir = testDir();
+    const auto obj = dir / "model.obj";
+    const auto mtl = dir / "model.mtl";
+    writeText(obj, "v 0 0 0\nv 1 0 0\nv 0 0 1\nf 1 2 3\n");
+    writeText(mtl, "newmtl a\nKd 1 1 0\n");
+
+    const auto key = MeshCache::sourceKey(obj, false);
+    REQUIRE(key != 0);
+    REQUIRE(MeshCache::sourceKey(obj, false) == key);
+    REQUIRE(MeshCache::sourceKey(obj, true) != key); // loader flag and MTL are part of it
+    REQUIRE(MeshCache::cachePathFor(obj, true) != MeshCache::cachePathFor(obj, false));
+
+    // Same file name in another folder gets its own cache file, another spelling of the same path doesn't
+    REQUIRE(MeshCache::cachePathFor(dir / "other" / "model.obj", false) != MeshCache::cachePathFor(obj, false));
+    REQUIRE(MeshCache::cachePathFor(dir / "other" / ".." / "model.obj", false) == MeshCache::cachePathFor(obj, false));
+
+    const auto withMtl = MeshCache::sourceKey(obj, true);
+    writeText(mtl, "newmtl a\nKd 0 1 1\n");
+    REQUIRE(MeshCache::sourceKey(obj, true) != withMtl);
+    REQUIRE(MeshCache::sourceKey(obj, false) == key);
+
+    writeText(obj, "v 0 0 0\nv 2 0 0\nv 0 0 1\nf 1 2 3\n");
+    REQUIRE(MeshCache::sourceKey(obj, false) != key);
+
+    REQUIRE(MeshCache::hashFile(dir / "missing.obj") == 0);
+    fs::remove(obj);
+    fs::remove(mtl);
+}
+
+TEST_CASE("MeshCache: OBJ parsing", "[assets]") {
+    const auto dir = testDir();
+    const auto obj = dir / "parse.obj";
+    writeText(dir / "parse.mtl", "newmtl red\nKd 1 0 0\nnewmtl blue\nKd 0 0 1\n");
+    writeText(obj,
+              "mtllib parse.mtl\n"
+              "v 0 0 0\nv 1 0 0\nv 1 0 1\nv 0 0 1\n"
+              "vn 0 1 0\n"
+              "o floor\nusemtl red\n"
+              "f 1//1 2//1 3//1 4//1\n"  // quad, fanned into two triangles
+              "o wall\nusemtl blue\n"
+              "v 0 1 0\n"
+              "f -5 -4 -1\n");           // relative indices, no normals
+
+    const auto data = MeshCache::parseObj(obj, true);
+    REQUIRE(data);
+    REQUIRE(data->parts.size() == 2);
+    const auto& floor = data->parts[0];
+    REQUIRE(floor.indices.size() == 6);
+    REQUIRE(floor.vertexCount() == 4);
+    REQUIRE(floor.color == std::array<float, 3>{1.f, 0.f, 0.f});
+
+    const auto& wall = data->parts[1];
+    REQUIRE(wall.indices.size() == 3);
+    REQUIRE(wall.color == std::array<float, 3>{0.f, 0.f, 1.f});
+    // Flat normal from the winding: (1,0,0) x (0,1,0)
+    REQUIRE(std::abs(wall.normals[2] - 1.f) < 1e-5f);
+    REQUIRE(data->boundsMax.y == 1.f);
+    REQUIRE(data->hull.size() == 4);
+
+    // Without the MTL everything is white
+    REQUIRE(MeshCache::parseObj(obj, false)->parts[0].color == std::array<float, 3>{1.f, 1.f, 1.f});
+    REQUIRE_FALSE(MeshCache::parseObj(dir / "missing.obj", false));
+
+    // One group, two materials (like Gate.obj): a part per material, each with its colour
+    const auto mixed = dir / "mixed.obj";
+    writeText(mixed,
+              "mtllib parse.mtl\n"
+              "v 0 0 0\nv 1 0 0\nv 1 0 1\nv 0 0 1\n"
+              "g Body1\nusemtl red\n"
+              "f 1 2 3\n"
+              "usemtl blue\n"
+              "f 1 3 4\n");
+    const auto mixedData = MeshCache::parseObj(mixed, true);
+    REQUIRE(mixedData);
+    REQUIRE(mixedData->parts.size() == 2);
+    REQUIRE(mixedData->parts[0].color == std::array<float, 3>{1.f, 0.f, 0.f});
+    REQUIRE(mixedData->parts[1].color == std::array<float, 3>{0.f, 0.f, 1.f});
+    REQUIRE(mixedData->parts[1].name == "Body1");
+
+    fs::remove(mixed);
+    fs::remove(obj);
+    fs::remove(dir / "parse.mtl");
+}
+
+TEST_CASE("AssetRegistry: named assets are created once", "[assets]") {
+    AssetRegistry::clear();
+    int created = 0;
+    auto make = [&] {
+        ++created;
+        return threepp::BoxGeometry::create(1.f, 1.f, 1.f);
+    };
+    const auto a = AssetRegistry::geometry("box", make);
+    const auto b = AssetRegistry::geometry("box", make);
+    const auto c = AssetRegistry::geometry("other box", make);
+    REQUIRE(a == b);
+    REQUIRE(a != c);
+    REQUIRE(created == 2);
+
+    const auto m1 = AssetRegistry::material("dirt", [] { return threepp::MeshStandardMaterial::create(); });
+    const auto m2 = AssetRegistry::material("dirt", [] { return threepp::MeshStandardMaterial::create(); });
+    REQUIRE(m1 == m2);
+
+    const auto report = AssetRegistry::report();
+    REQUIRE(report.geometries == 2);
+    REQUIRE(report.geometryRefs == 3);
+    REQUIRE(report.materials == 1);
+    REQUIRE(report.materialRefs == 2);
+    REQUIRE(report.uniqueBytes > 0);
+    REQUIRE(report.referencedBytes > report.uniqueBytes);
+    AssetRegistry::clear();
+}
+
+TEST_CASE("AssetRegistry: a model loaded twice shares its geometry", "[assets]") {
+    AssetRegistry::clear();
+    const auto dir = testDir();
+    const auto* cacheDir = Settings::meshCacheDir_;
+    const auto cacheDirString = (dir / "cache").string();
+    Settings::meshCacheDir_ = cacheDirString.c_str();
+
+    const auto obj = dir / "shared.obj";
+    writeText(obj, "v 0 0 0\nv 1 0 0\nv 1 0 1\nv 0 0 1\nf 1 2 3\nf 1 3 4\n");
+    // Same file by another name is the same asset
+    const auto left = AssetRegistry::load(obj.string());
+    const auto right = AssetRegistry::load((dir / "." / "shared.obj").string());
+    REQUIRE(left.group);
+    REQUIRE(right.group);
+    REQUIRE(left.group != right.group); // own scene nodes, they're placed separately
+    REQUIRE(left.hull.size() == 4);
+
+    std::vector<std::shared_ptr<threepp::BufferGeometry>> leftGeometry, rightGeometry;
+    left.group->traverseType<threepp::Mesh>([&](threepp::Mesh& m) { leftGeometry.push_back(m.geometry()); });
+    right.group->traverseType<threepp::Mesh>([&](threepp::Mesh& m) { rightGeometry.push_back(m.geometry()); });
+    REQUIRE_FALSE(leftGeometry.empty());
+    REQUIRE(leftGeometry == rightGeometry);
+
+    const auto report = AssetRegistry::report();
+    REQUIRE(report.models == 1);
+    REQUIRE(report.modelRefs == 2);
+    REQUIRE(report.geometryRefs == 2 * report.geometries);
+    REQUIRE(report.referencedBytes == 2 * report.uniqueBytes);
+
+    // Missing files aren't remembered
+    REQUIRE_FALSE(AssetRegistry::load((dir / "missing.obj").string()).group);
+    REQUIRE(AssetRegistry::report().models == 1);
+
+    AssetRegistry::clear();
+    Settings::meshCacheDir_ = cacheDir;
+    fs::remove_all(dir / "cache");
+    fs::remove(obj);
+}
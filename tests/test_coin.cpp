@@ -2,17 +2,13 @@
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 #include "Coin.hpp"
 #include "CoinManager.hpp"
+#include "AllocationTracker.hpp"
 #include <threepp/scenes/Scene.hpp>
-#include <threepp/geometries/CylinderGeometry.hpp>
-#include <threepp/materials/MeshStandardMaterial.hpp>
+#include <threepp/math/Matrix4.hpp>
 
 TEST_CASE("Coin state management", "[coin]") {
     threepp::Vector3 pos(1.0f, 1.0f, 1.0f);
-    auto geom = threepp::CylinderGeometry::create(0.5f, 0.5f, 0.1f);
-    auto mat = threepp::MeshStandardMaterial::create();
-    auto mesh = threepp::Mesh::create(geom, mat);
-    
-    Coin coin(pos, mesh);
+    Coin coin(pos, 7);
     
     SECTION("Initially not collected") {
         REQUIRE_FALSE(coin.isCollected());
@@ -23,14 +19,10 @@ TEST_CASE("Coin state management", "[coin]") {
         REQUIRE(coin.isCollected());
     }
     
-    SECTION("Update stops after collection") {
+    SECTION("Keeps its position and instance slot") {
         coin.collect();
-        float initialY = mesh->position.y;
-        
-        // Update should do nothing when collected
-        coin.update(1.0f);
-        
-        REQUIRE(mesh->position.y == initialY);
+        REQUIRE(coin.getPosition().y == 1.0f);
+        REQUIRE(coin.getInstanceId() == 7);
     }
 }
 
@@ -56,11 +48,149 @@ TEST_CASE("CoinManager spawning and collection", "[coin]") {
         REQUIRE(manager.getCollectedCount() > 0);
     }
     
-    SECTION("Reset clears all coins") {
+    SECTION("All coins are drawn by one instanced mesh") {
+        manager.spawnCoins(5, 15.0f);
+        manager.spawnCoins(3, 15.0f);
+        
+        auto instances = manager.getInstancedMesh();
+        REQUIRE(instances != nullptr);
+        REQUIRE(instances->count() == 8);
+        REQUIRE(scene.children.size() == 1);
+    }
+    
+    SECTION("Collected coins are hidden by a zero-scale instance") {
+        manager.spawnCoins(4, 10.0f);
+        manager.checkCollection(threepp::Vector3(0.0f, 0.0f, 0.0f), 50.0f);
+        
+        threepp::Matrix4 m;
+        for (const auto& coin : manager.getCoins()) {
+            REQUIRE(coin.isCollected());
+            manager.getInstancedMesh()->getMatrixAt(coin.getInstanceId(), m);
+            REQUIRE(m.elements[0] == 0.0f);
+            REQUIRE(m.elements[5] == 0.0f);
+            REQUIRE(m.elements[10] == 0.0f);
+        }
+    }
+    
+    SECTION("Update doesn't touch the instances") {
+        manager.spawnCoins(2, 10.0f);
+        threepp::Matrix4 before;
+        manager.getInstancedMesh()->getMatrixAt(0, before);
+        manager.update(1.0f);
+        threepp::Matrix4 after;
+        manager.getInstancedMesh()->getMatrixAt(0, after);
+        REQUIRE(before.elements == after.elements);
+    }
+    
+    SECTION("Reset re-scatters the pool and clears progress") {
         manager.spawnCoins(5, 10.0f);
+        manager.checkCollection(threepp::Vector3(0.0f, 0.0f, 0.0f), 50.0f);
+        REQUIRE(manager.getCollectedCount() == 5);
+        
+        auto instances = manager.getInstancedMesh();
         manager.reset();
         
+        REQUIRE(manager.getTotalCount() == 5);
+        REQUIRE(manager.getCollectedCount() == 0);
+        REQUIRE(manager.getInstancedMesh() == instances); // same mesh, nothing rebuilt
+        for (const auto& coin : manager.getCoins()) {
+            REQUIRE_FALSE(coin.isCollected());
+        }
+        // And they can be picked up again
+        REQUIRE(manager.checkCollection(threepp::Vector3(0.0f, 0.0f, 0.0f), 50.0f));
+    }
+    
+    SECTION("Clear drops the pool") {
+        manager.spawnCoins(5, 10.0f);
+        manager.clear();
+        
+        REQUIRE(manager.getTotalCount() == 0);
+        REQUIRE(manager.getCollectedCount() == 0);
+        REQUIRE(manager.getInstancedMesh() == nullptr);
+
+        // Nothing to re-scatter afterwards
+        manager.reset();
+        REQUIRE(manager.getTotalCount() == 0);
+        REQUIRE(manager.getInstancedMesh() == nullptr);
+    }
+
+    SECTION("Reset before any spawn does nothing") {
+        manager.reset();
         REQUIRE(manager.getTotalCount() == 0);
         REQUIRE(manager.getCollectedCount() == 0);
     }
 }
+
+TEST_CASE("CoinManager reset is deterministic per seed", "[coin]") {
+    threepp::Scene sceneA, sceneB;
+    CoinManager a(sceneA, 1234);
+    CoinManager b(sceneB, 1234);
+    a.spawnCoins(15, 30.0f);
+    b.spawnCoins(15, 30.0f);
+    a.reset();
+    b.reset();
+    
+    for (size_t i = 0; i < a.getCoins().size(); ++i) {
+        REQUIRE(a.getCoins()[i].getPosition().x == b.getCoins()[i].getPosition().x);
+        REQUIRE(a.getCoins()[i].getPosition().z == b.getCoins()[i].getPosition().z);
+    }
+}
+
+TEST_CASE("CoinManager reset doesn't allocate", "[coin]") {
+    threepp::Scene scene;
+    CoinManager manager(scene, 42);
+    manager.spawnCoins(15, 30.0f);
+    manager.checkCollection(threepp::Vector3(0.0f, 0.0f, 0.0f), 3.0f); // warm up
+    manager.reset();
+    
+    AllocationTracker::setEnabled(true);
+    AllocationTracker::Scope allocations;
+    for (int i = 0; i < 1000; ++i) {
+        manager.checkCollection(threepp::Vector3(static_cast<float>(i % 20) - 10.0f, 0.0f, 0.0f), 3.0f);
+        manager.reset();
+    }
+    const auto counted = allocations.counts();
+    AllocationTracker::setEnabled(false);
+    
+    REQUIRE(counted.allocations == 0);
+    REQUIRE(manager.getTotalCount() == 15);
+}
+
+TEST_CASE("CoinManager spatial index matches brute force", "[coin]") {
+    threepp::Scene scene;
+    CoinManager manager(scene);
+    manager.spawnCoins(2000, 80.0f);
+
+    // Sweep a path across the arena and make sure exactly the coins in reach get picked up
+    for (float x = -70.f; x <= 70.f; x += 7.f) {
+        const threepp::Vector3 probe(x, 0.f, x * 0.5f);
+        const float radius = 3.0f;
+
+        std::vector<bool> shouldCollect;
+        for (const auto& coin : manager.getCoins()) {
+            shouldCollect.push_back(!coin.isCollected() && probe.distanceTo(coin.getPosition()) < radius);
+        }
+        const int before = manager.getCollectedCount();
+        manager.checkCollection(probe, radius);
+
+        int expected = 0;
+        const auto& coins = manager.getCoins();
+        for (size_t i = 0; i < coins.size(); ++i) {
+            if (shouldCollect[i]) {
+                expected++;
+                REQUIRE(coins[i].isCollected());
+            }
+        }
+        REQUIRE(manager.getCollectedCount() - before == expected);
+    }
+
+    SECTION("Collected coins are not counted twice") {
+        const int before = manager.getCollectedCount();
+        manager.checkCollection(threepp::Vector3(0.f, 0.f, 0.f), 500.f);
+        const int all = manager.getCollectedCount();
+        REQUIRE(all == manager.getTotalCount());
+        REQUIRE(all >= before);
+        REQUIRE_FALSE(manager.checkCollection(threepp::Vector3(0.f, 0.f, 0.f), 500.f));
+        REQUIRE(manager.getCollectedCount() == all);
+    }
+}
@@ -1,6 +1,8 @@
 #include <catch2/catch_test_macros.hpp>
 #include "CollisionWorld.hpp"
+#include <threepp/math/Vector2.hpp>
 #include <threepp/math/Vector3.hpp>
+#include <vector>
 
 TEST_CASE("CollisionWorld ground check", "[collision]") {
     SECTION("Ground Y position is zero") {
@@ -33,3 +35,79 @@ TEST_CASE("CollisionWorld movement resolution", "[collision]") {
         REQUIRE(z == 5.0f);
     }
 }
+
+TEST_CASE("CollisionWorld collider handles", "[collision]") {
+    CollisionWorld::clear();
+    const std::vector<threepp::Vector2> square{{-1.f, -1.f}, {1.f, -1.f}, {1.f, 1.f}, {-1.f, 1.f}};
+
+    auto a = CollisionWorld::addMeshColliderFromPoints(square);
+    auto b = CollisionWorld::addMeshColliderFromPoints({{4.f, -1.f}, {6.f, -1.f}, {6.f, 1.f}, {4.f, 1.f}});
+    REQUIRE(a != b);
+    REQUIRE(CollisionWorld::getActiveMeshColliderCount() == 2);
+
+    SECTION("Disabled colliders don't push") {
+        CollisionWorld::setMeshColliderEnabled(a, false);
+        float x = 0.5f, z = 0.f;
+        REQUIRE_FALSE(CollisionWorld::resolveExcavatorMove(x, z, 0.5f));
+        CollisionWorld::setMeshColliderEnabled(a, true);
+        REQUIRE(CollisionWorld::resolveExcavatorMove(x, z, 0.5f));
+    }
+
+    SECTION("Updating a handle only moves that collider") {
+        CollisionWorld::updateMeshCollider(a, {{-11.f, -1.f}, {-9.f, -1.f}, {-9.f, 1.f}, {-11.f, 1.f}});
+        float x = 0.f, z = 0.f;
+        REQUIRE_FALSE(CollisionWorld::resolveExcavatorMove(x, z, 0.5f));
+        x = 5.f;
+        REQUIRE(CollisionWorld::resolveExcavatorMove(x, z, 0.5f));
+    }
+
+    SECTION("Removed slots are reused") {
+        CollisionWorld::removeMeshCollider(a);
+        REQUIRE(CollisionWorld::getActiveMeshColliderCount() == 1);
+        REQUIRE(CollisionWorld::addMeshColliderFromPoints(square) == a);
+        REQUIRE(CollisionWorld::getActiveMeshColliderCount() == 2);
+    }
+
+    SECTION("Degenerate points still get a handle") {
+        auto c = CollisionWorld::addMeshColliderFromPoints({});
+        REQUIRE(c != CollisionWorld::InvalidCollider);
+        REQUIRE(CollisionWorld::getActiveMeshColliderCount() == 2);
+        CollisionWorld::updateMeshCollider(c, square);
+        REQUIRE(CollisionWorld::getActiveMeshColliderCount() == 3);
+    }
+
+    CollisionWorld::clear();
+}
+
+TEST_CASE("CollisionWorld template colliders", "[collision]") {
+    CollisionWorld::clear();
+    // Long along X at yaw 0; points in any order, footprintHull sorts out the winding
+    const auto hull = CollisionWorld::footprintHull({{1.f, 0.25f}, {-1.f, -0.25f}, {-1.f, 0.25f}, {0.f, 0.f}, {1.f, -0.25f}});
+    REQUIRE(hull.size() == 4);
+
+    SECTION("Instances are rotated, scaled and moved") {
+        // A quarter turn makes it long along Z
+        CollisionWorld::addMeshColliderFromTemplate(hull, 5.f, 5.f, 1.5707963f, 1.f);
+        REQUIRE(CollisionWorld::getActiveMeshColliderCount() == 1);
+        float x = 5.f, z = 6.5f;
+        REQUIRE(CollisionWorld::resolveExcavatorMove(x, z, 0.8f));
+        x = 6.5f; z = 5.f;
+        REQUIRE_FALSE(CollisionWorld::resolveExcavatorMove(x, z, 0.8f));
+
+        // Twice the size reaches twice as far
+        CollisionWorld::clear();
+        CollisionWorld::addMeshColliderFromTemplate(hull, 0.f, 0.f, 0.f, 2.f);
+        x = 2.5f; z = 0.f;
+        REQUIRE(CollisionWorld::resolveExcavatorMove(x, z, 0.8f));
+        x = 0.f; z = 1.5f;
+        REQUIRE_FALSE(CollisionWorld::resolveExcavatorMove(x, z, 0.8f));
+    }
+
+    SECTION("Degenerate templates don't collide") {
+        REQUIRE(CollisionWorld::footprintHull({{0.f, 0.f}, {1.f, 1.f}}).empty());
+        CollisionWorld::addMeshColliderFromTemplate({}, 0.f, 0.f, 0.f, 1.f);
+        REQUIRE(CollisionWorld::getActiveMeshColliderCount() == 0);
+    }
+
+    CollisionWorld::clear();
+}
@@ -0,0 +1,134 @@
+#include <catch2/catch_test_macros.hpp>
+#include "DebugDraw.hpp"
+#include "CollisionWorld.hpp"
+#include "AllocationTracker.hpp"
+#include "FrameArena.hpp"
+#include <threepp/scenes/Scene.hpp>
+#include <threepp/objects/Group.hpp>
+#include <threepp/objects/Mesh.hpp>
+#include <threepp/geometries/BoxGeometry.hpp>
+#include <threepp/materials/MeshBasicMaterial.hpp>
+
+using namespace threepp;
+
+namespace {
+    std::vector<Vector2> square(float cx, float cz, float half) {
+        return {{cx - half, cz - half}, {cx + half, cz - half}, {cx + half, cz + half}, {cx - half, cz + half}};
+    }
+}
+
+TEST_CASE("DebugDraw: two line objects for any number of lines", "[debugdraw]") {
+    Scene scene;
+    {
+        DebugDraw draw(scene, 16);
+        REQUIRE(scene.children.size() == 2);
+
+        draw.beginFrame();
+        for (int i = 0; i < 100; ++i) draw.line(Vector3(0, 0, 0), Vector3(1, 0, static_cast<float>(i)), Color::green);
+        draw.endFrame();
+        REQUIRE(draw.dynamicSegments() == 100);
+        REQUIRE(draw.dynamicCapacity() >= 100); // grew by doubling
+        REQUIRE(scene.children.size() == 2);
+
+        // Refilled every frame, not appended to
+        draw.beginFrame();
+        draw.line(Vector3(0, 0, 0), Vector3(1, 0, 0), Color::green);
+        draw.endFrame();
+        REQUIRE(draw.dynamicSegments() == 1);
+
+        // Only that segment is uploaded, not the buffer's capacity
+        auto* dynamicLines = dynamic_cast<LineSegments*>(scene.children[1]);
+        REQUIRE(dynamicLines);
+        for (const char* name : {"position", "color"}) {
+            const auto& range = dynamicLines->geometry()->getAttribute<float>(name)->updateRange;
+            REQUIRE(range.offset == 0);
+            REQUIRE(range.count == 6);
+        }
+
+        draw.setVisible(false);
+        REQUIRE_FALSE(draw.visible());
+    }
+    REQUIRE(scene.children.empty());
+}
+
+TEST_CASE("DebugDraw: rock hulls upload only when the colliders change", "[debugdraw][collision]") {
+    CollisionWorld::clear();
+    Scene scene;
+    DebugDraw draw(scene, 16);
+
+    const auto a = CollisionWorld::addMeshColliderFromPoints(square(0.f, 0.f, 1.f));
+    CollisionWorld::addMeshColliderFromPoints(square(5.f, 0.f, 1.f));
+
+    auto frame = [&] {
+        draw.beginFrame();
+        CollisionWorld::debugDrawRockHulls(draw);
+        draw.endFrame();
+    };
+
+    frame();
+    REQUIRE(draw.staticUploads() == 1);
+    REQUIRE(draw.staticSegments() == 8);
+    for (int i = 0; i < 10; ++i) frame();
+    REQUIRE(draw.staticUploads() == 1);
+
+    // Disabling a collider moves the revision, its hull drops out
+    const auto revision = CollisionWorld::revision();
+    CollisionWorld::setMeshColliderEnabled(a, false);
+    REQUIRE(CollisionWorld::revision() != revision);
+    frame();
+    REQUIRE(draw.staticUploads() == 2);
+    REQUIRE(draw.staticSegments() == 4);
+
+    // Setting the same state again isn't a change
+    CollisionWorld::setMeshColliderEnabled(a, false);
+    frame();
+    REQUIRE(draw.staticUploads() == 2);
+
+    CollisionWorld::removeMeshCollider(a);
+    CollisionWorld::addMeshColliderFromTemplate(CollisionWorld::footprintHull(square(0.f, 0.f, 1.f)), 9.f, 9.f, 0.5f, 2.f);
+    frame();
+    REQUIRE(draw.staticUploads() == 3);
+    REQUIRE(draw.staticSegments() == 8);
+
+    // After clear() the same revision is drawn again
+    draw.clear();
+    REQUIRE(draw.staticSegments() == 0);
+    frame();
+    REQUIRE(draw.staticUploads() == 4);
+    REQUIRE(draw.staticSegments() == 8);
+    CollisionWorld::clear();
+}
+
+TEST_CASE("DebugDraw: steady debug frames don't allocate", "[debugdraw][alloc]") {
+    CollisionWorld::clear();
+    Scene scene;
+    DebugDraw draw(scene);
+    for (int i = 0; i < 50; ++i) {
+        CollisionWorld::addMeshColliderFromPoints(square(static_cast<float>(i % 10) * 6.f, static_cast<float>(i / 10) * 6.f, 1.f));
+    }
+
+    auto root = Group::create();
+    auto base = Mesh::create(BoxGeometry::create(1.8f, 0.6f, 2.f), MeshBasicMaterial::create());
+    base->position.y = 0.3f;
+    root->add(base);
+
+    auto frame = [&] {
+        draw.beginFrame();
+        CollisionWorld::debugDrawRockHulls(draw);
+        CollisionWorld::debugDrawExcavatorHulls(draw, base.get(), nullptr, nullptr, nullptr, nullptr);
+        draw.endFrame();
+        FrameArena::frame().reset();
+    };
+
+    frame();
+    AllocationTracker::setEnabled(true);
+    AllocationTracker::Scope scope;
+    for (int i = 0; i < 100; ++i) frame();
+    const auto counted = scope.counts();
+    AllocationTracker::setEnabled(false);
+
+    CHECK(counted.allocations == 0);
+    REQUIRE(draw.staticUploads() == 1);
+    REQUIRE(draw.dynamicSegments() >= 3);
+    CollisionWorld::clear();
+}
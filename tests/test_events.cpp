@@ -0,0 +1,128 @@
+#include <catch2/catch_test_macros.hpp>
+#include "SpscQueue.hpp"
+#include "EventStream.hpp"
+#include "CoinManager.hpp"
+#include <threepp/scenes/Scene.hpp>
+#include <set>
+#include <thread>
+
+using namespace threepp;
+
+TEST_CASE("SpscQueue ordering and capacity", "[events]") {
+    SpscQueue<int, 8> queue;
+    int value = 0;
+
+    SECTION("Pops in push order") {
+        for (int i = 0; i < 5; ++i) REQUIRE(queue.tryPush(i));
+        for (int i = 0; i < 5; ++i) {
+            REQUIRE(queue.tryPop(value));
+            REQUIRE(value == i);
+        }
+        REQUIRE_FALSE(queue.tryPop(value));
+    }
+
+    SECTION("Full queue rejects pushes") {
+        for (int i = 0; i < 8; ++i) REQUIRE(queue.tryPush(i));
+        REQUIRE_FALSE(queue.tryPush(99));
+        REQUIRE(queue.sizeApprox() == 8);
+        REQUIRE(queue.tryPop(value));
+        REQUIRE(queue.tryPush(99));
+    }
+
+    SECTION("Wraps around many times") {
+        for (int i = 0; i < 100; ++i) {
+            REQUIRE(queue.tryPush(i));
+            REQUIRE(queue.tryPop(value));
+            REQUIRE(value == i);
+        }
+        REQUIRE(queue.empty());
+    }
+}
+
+TEST_CASE("SpscQueue across threads", "[events]") {
+    SpscQueue<int, 64> queue;
+    constexpr int kCount = 100000;
+
+    std::thread producer([&] {
+        for (int i = 0; i < kCount; ++i) {
+            while (!queue.tryPush(i)) std::this_thread::yield();
+        }
+    });
+
+    int expected = 0;
+    bool inOrder = true;
+    int value = 0;
+    while (expected < kCount) {
+        if (queue.tryPop(value)) {
+            inOrder = inOrder && value == expected;
+            expected++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    REQUIRE(inOrder);
+    REQUIRE(queue.empty());
+}
+
+TEST_CASE("EventStream fan-out", "[events]") {
+    EventStream events;
+    auto& audio = events.subscribe();
+    auto& ui = events.subscribe();
+    REQUIRE(events.getSubscriberCount() == 2);
+
+    events.advanceClock(0.5f);
+    events.publish(GameEventType::Dig, Vector3(1.f, 2.f, 3.f));
+    events.advanceClock(0.25f);
+    events.publish(GameEventType::Dump, Vector3(4.f, 5.f, 6.f));
+
+    SECTION("Every subscriber sees every event with its timestamp") {
+        for (auto* sub : {&audio, &ui}) {
+            GameEvent e;
+            REQUIRE(sub->poll(e));
+            REQUIRE(e.type == GameEventType::Dig);
+            REQUIRE(e.coinId == -1);
+            REQUIRE(e.position.y == 2.f);
+            REQUIRE(e.timestamp == 0.5);
+            REQUIRE(sub->poll(e));
+            REQUIRE(e.type == GameEventType::Dump);
+            REQUIRE(e.timestamp == 0.75);
+            REQUIRE_FALSE(sub->poll(e));
+        }
+    }
+
+    SECTION("A slow consumer only drops its own events") {
+        GameEvent e;
+        while (audio.poll(e)) {}
+        for (int i = 0; i < Settings::EventQueueCapacity; ++i) {
+            events.publish(GameEventType::Dig, Vector3());
+            while (audio.poll(e)) {}
+        }
+        REQUIRE(audio.getDroppedCount() == 0);
+        REQUIRE(ui.getDroppedCount() == 2); // 2 + capacity published, capacity fit
+    }
+}
+
+TEST_CASE("CoinManager publishes collection events", "[events][coin]") {
+    Scene scene;
+    EventStream events;
+    auto& sub = events.subscribe();
+    CoinManager manager(scene, 7);
+    manager.setEventStream(&events);
+    manager.spawnCoins(6, 15.0f);
+
+    manager.checkCollection(Vector3(0.f, 0.f, 0.f), 50.f);
+
+    std::set<int> ids;
+    GameEvent e;
+    while (sub.poll(e)) {
+        REQUIRE(e.type == GameEventType::CoinCollected);
+        const auto& coin = manager.getCoins()[e.coinId];
+        REQUIRE(coin.isCollected());
+        REQUIRE(e.position.x == coin.getPosition().x);
+        ids.insert(e.coinId);
+    }
+    REQUIRE(ids.size() == 6); // one event per coin, even though it was one call
+    REQUIRE(manager.getCollectedCount() == 6);
+}
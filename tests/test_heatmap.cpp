@@ -0,0 +1,174 @@
+#include <catch2/catch_test_macros.hpp>
+#include "TrafficHeatmap.hpp"
+#include "TrackMarkManager.hpp"
+#include "Settings.hpp"
+#include <threepp/scenes/Scene.hpp>
+#include <threepp/math/Vector3.hpp>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+using namespace threepp;
+
+TEST_CASE("TrafficHeatmap accumulation", "[heatmap]") {
+    // 20m x 20m, 1m cells
+    TrafficHeatmap heatmap(10.f, 20);
+    auto& writer = heatmap.createWriter();
+
+    SECTION("Records land in the cell under the position") {
+        writer.record(Vector3(0.5f, 0.f, 0.5f));
+        writer.record(Vector3(0.7f, 3.f, 0.2f)); // height doesn't matter
+        writer.record(Vector3(-4.5f, 0.f, 6.5f));
+
+        REQUIRE(heatmap.countAt(0.5f, 0.5f) == 2);
+        REQUIRE(heatmap.countAt(-4.2f, 6.9f) == 1);
+        REQUIRE(heatmap.countAt(5.f, 5.f) == 0);
+        REQUIRE(heatmap.totalSamples() == 3);
+    }
+
+    SECTION("Positions off the map are ignored") {
+        writer.record(Vector3(50.f, 0.f, 0.f));
+        writer.record(Vector3(0.f, 0.f, -10.5f));
+        REQUIRE(heatmap.totalSamples() == 0);
+    }
+
+    SECTION("Clear zeroes every writer") {
+        auto& other = heatmap.createWriter();
+        writer.record(Vector3(1.f, 0.f, 1.f));
+        other.record(Vector3(1.f, 0.f, 1.f));
+        heatmap.clear();
+        REQUIRE(heatmap.totalSamples() == 0);
+    }
+}
+
+TEST_CASE("TrafficHeatmap concurrent writers", "[heatmap]") {
+    TrafficHeatmap heatmap(10.f, 20);
+    constexpr int kWriters = 4;
+    constexpr int kSamples = 10000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kWriters; ++t) {
+        auto& writer = heatmap.createWriter();
+        threads.emplace_back([&writer, t] {
+            // Each "excavator" drives its own lane plus the shared center cell
+            for (int i = 0; i < kSamples; ++i) {
+                writer.record(Vector3(-8.5f + t * 2.f, 0.f, (i % 20) - 9.5f));
+                writer.record(Vector3(0.5f, 0.f, 0.5f));
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    REQUIRE(heatmap.getWriterCount() == kWriters);
+    REQUIRE(heatmap.totalSamples() == static_cast<uint64_t>(kWriters) * kSamples * 2);
+    REQUIRE(heatmap.countAt(0.5f, 0.5f) == static_cast<uint64_t>(kWriters) * kSamples);
+    REQUIRE(heatmap.countAt(-8.5f, 0.5f) == kSamples / 20);
+}
+
+TEST_CASE("TrafficHeatmap export", "[heatmap]") {
+    TrafficHeatmap heatmap(2.f, 4);
+    auto& writer = heatmap.createWriter();
+    writer.record(Vector3(-1.5f, 0.f, 1.5f)); // first cell (row 0 is +Z)
+    writer.record(Vector3(-1.5f, 0.f, 1.5f));
+    writer.record(Vector3(1.5f, 0.f, -1.5f)); // last cell
+
+    const auto dir = std::filesystem::temp_directory_path();
+
+    SECTION("CSV has a header and one row per cell") {
+        const auto path = dir / "blocks_heatmap_test.csv";
+        REQUIRE(heatmap.exportCsv(path));
+
+        std::ifstream in(path);
+        std::string line;
+        std::getline(in, line);
+        REQUIRE(line == "x,z,count");
+        std::getline(in, line);
+        REQUIRE(line == "-1.5,1.5,2");
+
+        int rows = 1;
+        std::string last = line;
+        while (std::getline(in, line)) {
+            rows++;
+            last = line;
+        }
+        REQUIRE(rows == 16);
+        REQUIRE(last == "1.5,-1.5,1");
+        std::filesystem::remove(path);
+    }
+
+    SECTION("Binary round trips") {
+        const auto path = dir / "blocks_heatmap_test.bin";
+        REQUIRE(heatmap.exportBinary(path));
+
+        std::ifstream in(path, std::ios::binary);
+        char magic[4];
+        uint32_t version = 0;
+        int32_t resolution = 0;
+        float halfExtent = 0.f;
+        in.read(magic, 4);
+        in.read(reinterpret_cast<char*>(&version), sizeof(version));
+        in.read(reinterpret_cast<char*>(&resolution), sizeof(resolution));
+        in.read(reinterpret_cast<char*>(&halfExtent), sizeof(halfExtent));
+        std::vector<uint64_t> counts(static_cast<size_t>(resolution) * resolution);
+        in.read(reinterpret_cast<char*>(counts.data()), static_cast<std::streamsize>(counts.size() * sizeof(uint64_t)));
+        REQUIRE(in);
+
+        REQUIRE(std::memcmp(magic, "HEAT", 4) == 0);
+        REQUIRE(version == 1);
+        REQUIRE(resolution == 4);
+        REQUIRE(halfExtent == 2.f);
+        REQUIRE(counts == heatmap.merged());
+        std::filesystem::remove(path);
+    }
+}
+
+TEST_CASE("TrackMarkManager feeds the heatmap while moving", "[heatmap][trackmarks]") {
+    Scene scene;
+    TrackMarkManager marks(scene);
+    TrafficHeatmap heatmap(10.f, 20);
+    marks.setHeatmapWriter(&heatmap.createWriter());
+    Settings::distanceAccumulator_ = 0.f;
+    Settings::heatmapSampleDistance_ = 0.25f;
+
+    // 1.1 m driven is four samples
+    marks.update(0.01f, Vector3(0.f, 0.f, 0.f));
+    for (int i = 1; i <= 11; ++i) {
+        marks.update(0.01f, Vector3(-0.1f * i, 0.f, 0.f));
+    }
+    REQUIRE(heatmap.totalSamples() == 4);
+
+    // Standing still doesn't count
+    for (int i = 0; i < 10; ++i) {
+        marks.update(0.01f, Vector3(-1.1f, 0.f, 0.f));
+    }
+    REQUIRE(heatmap.totalSamples() == 4);
+}
+
+TEST_CASE("TrackMarkManager heatmap doesn't depend on frame rate", "[heatmap][trackmarks]") {
+    Scene scene;
+    TrafficHeatmap heatmap(20.f, 40);
+    Settings::heatmapSampleDistance_ = 0.25f;
+
+    // The same 10 m drive at 2 m/s, sampled at a given frame rate
+    auto driveAt = [&](float fps) {
+        TrackMarkManager marks(scene);
+        marks.setHeatmapWriter(&heatmap.createWriter());
+        const int frames = static_cast<int>(std::lround(5.f * fps));
+        for (int i = 0; i <= frames; ++i) {
+            marks.update(1.f / fps, Vector3(-10.f * i / frames, 0.f, 0.f));
+        }
+        const uint64_t total = heatmap.totalSamples();
+        heatmap.clear();
+        return total;
+    };
+    const uint64_t slow = driveAt(30.f);
+    const uint64_t fast = driveAt(144.f);
+
+    REQUIRE(slow >= 39);
+    REQUIRE(slow <= 40);
+    REQUIRE(fast >= 39);
+    REQUIRE(fast <= 40);
+}
@@ -0,0 +1,100 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "Heightfield.hpp"
+#include "HeightfieldMesh.hpp"
+#include <threepp/materials/MeshBasicMaterial.hpp>
+#include <threepp/math/Vector3.hpp>
+
+using namespace threepp;
+using Catch::Matchers::WithinAbs;
+using Catch::Matchers::WithinRel;
+
+namespace {
+    // 2m high disc of soil with radius 2 on a 10m patch
+    void fillDisc(Heightfield& field) {
+        field.fill([](float x, float z) { return (x * x + z * z < 4.f) ? 2.f : 0.f; });
+        field.clearDirty();
+    }
+}
+
+TEST_CASE("Heightfield sampling", "[heightfield]") {
+    Heightfield field(Vector3(0.f, 0.f, 0.f), 10.f, 101, 32);
+    fillDisc(field);
+
+    REQUIRE(field.getSpacing() == 0.1f);
+    REQUIRE(field.getTilesPerSide() == 4);
+    REQUIRE_THAT(field.heightAt(0.f, 0.f), WithinAbs(2.f, 1e-5));
+    REQUIRE_THAT(field.heightAt(4.f, 4.f), WithinAbs(0.f, 1e-5));
+    REQUIRE(field.heightAt(50.f, 0.f) == 0.f); // outside is floor
+    REQUIRE_THAT(field.volume(), WithinRel(3.14159f * 4.f * 2.f, 0.02f));
+}
+
+TEST_CASE("Heightfield excavation conserves volume", "[heightfield]") {
+    Heightfield field(Vector3(0.f, 0.f, 0.f), 10.f, 101, 32);
+    fillDisc(field);
+    const float before = field.volume();
+
+    SECTION("Removed volume is exactly what the field lost") {
+        const float removed = field.excavate(Vector3(-1.f, 1.5f, 0.f), Vector3(1.f, 1.5f, 0.f), 0.5f, 100.f);
+        REQUIRE(removed > 0.f);
+        REQUIRE_THAT(before - field.volume(), WithinAbs(removed, 1e-3));
+        // Carved down to the bottom of the sphere along the stroke
+        REQUIRE_THAT(field.heightAt(0.f, 0.f), WithinAbs(1.0f, 0.02f));
+    }
+
+    SECTION("Bucket capacity limits what comes off") {
+        const float removed = field.excavate(Vector3(-1.f, 1.5f, 0.f), Vector3(1.f, 1.5f, 0.f), 0.5f, 0.25f);
+        REQUIRE_THAT(removed, WithinAbs(0.25f, 1e-4));
+        REQUIRE_THAT(before - field.volume(), WithinAbs(0.25f, 1e-3));
+    }
+
+    SECTION("Never digs below the floor") {
+        const float removed = field.excavate(Vector3(0.f, -5.f, 0.f), Vector3(0.f, -5.f, 0.f), 8.f, 1e9f);
+        REQUIRE_THAT(removed, WithinAbs(before, 1e-2));
+        REQUIRE_THAT(field.volume(), WithinAbs(0.f, 1e-4));
+        REQUIRE(field.heightAt(0.f, 0.f) == 0.f);
+    }
+
+    SECTION("Sweeping above the soil removes nothing") {
+        REQUIRE(field.excavate(Vector3(-1.f, 3.f, 0.f), Vector3(1.f, 3.f, 0.f), 0.5f, 100.f) == 0.f);
+        REQUIRE(field.getDirtyTiles().empty());
+    }
+}
+
+TEST_CASE("Heightfield dirty tiles stay local", "[heightfield]") {
+    Heightfield field(Vector3(0.f, 0.f, 0.f), 10.f, 101, 10); // 10x10 tiles
+    fillDisc(field);
+
+    field.excavate(Vector3(0.5f, 1.5f, 0.5f), Vector3(0.5f, 1.5f, 0.5f), 0.2f, 100.f);
+    REQUIRE_FALSE(field.getDirtyTiles().empty());
+    REQUIRE(field.getDirtyTiles().size() <= 4);
+
+    field.clearDirty();
+    REQUIRE(field.getDirtyTiles().empty());
+}
+
+TEST_CASE("Heightfield footprint outlines the soil", "[heightfield]") {
+    Heightfield field(Vector3(0.f, 0.f, 0.f), 10.f, 101, 32);
+    fillDisc(field);
+
+    std::vector<Vector2> outline;
+    field.footprint(outline);
+    REQUIRE(outline.size() > 10);
+    for (const auto& p : outline) {
+        REQUIRE(p.x * p.x + p.y * p.y < 4.1f);
+    }
+}
+
+TEST_CASE("HeightfieldMesh uploads only dirty tiles", "[heightfield]") {
+    Heightfield field(Vector3(0.f, 0.f, 0.f), 10.f, 101, 10);
+    fillDisc(field);
+    HeightfieldMesh mesh(field, MeshBasicMaterial::create());
+
+    REQUIRE(mesh.getTileCount() == 100);
+    REQUIRE(mesh.sync() == 0);
+
+    field.excavate(Vector3(0.5f, 1.5f, 0.5f), Vector3(0.5f, 1.5f, 0.5f), 0.2f, 100.f);
+    const size_t dirty = field.getDirtyTiles().size();
+    REQUIRE(mesh.sync() == dirty);
+    REQUIRE(field.getDirtyTiles().empty());
+}
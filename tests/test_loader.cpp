@@ -0,0 +1,113 @@
+#include <catch2/catch_test_macros.hpp>
+#include "AsyncLoader.hpp"
+#include "AssetRegistry.hpp"
+#include "Settings.hpp"
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+    fs::path testDir() {
+        auto dir = fs::temp_directory_path() / "excavator_loader_test";
+        fs::create_directories(dir);
+        return dir;
+    }
+}
+
+TEST_CASE("AsyncLoader: work on workers, finish on the polling thread", "[loader]") {
+    AsyncLoader loader(std::chrono::steady_clock::now(), 3);
+    const auto mainThread = std::this_thread::get_id();
+    std::atomic<int> workedOffMain{0};
+    int finished = 0; // only touched by finish steps, so no atomic needed
+
+    for (int i = 0; i < 8; ++i) {
+        loader.request([&]() -> AsyncLoader::Finish {
+            if (std::this_thread::get_id() != mainThread) ++workedOffMain;
+            return [&] {
+                REQUIRE(std::this_thread::get_id() == mainThread);
+                ++finished;
+            };
+        });
+    }
+    REQUIRE(loader.getStats().requested == 8);
+
+    loader.finishAll();
+    REQUIRE(loader.done());
+    REQUIRE(loader.progress() == 1.f);
+    REQUIRE(workedOffMain == 8);
+    REQUIRE(finished == 8);
+
+    const auto stats = loader.getStats();
+    REQUIRE(stats.finished == 8);
+    REQUIRE(stats.fullyLoadedMs >= 0.0);
+    REQUIRE(stats.firstFrameMs < 0.0); // no frame drawn yet
+    loader.markFrame();
+    REQUIRE(loader.getStats().firstFrameMs >= 0.0);
+}
+
+TEST_CASE("AsyncLoader: poll runs a bounded number of finish steps", "[loader]") {
+    AsyncLoader loader(std::chrono::steady_clock::now(), 1);
+    REQUIRE(loader.done()); // nothing asked for
+    REQUIRE(loader.progress() == 1.f);
+
+    int finished = 0;
+    for (int i = 0; i < 4; ++i) loader.request([&] { return AsyncLoader::Finish([&] { ++finished; }); });
+
+    loader.poll(0);
+    REQUIRE(finished == 0);
+    while (finished == 0) loader.poll(1); // spins until the worker has one ready
+    REQUIRE(finished == 1);
+    REQUIRE(loader.progress() < 1.f);
+    loader.finishAll();
+    REQUIRE(finished == 4);
+}
+
+TEST_CASE("AsyncLoader: a failed job still counts as finished", "[loader]") {
+    AsyncLoader loader(std::chrono::steady_clock::now(), 2);
+    loader.request([]() -> AsyncLoader::Finish { throw std::runtime_error("bad asset"); });
+    loader.request([] { return AsyncLoader::Finish(); }); // nothing to do on the main thread
+    loader.finishAll();
+    REQUIRE(loader.done());
+    REQUIRE(loader.getStats().finished == 2);
+}
+
+TEST_CASE("AsyncLoader: models end up in the AssetRegistry", "[loader]") {
+    AssetRegistry::clear();
+    const auto dir = testDir();
+    const auto* cacheDir = Settings::meshCacheDir_;
+    const auto cacheDirString = (dir / "cache").string();
+    Settings::meshCacheDir_ = cacheDirString.c_str();
+
+    const auto obj = dir / "plate.obj";
+    {
+        std::ofstream out(obj, std::ios::trunc);
+        out << "v 0 0 0\nv 2 0 0\nv 2 0 2\nv 0 0 2\nf 1 2 3 4\n";
+    }
+
+    AsyncLoader loader(std::chrono::steady_clock::now(), 2);
+    loader.requestModel(obj.string());
+    loader.requestModel(obj.string()); // same model, one job
+    loader.requestModel((dir / "missing.obj").string());
+    REQUIRE(loader.getStats().requested == 2);
+    loader.finishAll();
+
+    REQUIRE(AssetRegistry::has(obj.string()));
+    REQUIRE_FALSE(AssetRegistry::has(obj.string(), true)); // loaded without materials only
+    REQUIRE_FALSE(AssetRegistry::has((dir / "missing.obj").string()));
+
+    // Building the scene afterwards is a registry hit, with the cached bounds and hull
+    const auto model = AssetRegistry::load(obj.string());
+    REQUIRE(model.group);
+    REQUIRE(model.boundsMax.x == 2.f);
+    REQUIRE(model.hull.size() == 4);
+    REQUIRE(AssetRegistry::report().models == 1);
+
+    AssetRegistry::clear();
+    Settings::meshCacheDir_ = cacheDir;
+    fs::remove_all(dir / "cache");
+    fs::remove(obj);
+}
@@ -0,0 +1,94 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "MaterialLedger.hpp"
+#include "DigZone.hpp"
+#include "DumpZone.hpp"
+#include "Excavator.hpp"
+#include "Settings.hpp"
+#include <threepp/math/Vector3.hpp>
+
+using namespace threepp;
+using Catch::Matchers::WithinAbs;
+using Catch::Matchers::WithinRel;
+
+TEST_CASE("MaterialLedger books dug and dumped soil", "[material]") {
+    MaterialLedger ledger;
+    ledger.recordDug(1.2f);
+    ledger.recordDug(0.3f);
+    REQUIRE_THAT(ledger.getInBucket(), WithinAbs(1.5f, 1e-6));
+
+    SECTION("Dumping moves bucket soil to dumped") {
+        REQUIRE_THAT(ledger.recordDumped(1.5f), WithinAbs(1.5f, 1e-6));
+        REQUIRE_THAT(ledger.getDumped(), WithinAbs(1.5f, 1e-6));
+        REQUIRE_THAT(ledger.getInBucket(), WithinAbs(0.0f, 1e-6));
+    }
+
+    SECTION("Can't dump more than the bucket holds") {
+        REQUIRE_THAT(ledger.recordDumped(5.0f), WithinAbs(1.5f, 1e-6));
+        REQUIRE(ledger.getDug() == ledger.getDumped());
+    }
+
+    SECTION("Reset zeroes everything") {
+        ledger.advance(10.0f);
+        ledger.reset();
+        REQUIRE(ledger.getDug() == 0.0f);
+        REQUIRE(ledger.getElapsed() == 0.0f);
+        REQUIRE(ledger.getProductivity() == 0.0f);
+    }
+}
+
+TEST_CASE("MaterialLedger productivity", "[material]") {
+    MaterialLedger ledger;
+    REQUIRE(ledger.getProductivity() == 0.0f);
+
+    // 1/6 m^3 every 10 s for half an hour = 60 m^3/h
+    for (int i = 0; i < 180; ++i) {
+        ledger.recordDug(1.0f / 6.0f);
+        for (int f = 0; f < 10 * 60; ++f) ledger.advance(1.0f / 60.0f);
+        ledger.recordDumped(1.0f / 6.0f);
+    }
+    REQUIRE_THAT(ledger.getProductivity(), WithinRel(60.0f, 1e-2f));
+    // The recent figure wobbles around the same rate (it peaks right after a dump)
+    REQUIRE_THAT(ledger.getRecentProductivity(), WithinRel(60.0f, 0.15f));
+
+    // Idle for a long while: recent output drops off, the session average only slowly
+    for (int f = 0; f < 600; ++f) ledger.advance(1.0f);
+    REQUIRE(ledger.getRecentProductivity() < 0.1f);
+    REQUIRE(ledger.getProductivity() > 20.0f);
+}
+
+TEST_CASE("Bucket fill factor follows the curl", "[material]") {
+    REQUIRE_THAT(Excavator::bucketFillFactor(Settings::bucketMin_), WithinAbs(Settings::bucketMinFill_, 1e-6));
+    REQUIRE_THAT(Excavator::bucketFillFactor(Settings::bucketMax_), WithinAbs(1.0f, 1e-6));
+    const float half = Excavator::bucketFillFactor(0.5f * (Settings::bucketMin_ + Settings::bucketMax_));
+    REQUIRE(half > Settings::bucketMinFill_);
+    REQUIRE(half < 1.0f);
+    // Out of range angles clamp
+    REQUIRE(Excavator::bucketFillFactor(Settings::bucketMax_ + 1.0f) == 1.0f);
+}
+
+TEST_CASE("Soil is conserved from dig zone to dump zone", "[material]") {
+    DigZone dig(Vector3(0.0f, 0.0f, 0.0f), 2.0f, 96);
+    DumpZone dump(Vector3(10.0f, 0.0f, 0.0f), 3.0f);
+    MaterialLedger ledger;
+    const float pile = dig.getVolume();
+
+    // A few shallow scoops then a dump, like main does (capacity at half curl)
+    const float capacity = Settings::bucketCapacity_ * Excavator::bucketFillFactor(0.25f);
+    for (int scoop = 0; scoop < 3; ++scoop) {
+        float inBucket = 0.0f;
+        for (int step = 0; step < 40 && inBucket < capacity * 0.95f; ++step) {
+            const float x = -1.5f + step * 0.075f;
+            const float removed = dig.excavate(Vector3(x, 1.6f - scoop * 0.3f, 0.0f), Vector3(x + 0.075f, 1.6f - scoop * 0.3f, 0.0f),
+                                               0.6f, capacity - inBucket);
+            inBucket += removed;
+            ledger.recordDug(removed);
+        }
+        dump.recordDump(Vector3(10.0f, 2.0f, 0.0f), ledger.recordDumped(inBucket));
+    }
+
+    REQUIRE(ledger.getDug() > 0.0f);
+    REQUIRE_THAT(pile - dig.getVolume(), WithinAbs(ledger.getDug(), 1e-3));
+    REQUIRE_THAT(dump.getVolume(), WithinAbs(ledger.getDumped(), 1e-3));
+    REQUIRE_THAT(ledger.getInBucket(), WithinAbs(0.0f, 1e-5));
+}
@@ -3,6 +3,7 @@
 #include "ParticleSystem.hpp"
 #include <threepp/scenes/Scene.hpp>
 #include <threepp/math/Vector3.hpp>
+#include <threepp/cameras/PerspectiveCamera.hpp>
 
 TEST_CASE("ParticleSystem lifecycle", "[particle]") {
     threepp::Scene scene;
@@ -41,3 +42,74 @@ TEST_CASE("ParticleSystem lifecycle", "[particle]") {
         REQUIRE(ps.getActiveCount() == 0);
     }
 }
+
+TEST_CASE("ParticleSystem reuses dead particles", "[particle]") {
+    threepp::Scene scene;
+    ParticleSystem ps(scene, 3);
+
+    for (int i = 0; i < 5; ++i) ps.spawnParticle({static_cast<float>(i), 0, 0});
+    const size_t sceneSize = scene.children.size();
+    ps.update(5.0f);
+    REQUIRE(ps.getActiveCount() == 0);
+    REQUIRE(ps.getPooledCount() == 5);
+    // Dead meshes stay in the scene, hidden
+    REQUIRE(scene.children.size() == sceneSize);
+    for (const auto& child : scene.children) {
+        if (child->as<threepp::Mesh>()) REQUIRE_FALSE(child->visible);
+    }
+
+    // New spawns take meshes from the pool instead of adding more
+    for (int i = 0; i < 3; ++i) ps.spawnParticle({0, 0, 0});
+    REQUIRE(ps.getActiveCount() == 3);
+    REQUIRE(ps.getPooledCount() == 2);
+    REQUIRE(scene.children.size() == sceneSize);
+    for (const auto& p : ps.getParticles()) {
+        REQUIRE(p.mesh->visible);
+        REQUIRE(p.material->opacity == 0.8f);
+    }
+
+    ps.clearParticles();
+    REQUIRE(ps.getPooledCount() == 5);
+}
+
+TEST_CASE("ParticleSystem camera LOD", "[particle]") {
+    threepp::Scene scene;
+    ParticleSystem ps(scene);
+
+    // Default camera sits at the origin looking down -Z
+    threepp::PerspectiveCamera camera(60, 1, 0.1f, 1000);
+    camera.updateMatrixWorld(true);
+    ps.setCamera(&camera);
+
+    SECTION("Offscreen emitters don't spawn") {
+        ps.spawnParticle({0, 0, 10}); // behind the camera
+        REQUIRE(ps.getActiveCount() == 0);
+
+        ps.update(0.0f);
+        REQUIRE(ps.getStats().culledSpawns == 1);
+    }
+
+    SECTION("Near emitters spawn at full rate") {
+        for (int i = 0; i < 4; ++i) ps.spawnParticle({0, 0, -5});
+        REQUIRE(ps.getActiveCount() == 4);
+    }
+
+    SECTION("Far emitters spawn at a reduced rate") {
+        for (int i = 0; i < 8; ++i) ps.spawnParticle({0, 0, -100});
+        REQUIRE(ps.getActiveCount() == 2); // particleLodMinRate_ = 0.25
+
+        ps.update(0.0f);
+        REQUIRE(ps.getStats().decimatedSpawns == 6);
+    }
+
+    SECTION("Distant particles are drawn as sprites") {
+        ps.spawnParticle({0, 0, -5});
+        ps.spawnParticle({0, 0, -30});
+        ps.update(0.0f);
+
+        const auto& stats = ps.getStats();
+        REQUIRE(stats.simulated == 2);
+        REQUIRE(stats.rendered == 2);
+        REQUIRE(stats.sprites == 1);
+    }
+}
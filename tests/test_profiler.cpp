@@ -0,0 +1,192 @@
+#include <catch2/catch_test_macros.hpp>
+#include "StartupProfiler.hpp"
+#include "FrameProfiler.hpp"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+    // Burn some CPU so the phase has measurable CPU time, not just wall time
+    double spin(int iterations) {
+        volatile double x = 0.0;
+        for (int i = 0; i < iterations; ++i) x = x + 1e-9 * i;
+        return x;
+    }
+
+    size_t countLines(const std::string& text) {
+        size_t n = 0;
+        for (char c : text) n += c == '\n';
+        return n;
+    }
+}
+
+TEST_CASE("StartupProfiler: phases, nesting and totals", "[profiler]") {
+    StartupProfiler::Scope ignored("not running"); // nothing recorded before begin()
+    REQUIRE_FALSE(StartupProfiler::running());
+
+    StartupProfiler::begin(std::chrono::steady_clock::now());
+    StartupProfiler::phase("first");
+    spin(200000);
+    StartupProfiler::phase("second");
+    {
+        StartupProfiler::Scope inner("inner");
+        std::this_thread::sleep_for(std::chrono::milliseconds(20)); // waiting costs wall time, not CPU
+    }
+    StartupProfiler::phase("third");
+    StartupProfiler::Scope leftOpen("open"); // closed by finish()
+    StartupProfiler::finish();
+    REQUIRE_FALSE(StartupProfiler::running());
+
+    const auto phases = StartupProfiler::phases();
+    REQUIRE(phases.size() == 5);
+    REQUIRE(phases[0].name == "first");
+    REQUIRE(phases[2].name == "second/inner");
+    REQUIRE(phases[2].depth == 1);
+    REQUIRE(phases[4].name == "third/open");
+
+    REQUIRE(phases[0].cpuMs > 0.0);
+    REQUIRE(phases[1].startMs >= phases[0].startMs + phases[0].wallMs);
+    REQUIRE(phases[1].wallMs >= phases[2].wallMs); // the parent covers its child
+    REQUIRE(phases[2].wallMs >= 19.0);
+    REQUIRE(phases[2].cpuMs < phases[2].wallMs);
+    REQUIRE(StartupProfiler::totalWallMs() >= phases[1].startMs + phases[1].wallMs);
+}
+
+TEST_CASE("StartupProfiler: JSON and CSV reports", "[profiler]") {
+    StartupProfiler::begin(std::chrono::steady_clock::now());
+    StartupProfiler::phase("canvas");
+    StartupProfiler::phase("excavator");
+    {
+        StartupProfiler::Scope load("load");
+    }
+    StartupProfiler::finish();
+
+    const auto json = StartupProfiler::toJson("abc123");
+    REQUIRE(json.find("\"build\": \"abc123\"") != std::string::npos);
+    REQUIRE(json.find("\"name\": \"excavator/load\", \"depth\": 1") != std::string::npos);
+    REQUIRE(json.find("\"total_wall_ms\": ") != std::string::npos);
+    REQUIRE(json.front() == '{');
+    REQUIRE(json.substr(json.size() - 2) == "}\n");
+
+    // Header + 3 phases + total
+    const auto csv = StartupProfiler::toCsvRows("abc123", true);
+    REQUIRE(countLines(csv) == 5);
+    REQUIRE(csv.rfind("build,timestamp,phase,depth,wall_ms,cpu_ms\n", 0) == 0);
+    REQUIRE(csv.find(",excavator/load,1,") != std::string::npos);
+    REQUIRE(csv.find(",total,-1,") != std::string::npos);
+
+    // The history file gets its header once, then rows per run
+    const auto path = fs::temp_directory_path() / "excavator_startup_history.csv";
+    fs::remove(path);
+    REQUIRE(StartupProfiler::appendCsv(path, "abc123"));
+    REQUIRE(StartupProfiler::appendCsv(path, "def456"));
+    std::ifstream in(path);
+    std::stringstream text;
+    text << in.rdbuf();
+    REQUIRE(countLines(text.str()) == 1 + 2 * 4);
+    REQUIRE(text.str().find("def456,") != std::string::npos);
+    in.close();
+    fs::remove(path);
+}
+
+TEST_CASE("FrameProfiler: zones per frame, nesting and the ring", "[profiler]") {
+    FrameProfiler::reset();
+    const auto outer = FrameProfiler::registerZone("test outer");
+    const auto inner = FrameProfiler::registerZone("test inner");
+    REQUIRE(FrameProfiler::registerZone("test outer") == outer);
+    REQUIRE(std::string(FrameProfiler::zoneName(inner)) == "test inner");
+
+    FrameProfiler::beginFrame();
+    {
+        FrameProfiler::Zone a(outer);
+        spin(100000);
+        for (int i = 0; i < 3; ++i) {
+            FrameProfiler::Zone b(inner);
+            spin(10000);
+        }
+    }
+    // Off the frame thread nothing is recorded
+    std::thread([&] { FrameProfiler::Zone c(outer); }).join();
+    FrameProfiler::endFrame();
+
+    REQUIRE(FrameProfiler::frameCount() == 1);
+    const auto& f = FrameProfiler::frame(0);
+    REQUIRE(f.zoneCalls[outer] == 1);
+    REQUIRE(f.zoneCalls[inner] == 3);
+    REQUIRE(f.zoneMs[outer] >= f.zoneMs[inner]);
+    REQUIRE(f.frameMs >= f.zoneMs[outer]);
+    REQUIRE(f.eventCount == 4);
+    // Inner zones close first and sit one level down, inside the outer one
+    REQUIRE(f.events[0].zone == inner);
+    REQUIRE(f.events[0].depth == 1);
+    REQUIRE(f.events[3].zone == outer);
+    REQUIRE(f.events[3].depth == 0);
+    REQUIRE(f.events[0].startMs >= f.events[3].startMs);
+
+    // The history keeps the last HistoryFrames frames
+    for (size_t i = 0; i < FrameProfiler::HistoryFrames + 10; ++i) {
+        FrameProfiler::beginFrame();
+        {
+            FrameProfiler::Zone z(inner);
+        }
+        FrameProfiler::endFrame();
+    }
+    REQUIRE(FrameProfiler::frameCount() == FrameProfiler::HistoryFrames);
+    REQUIRE(FrameProfiler::stats(outer).frames == 0); // rolled out of the history
+    REQUIRE(FrameProfiler::stats(inner).frames == FrameProfiler::HistoryFrames);
+
+    // Paused: zones are skipped and the history holds still
+    FrameProfiler::setEnabled(false);
+    FrameProfiler::beginFrame();
+    {
+        FrameProfiler::Zone z(outer);
+    }
+    FrameProfiler::endFrame();
+    FrameProfiler::setEnabled(true);
+    REQUIRE(FrameProfiler::stats(outer).frames == 0);
+    FrameProfiler::reset();
+}
+
+TEST_CASE("FrameProfiler: rolling min/avg/p99", "[profiler]") {
+    FrameProfiler::reset();
+    const auto zone = FrameProfiler::registerZone("test stats");
+    const auto other = FrameProfiler::registerZone("test other");
+    // 100 frames: the zone runs in every other one, one of them much slower
+    for (int i = 0; i < 100; ++i) {
+        FrameProfiler::beginFrame();
+        if (i % 2 == 0) {
+            FrameProfiler::Zone z(zone);
+            if (i == 50) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        {
+            FrameProfiler::Zone o(other);
+        }
+        FrameProfiler::endFrame();
+    }
+    const auto st = FrameProfiler::stats(zone);
+    REQUIRE(st.frames == 50); // frames it didn't run in don't count
+    REQUIRE(st.minMs <= st.avgMs);
+    REQUIRE(st.p99Ms >= 5.f); // with 50 samples p99 is the worst one
+    REQUIRE(st.avgMs < st.p99Ms);
+    REQUIRE(st.lastMs < 5.f);
+    REQUIRE(FrameProfiler::stats(other).frames == 100);
+    REQUIRE(FrameProfiler::zoneCostNs() > 0.0);
+    FrameProfiler::reset();
+}
+
+#if BLOCKS_PROFILING
+TEST_CASE("FrameProfiler: PROFILE_ZONE registers once per call site", "[profiler]") {
+    FrameProfiler::reset();
+    FrameProfiler::beginFrame();
+    for (int i = 0; i < 5; ++i) {
+        PROFILE_ZONE("test macro");
+    }
+    FrameProfiler::endFrame();
+    const auto id = FrameProfiler::registerZone("test macro");
+    REQUIRE(FrameProfiler::frame(0).zoneCalls[id] == 5);
+    FrameProfiler::reset();
+}
+#endif
@@ -0,0 +1,146 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "SoilVolume.hpp"
+#include "Heightfield.hpp"
+#include <threepp/math/Vector3.hpp>
+#include <algorithm>
+
+using namespace threepp;
+using Catch::Matchers::WithinAbs;
+using Catch::Matchers::WithinRel;
+
+namespace {
+    // Steps until nothing moves (or gives up), returns the steps taken
+    int settle(SoilVolume& soil, int maxSteps = 2000) {
+        int steps = 0;
+        while (soil.step() > 0 && steps < maxSteps) steps++;
+        return steps;
+    }
+
+    // Order independent fingerprint of where the soil is
+    double fingerprint(const SoilVolume& soil) {
+        double sum = 0.0;
+        soil.forEachVoxel([&](int x, int y, int z, float fill) { sum += fill * (x * 7 + y * 13 + z * 31); });
+        return sum;
+    }
+
+    void fillMound(SoilVolume& soil) {
+        Heightfield field(Vector3(2.f, 0.f, 2.f), 4.f, 64);
+        field.fill([](float x, float z) { return ((x - 2.f) * (x - 2.f) + (z - 2.f) * (z - 2.f) < 2.f) ? 2.f : 0.f; });
+        soil.fillFromHeightfield(field);
+    }
+}
+
+TEST_CASE("SoilVolume a column collapses into a heap", "[soil]") {
+    SoilVolume soil(Vector3(0.f, 0.f, 0.f), 0.25f, 1);
+    for (int y = 5; y < 25; ++y) soil.setVoxel(3, y, 3, 1.f);
+    const float before = soil.totalSoil();
+
+    REQUIRE(settle(soil) < 2000);
+    REQUIRE_THAT(soil.totalSoil(), WithinAbs(before, 1e-5));
+    REQUIRE(soil.voxel(3, 0, 3) == 1.f);
+    REQUIRE(soil.voxel(3, 20, 3) == 0.f);
+
+    // Spread out at 45 degrees: nothing left much above the floor
+    int top = 0;
+    soil.forEachVoxel([&](int, int y, int, float) { top = std::max(top, y); });
+    REQUIRE(top <= 4);
+}
+
+TEST_CASE("SoilVolume settled soil costs nothing", "[soil]") {
+    SoilVolume soil(Vector3(0.f, 0.f, 0.f), 0.25f, 2);
+    fillMound(soil);
+    settle(soil);
+
+    REQUIRE(soil.getActiveBrickCount() == 0);
+    REQUIRE(soil.step() == 0);
+    const auto revision = soil.getRevision();
+    soil.step();
+    REQUIRE(soil.getRevision() == revision);
+}
+
+TEST_CASE("SoilVolume results don't depend on the thread count", "[soil]") {
+    auto run = [](int threads) {
+        SoilVolume soil(Vector3(0.f, 0.f, 0.f), 0.25f, threads);
+        fillMound(soil);
+        const float before = soil.totalSoil();
+        // Drag the bucket through the side of the mound
+        for (int i = 0; i < 60; ++i) {
+            soil.setBoundary(Vector3(0.5f + i * 0.05f, 0.5f, 2.f), 0.5f);
+            soil.step();
+        }
+        soil.clearBoundary();
+        settle(soil);
+        REQUIRE_THAT(soil.totalSoil(), WithinRel(before, 1e-5f));
+        return fingerprint(soil);
+    };
+
+    const double single = run(1);
+    REQUIRE(run(4) == single);
+}
+
+TEST_CASE("SoilVolume starts its threads on the first step with work", "[soil]") {
+    SoilVolume soil(Vector3(0.f, 0.f, 0.f), 0.25f, 4);
+    REQUIRE(soil.getThreadCount() == 4);
+    REQUIRE(soil.getStartedWorkerCount() == 0);
+
+    REQUIRE(soil.step() == 0); // nothing to do, still no threads
+    REQUIRE(soil.getStartedWorkerCount() == 0);
+
+    fillMound(soil);
+    soil.setBoundary(Vector3(0.5f, 0.5f, 2.f), 0.5f);
+    soil.step();
+    REQUIRE(soil.getStartedWorkerCount() == 3);
+}
+
+TEST_CASE("SoilVolume overhangs crumble from the edges", "[soil]") {
+    SoilVolume soil(Vector3(0.f, 0.f, 0.f), 0.25f, 2);
+    // A 5x5 slab hanging in the air
+    for (int z = 0; z < 5; ++z) {
+        for (int x = 0; x < 5; ++x) soil.setVoxel(x, 10, z, 1.f);
+    }
+
+    soil.step();
+    REQUIRE(soil.voxel(2, 10, 2) == 1.f); // held by its neighbours
+    REQUIRE(soil.voxel(0, 10, 0) == 0.f); // corners only have two, they go first
+
+    settle(soil);
+    float airborne = 0.f;
+    soil.forEachVoxel([&](int, int y, int, float fill) { if (y > 2) airborne += fill; });
+    REQUIRE(airborne == 0.f);
+    REQUIRE_THAT(soil.totalSoil(), WithinAbs(25.f * 0.25f * 0.25f * 0.25f, 1e-5));
+}
+
+TEST_CASE("SoilVolume bucket boundary pushes soil aside", "[soil]") {
+    SoilVolume soil(Vector3(0.f, 0.f, 0.f), 0.25f, 1);
+    for (int z = 0; z < 16; ++z) {
+        for (int x = 0; x < 16; ++x) {
+            for (int y = 0; y < 4; ++y) soil.setVoxel(x, y, z, 1.f);
+        }
+    }
+    settle(soil);
+    const float before = soil.totalSoil();
+
+    // Sphere sunk into the middle of the slab
+    soil.setBoundary(Vector3(2.f, 0.5f, 2.f), 0.4f);
+    REQUIRE(soil.voxel(8, 2, 8) == 0.f);
+    REQUIRE_THAT(soil.totalSoil(), WithinAbs(before, 1e-5));
+
+    // Nothing falls back into it while it's there
+    settle(soil);
+    REQUIRE(soil.voxel(8, 2, 8) == 0.f);
+    REQUIRE_THAT(soil.totalSoil(), WithinAbs(before, 1e-5));
+
+    // Lifted out, the hole caves in
+    soil.clearBoundary();
+    settle(soil);
+    REQUIRE(soil.voxel(8, 0, 8) == 1.f);
+}
+
+TEST_CASE("SoilVolume voxelizes a heightfield pile", "[soil]") {
+    Heightfield field(Vector3(0.f, 0.f, 0.f), 6.f, 96);
+    field.fill([](float x, float z) { return (x * x + z * z < 4.f) ? 1.5f : 0.f; });
+    SoilVolume soil(Vector3(0.f, 0.f, 0.f), 0.25f, 1);
+    soil.fillFromHeightfield(field);
+    REQUIRE_THAT(soil.totalSoil(), WithinRel(field.volume(), 0.05f));
+}
@@ -0,0 +1,102 @@
+#include <catch2/catch_test_macros.hpp>
+#include "ObjectSpawner.hpp"
+#include "CollisionWorld.hpp"
+#include <algorithm>
+#include <cmath>
+#include <threepp/scenes/Scene.hpp>
+
+using namespace threepp;
+
+namespace {
+    ObjectSpawner::SpawnConfig testConfig() {
+        ObjectSpawner::SpawnConfig config;
+        config.smallObjectCount = 2000;
+        config.mediumObjectCount = 20;
+        config.largeObjectCount = 5;
+        config.keepOut = {{0.f, 0.f, 4.f}, {0.f, 18.f, 8.f}};
+        return config;
+    }
+
+    constexpr size_t PerimeterRocks = 20;
+    constexpr float Eps = 1e-4f; // the sampler compares squared distances
+}
+
+TEST_CASE("ObjectSpawner: props are instanced per template", "[spawner]") {
+    Scene scene;
+    const auto config = testConfig();
+    ObjectSpawner spawner(scene, config);
+    spawner.generateEnvironment();
+
+    const auto& stats = spawner.getPropStats();
+    // Rails only show up when their model loads
+    const auto rails = static_cast<size_t>(std::count_if(spawner.getProps().begin(), spawner.getProps().end(),
+        [](const ObjectSpawner::Prop& p) { return p.type == ObjectSpawner::PropClass::Rail; }));
+    REQUIRE((rails == 0 || rails == static_cast<size_t>(config.railCount)));
+    const size_t expected = PerimeterRocks + rails + config.smallObjectCount + config.mediumObjectCount + config.largeObjectCount;
+    REQUIRE(spawner.getProps().size() == expected);
+    REQUIRE(stats.instances == expected);
+
+    // Draw calls follow the templates (rock, crate and rail sub-meshes), not the object count
+    REQUIRE(stats.drawCalls == spawner.getPropMeshes().size());
+    REQUIRE(stats.drawCalls >= 2);
+    REQUIRE(stats.drawCalls <= 6);
+
+    // Debris is walked over, everything else gets a template collider
+    REQUIRE(stats.colliders == PerimeterRocks + rails + config.mediumObjectCount + config.largeObjectCount);
+    REQUIRE(CollisionWorld::getActiveMeshColliderCount() == stats.colliders);
+
+    CollisionWorld::clear();
+}
+
+TEST_CASE("ObjectSpawner: placement keeps spacing, keep-out areas and solid props clear", "[spawner]") {
+    Scene scene;
+    const auto config = testConfig();
+    ObjectSpawner spawner(scene, config);
+    spawner.generateEnvironment();
+
+    const auto& props = spawner.getProps();
+    for (const auto& prop : props) {
+        if (prop.type == ObjectSpawner::PropClass::PerimeterRock) continue;
+        REQUIRE(std::hypot(prop.x, prop.z) <= config.arenaRadius);
+        for (const auto& k : config.keepOut) {
+            REQUIRE(std::hypot(prop.x - k.x, prop.z - k.z) >= k.radius + prop.radius - Eps);
+        }
+    }
+    for (size_t i = 0; i < props.size(); ++i) {
+        // Debris keeps its own spacing from other debris
+        if (props[i].type == ObjectSpawner::PropClass::Debris) {
+            for (size_t j = i + 1; j < props.size(); ++j) {
+                if (props[j].type != ObjectSpawner::PropClass::Debris) continue;
+                REQUIRE(std::hypot(props[i].x - props[j].x, props[i].z - props[j].z) >= config.smallSpacing - Eps);
+            }
+        }
+        if (!props[i].collides) continue;
+        for (size_t j = 0; j < props.size(); ++j) {
+            if (i == j || props[j].type == ObjectSpawner::PropClass::PerimeterRock) continue;
+            REQUIRE(std::hypot(props[i].x - props[j].x, props[i].z - props[j].z) >= props[i].radius + props[j].radius - Eps);
+        }
+    }
+
+    CollisionWorld::clear();
+}
+
+TEST_CASE("ObjectSpawner: regenerating is reproducible and replaces the props", "[spawner]") {
+    Scene scene;
+    ObjectSpawner spawner(scene, testConfig());
+    spawner.generateEnvironment();
+    const auto first = spawner.getProps();
+    const size_t children = scene.children.size();
+
+    spawner.generateEnvironment();
+    const auto& second = spawner.getProps();
+    REQUIRE(second.size() == first.size());
+    for (size_t i = 0; i < first.size(); ++i) {
+        REQUIRE(second[i].x == first[i].x);
+        REQUIRE(second[i].z == first[i].z);
+        REQUIRE(second[i].yaw == first[i].yaw);
+    }
+    REQUIRE(scene.children.size() == children);
+    REQUIRE(CollisionWorld::getActiveMeshColliderCount() == spawner.getPropStats().colliders);
+
+    CollisionWorld::clear();
+}
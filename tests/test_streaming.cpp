@@ -0,0 +1,124 @@
+#include <catch2/catch_test_macros.hpp>
+#include "WorldStreamer.hpp"
+#include "CollisionWorld.hpp"
+#include <algorithm>
+#include <threepp/scenes/Scene.hpp>
+
+using namespace threepp;
+
+namespace {
+    WorldStreamer::Config testConfig() {
+        WorldStreamer::Config config;
+        config.chunkSize = 32.f;
+        config.loadRadius = 2;
+        config.siteRadius = 5000.f;
+        config.debrisPerChunk = 40;
+        return config;
+    }
+}
+
+TEST_CASE("WorldStreamer: chunks follow the focus", "[streaming]") {
+    CollisionWorld::clear();
+    Scene scene;
+    WorldStreamer streamer(scene, testConfig());
+
+    streamer.update(Vector3(0, 0, 0));
+    streamer.finishLoading();
+    REQUIRE(streamer.isResident(0, 0));
+    REQUIRE(streamer.isResident(-2, 0));
+    REQUIRE_FALSE(streamer.isResident(3, 0));
+    REQUIRE(streamer.getStats().pending == 0);
+    REQUIRE(streamer.getStats().instances > 0);
+    REQUIRE(streamer.getStats().colliders == CollisionWorld::getActiveMeshColliderCount());
+
+    streamer.update(Vector3(320, 0, 0));
+    streamer.finishLoading();
+    REQUIRE(streamer.isResident(10, 0));
+    REQUIRE_FALSE(streamer.isResident(0, 0)); // left behind
+    REQUIRE(streamer.getStats().unloaded > 0);
+    REQUIRE(streamer.getStats().colliders == CollisionWorld::getActiveMeshColliderCount());
+}
+
+TEST_CASE("WorldStreamer: memory and colliders stay bounded on a long drive", "[streaming]") {
+    CollisionWorld::clear();
+    Scene scene;
+    WorldStreamer streamer(scene, testConfig());
+    const size_t maxChunks = streamer.getMaxResidentChunks();
+
+    size_t maxColliders = 0;
+    size_t maxChildren = 0;
+    for (float x = 0.f; x <= 1500.f; x += 16.f) {
+        streamer.update(Vector3(x, 0, x * 0.25f));
+        streamer.finishLoading();
+        const auto& stats = streamer.getStats();
+        REQUIRE(stats.resident <= maxChunks);
+        REQUIRE(stats.colliders == CollisionWorld::getActiveMeshColliderCount());
+        maxColliders = std::max(maxColliders, stats.colliders);
+        maxChildren = std::max(maxChildren, scene.children.size());
+    }
+    // Dozens of chunks went by, but only a load radius worth was ever alive
+    REQUIRE(streamer.getStats().loaded > 3 * maxChunks);
+    REQUIRE(maxChildren <= maxChunks * 3); // ground tile + rock + crate meshes per chunk
+    REQUIRE(maxColliders <= maxChunks * static_cast<size_t>(testConfig().bouldersPerChunk + testConfig().cratesPerChunk));
+}
+
+TEST_CASE("WorldStreamer: chunks come back the same", "[streaming]") {
+    CollisionWorld::clear();
+    Scene scene;
+    WorldStreamer streamer(scene, testConfig());
+
+    streamer.update(Vector3(0, 0, 0));
+    streamer.finishLoading();
+    const auto instances = streamer.getStats().instances;
+    const auto colliders = streamer.getStats().colliders;
+
+    streamer.update(Vector3(1000, 0, 0));
+    streamer.finishLoading();
+    streamer.update(Vector3(0, 0, 0));
+    streamer.finishLoading();
+    REQUIRE(streamer.getStats().instances == instances);
+    REQUIRE(streamer.getStats().colliders == colliders);
+}
+
+TEST_CASE("WorldStreamer: dropped requests aren't generated", "[streaming]") {
+    CollisionWorld::clear();
+    Scene scene;
+    WorldStreamer streamer(scene, testConfig());
+
+    // Away and back before the worker can catch up: the first ring is asked for twice, the far one once
+    streamer.update(Vector3(0, 0, 0), 0);
+    streamer.update(Vector3(1000, 0, 0), 0);
+    streamer.update(Vector3(0, 0, 0), 0);
+    streamer.finishLoading();
+
+    const auto& stats = streamer.getStats();
+    REQUIRE(stats.pending == 0);
+    REQUIRE(stats.resident == stats.loaded);
+    REQUIRE(streamer.isResident(0, 0));
+    REQUIRE_FALSE(streamer.isResident(31, 0));
+    // Each chunk made once, plus at most the two the worker was already on when their ring was dropped
+    REQUIRE(stats.generated <= stats.resident + 2);
+    REQUIRE(stats.colliders == CollisionWorld::getActiveMeshColliderCount());
+}
+
+TEST_CASE("WorldStreamer: keep-out areas and the site edge stay empty", "[streaming]") {
+    CollisionWorld::clear();
+    Scene scene;
+    auto config = testConfig();
+    config.siteRadius = 200.f;
+    config.keepOut = {{0.f, 0.f, 150.f}};
+    WorldStreamer streamer(scene, config);
+
+    // Everything loaded around the origin is inside the keep-out
+    streamer.update(Vector3(0, 0, 0));
+    streamer.finishLoading();
+    REQUIRE(streamer.getStats().resident > 0);
+    REQUIRE(streamer.getStats().instances == 0);
+
+    // Past the site there's only bare ground
+    streamer.update(Vector3(1000, 0, 1000));
+    streamer.finishLoading();
+    REQUIRE(streamer.getStats().resident > 0);
+    REQUIRE(streamer.getStats().instances == 0);
+    REQUIRE(CollisionWorld::getActiveMeshColliderCount() == 0);
+}
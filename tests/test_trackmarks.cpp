@@ -0,0 +1,140 @@
+#include <catch2/catch_test_macros.hpp>
+#include "TrackMarkManager.hpp"
+#include "Settings.hpp"
+#include <threepp/scenes/Scene.hpp>
+#include <threepp/math/Vector3.hpp>
+#include <threepp/objects/Group.hpp>
+
+using namespace threepp;
+
+namespace {
+    // Drive from the origin in a straight line along -X in small steps
+    void drive(TrackMarkManager& marks, float distance, float step = 0.1f, float dt = 0.01f) {
+        marks.update(0.f, Vector3(0.f, 0.f, 0.f));
+        float x = 0.f;
+        for (float d = 0.f; d < distance; d += step) {
+            x -= step;
+            marks.update(dt, Vector3(x, 0.f, 0.f));
+        }
+    }
+}
+
+TEST_CASE("TrackMarkManager spawning", "[trackmarks]") {
+    Scene scene;
+    TrackMarkManager marks(scene);
+    marks.setSpawnDistance(0.4f);
+    marks.setLifetime(3.f);
+    Settings::distanceAccumulator_ = 0.f;
+
+    SECTION("Starts empty with a fixed capacity") {
+        REQUIRE(marks.getMarkCount() == 0);
+        REQUIRE(marks.getCapacity() == static_cast<size_t>(Settings::MaxTrackMarks));
+    }
+
+    SECTION("Driving spawns a pair of marks per spawn distance") {
+        drive(marks, 2.0f);
+        REQUIRE(marks.getMarkCount() >= 8);
+        REQUIRE(marks.getMarkCount() % 2 == 0);
+    }
+
+    SECTION("Marks expire after their lifetime") {
+        drive(marks, 2.0f);
+        REQUIRE(marks.getMarkCount() > 0);
+
+        marks.update(5.f, Vector3(-100.f, 0.f, 0.f)); // only the clock matters here
+        marks.update(5.f, Vector3(-100.f, 0.f, 0.f));
+        REQUIRE(marks.getMarkCount() <= 2);
+    }
+
+    SECTION("Only the quads of the latest spawn are uploaded") {
+        drive(marks, 0.45f); // exactly one spawn
+        REQUIRE(marks.getMarkCount() == 2);
+        auto geometry = marks.getGeometry();
+        const auto& positions = geometry->getAttribute<float>("position")->updateRange;
+        REQUIRE(positions.offset == 0);
+        REQUIRE(positions.count == 2 * 4 * 3);
+
+        marks.update(0.01f, Vector3(-1.2f, 0.f, 0.f)); // the next pair, right after the first
+        REQUIRE(marks.getMarkCount() == 4);
+        const auto& spawnTimes = geometry->getAttribute<float>("spawnTime")->updateRange;
+        REQUIRE(spawnTimes.offset == 2 * 4);
+        REQUIRE(spawnTimes.count == 2 * 4);
+    }
+
+    SECTION("Ring buffer overwrites the oldest marks") {
+        marks.setLifetime(1.0e6f);
+        drive(marks, Settings::MaxTrackMarks * 0.4f); // twice the capacity worth of marks
+        REQUIRE(marks.getMarkCount() == marks.getCapacity());
+
+        marks.clear();
+        REQUIRE(marks.getMarkCount() == 0);
+        marks.setLifetime(3.f);
+    }
+}
+
+TEST_CASE("GroundImprintAtlas persistent stamping", "[trackmarks]") {
+    auto ground = Group::create();
+    // 16m x 16m at 4 texels/m with 16 texel tiles -> 4x4 tiles
+    GroundImprintAtlas atlas(*ground, 8.f, 4.f, 16);
+
+    SECTION("Tiles are only allocated where something was stamped") {
+        REQUIRE(atlas.getMaxTileCount() == 16);
+        REQUIRE(atlas.getTileCount() == 0);
+
+        atlas.stamp(Vector3(1.f, 0.f, 1.f), 0.f, 0.5f, 0.5f, 0.5f);
+        REQUIRE(atlas.getTileCount() == 1);
+        REQUIRE(atlas.getDirtyTileCount() == 1);
+        REQUIRE(atlas.intensityAt(1.f, 1.f) > 0.f);
+        REQUIRE(atlas.intensityAt(-5.f, -5.f) == 0.f);
+    }
+
+    SECTION("Flush uploads dirty tiles once") {
+        atlas.stamp(Vector3(0.f, 0.f, 0.f), 0.f, 1.f, 1.f, 0.5f); // straddles four tiles
+        REQUIRE(atlas.getDirtyTileCount() == 4);
+        atlas.flush();
+        REQUIRE(atlas.getDirtyTileCount() == 0);
+        atlas.flush();
+        REQUIRE(atlas.getDirtyTileCount() == 0);
+    }
+
+    SECTION("Repeated passes darken the same spot") {
+        atlas.stamp(Vector3(2.f, 0.f, -2.f), 0.f, 0.5f, 0.5f, 0.3f);
+        const float once = atlas.intensityAt(2.f, -2.f);
+        atlas.stamp(Vector3(2.f, 0.f, -2.f), 0.f, 0.5f, 0.5f, 0.3f);
+        REQUIRE(atlas.intensityAt(2.f, -2.f) > once);
+    }
+
+    SECTION("Memory is bounded by the covered area") {
+        for (int lap = 0; lap < 3; ++lap) {
+            for (float x = -7.5f; x < 8.f; x += 1.f) {
+                for (float z = -7.5f; z < 8.f; z += 1.f) {
+                    atlas.stamp(Vector3(x, 0.f, z), 0.3f, 0.25f, 0.4f, 0.35f);
+                }
+            }
+        }
+        REQUIRE(atlas.getTileCount() == atlas.getMaxTileCount());
+        REQUIRE(atlas.getMemoryBytes() == atlas.getMaxMemoryBytes());
+
+        // Off the edge of the atlas nothing new is allocated
+        atlas.stamp(Vector3(100.f, 0.f, 100.f), 0.f, 1.f, 1.f, 1.f);
+        REQUIRE(atlas.getMemoryBytes() == atlas.getMaxMemoryBytes());
+    }
+}
+
+TEST_CASE("TrackMarkManager persistent ground mode", "[trackmarks]") {
+    Scene scene;
+    auto ground = Group::create();
+    TrackMarkManager marks(scene);
+    marks.setSpawnDistance(0.4f);
+    marks.setLifetime(3.f);
+    Settings::distanceAccumulator_ = 0.f;
+
+    REQUIRE(marks.persistentGround() == nullptr);
+    marks.enablePersistentGround(*ground, 20.f);
+    REQUIRE(marks.persistentGround() != nullptr);
+
+    drive(marks, 3.0f);
+    marks.update(100.f, Vector3(-3.f, 0.f, 0.f)); // decals long gone...
+    REQUIRE(marks.getMarkCount() <= 2);
+    REQUIRE(marks.persistentGround()->getTileCount() > 0); // ...but the ground remembers
+}
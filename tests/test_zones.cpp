@@ -2,7 +2,13 @@
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 #include "DigZone.hpp"
 #include "DumpZone.hpp"
+#include "ZoneManager.hpp"
+#include "CollisionWorld.hpp"
+#include "Settings.hpp"
+#include <algorithm>
+#include <cmath>
 #include <threepp/math/Vector3.hpp>
+#include <threepp/scenes/Scene.hpp>
 
 using namespace threepp;
 
@@ -218,3 +224,124 @@ TEST_CASE("DumpZone: Height tolerance", "[DumpZone]") {
     Vector3 above(1.0f, 3.0f, 0.0f);
     REQUIRE(zone.isInZone(above));
 }
+
+TEST_CASE("DigZone: Excavating moves soil into the bucket", "[DigZone]") {
+    Vector3 position(0.0f, 0.0f, 0.0f);
+    DigZone zone(position, 2.0f, 96);
+    const float full = zone.getVolume();
+    const float topBefore = zone.getHeightfield().heightAt(0.0f, 0.0f);
+    REQUIRE(full == zone.getInitialVolume());
+    
+    // Drag the bucket through the side of the pile
+    const float taken = zone.excavate(Vector3(-1.0f, 1.0f, 0.0f), Vector3(1.0f, 1.0f, 0.0f), 0.5f, 1.0f);
+    REQUIRE(taken > 0.0f);
+    REQUIRE(taken <= 1.0f + 1e-4f);
+    REQUIRE_THAT(full - zone.getVolume(), Catch::Matchers::WithinAbs(taken, 1e-3));
+    
+    // Where the bucket went the pile is lower now
+    REQUIRE(zone.getHeightfield().heightAt(0.0f, 0.0f) < topBefore);
+    
+    zone.reset();
+    REQUIRE_THAT(zone.getVolume(), Catch::Matchers::WithinAbs(full, 1e-3));
+}
+
+TEST_CASE("DumpZone: Dumps heap up at the angle of repose", "[DumpZone]") {
+    Vector3 position(0.0f, 0.0f, 0.0f);
+    DumpZone zone(position, 3.0f);
+    REQUIRE(zone.getVolume() == 0.0f);
+    
+    for (int i = 0; i < 5; ++i) {
+        zone.recordDump(Vector3(0.5f, 2.0f, 0.0f), 1.5f);
+    }
+    REQUIRE_THAT(zone.getVolume(), Catch::Matchers::WithinRel(7.5f, 1e-3f));
+    
+    // No neighbouring samples differ by more than the repose slope allows
+    const Heightfield& field = zone.getHeightfield();
+    const float maxStep = std::tan(Settings::reposeAngle_) * field.getSpacing() * 1.05f + 1e-4f;
+    float steepest = 0.0f;
+    for (int j = 0; j < field.getResolution(); ++j) {
+        for (int i = 1; i < field.getResolution(); ++i) {
+            steepest = std::max(steepest, std::abs(field.sample(i, j) - field.sample(i - 1, j)));
+        }
+    }
+    REQUIRE(steepest <= maxStep);
+    
+    // The heap peaks where the bucket let go, not in the middle of the platform
+    REQUIRE(field.heightAt(0.5f, 0.0f) > field.heightAt(-1.5f, 0.0f));
+    
+    zone.reset();
+    REQUIRE(zone.getVolume() == 0.0f);
+}
+
+TEST_CASE("DumpZone: Drops outside the platform land on its edge", "[DumpZone]") {
+    DumpZone zone(Vector3(10.0f, 0.0f, 0.0f), 2.0f);
+    zone.recordDump(Vector3(20.0f, 1.0f, 0.0f), 0.5f);
+    REQUIRE_THAT(zone.getVolume(), Catch::Matchers::WithinRel(0.5f, 1e-3f));
+    REQUIRE(zone.getHeightfield().heightAt(11.4f, 0.0f) > zone.getHeightfield().heightAt(8.6f, 0.0f));
+}
+
+TEST_CASE("ZoneManager: Finds the zone under the bucket", "[ZoneManager]") {
+    CollisionWorld::clear();
+    Scene scene;
+    ZoneManager zones(scene, 8.0f);
+    
+    // A row of stockpiles and a row of loading points
+    for (int i = 0; i < 20; ++i) {
+        zones.addDigZone(Vector3(i * 10.0f, 0.0f, 0.0f), 2.0f, 32);
+        zones.addDumpZone(Vector3(i * 10.0f, 0.0f, 20.0f), 3.0f);
+    }
+    REQUIRE(zones.getDigZoneCount() == 20);
+    REQUIRE(zones.getDumpZoneCount() == 20);
+    REQUIRE(scene.children.size() == 40);
+    REQUIRE(CollisionWorld::getActiveMeshColliderCount() == 20);
+    
+    REQUIRE(zones.findDigZone(Vector3(70.5f, 0.5f, 0.0f)) == 7);
+    REQUIRE(zones.findDigZone(Vector3(75.0f, 0.5f, 0.0f)) == -1);   // between piles
+    REQUIRE(zones.findDigZone(Vector3(70.0f, 10.0f, 0.0f)) == -1);  // above the pile
+    REQUIRE(zones.findDumpZone(Vector3(131.0f, 1.0f, 21.0f)) == 13);
+    REQUIRE(zones.findDumpZone(Vector3(130.0f, 1.0f, 0.0f)) == -1);
+    REQUIRE(zones.findDigZone(Vector3(-50.0f, 0.5f, -50.0f)) == -1);
+    
+    // Same answer as asking every zone directly
+    for (float x = -5.0f; x < 200.0f; x += 0.7f) {
+        for (float z = -5.0f; z < 25.0f; z += 0.9f) {
+            const Vector3 p(x, 0.5f, z);
+            int expectedDig = -1;
+            int expectedDump = -1;
+            for (int i = 0; i < 20; ++i) {
+                if (expectedDig < 0 && zones.getDigZone(i).isInZone(p)) expectedDig = i;
+                if (expectedDump < 0 && zones.getDumpZone(i).isInZone(p)) expectedDump = i;
+            }
+            REQUIRE(zones.findDigZone(p) == expectedDig);
+            REQUIRE(zones.findDumpZone(p) == expectedDump);
+        }
+    }
+}
+
+TEST_CASE("ZoneManager: Dug out piles disappear and come back on reset", "[ZoneManager]") {
+    CollisionWorld::clear();
+    Scene scene;
+    ZoneManager zones(scene);
+    const auto id = zones.addDigZone(Vector3(0.0f, 0.0f, 0.0f), 1.0f, 32);
+    const auto collider = zones.getCollider(id);
+    REQUIRE(CollisionWorld::isMeshColliderEnabled(collider));
+    
+    // Scrape the whole pile off in one go
+    const float pile = zones.getDigZone(id).getVolume();
+    const float removed = zones.excavate(id, Vector3(-2.0f, -0.5f, 0.0f), Vector3(2.0f, -0.5f, 0.0f), 3.0f, 1000.0f);
+    REQUIRE_THAT(removed, Catch::Matchers::WithinAbs(pile, 1e-3));
+    zones.update();
+    
+    REQUIRE(zones.isDepleted(id));
+    REQUIRE_FALSE(zones.getDigZone(id).getVisual()->visible);
+    REQUIRE_FALSE(CollisionWorld::isMeshColliderEnabled(collider));
+    REQUIRE(zones.findDigZone(Vector3(0.0f, 0.0f, 0.0f)) == -1);
+    REQUIRE(zones.excavate(id, Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 0.0f, 0.0f), 1.0f, 1.0f) == 0.0f);
+    
+    zones.reset();
+    REQUIRE_FALSE(zones.isDepleted(id));
+    REQUIRE(zones.getDigZone(id).getVisual()->visible);
+    REQUIRE(CollisionWorld::isMeshColliderEnabled(collider));
+    REQUIRE(zones.getCollider(id) == collider);
+    CollisionWorld::clear();
+}